@@ -1,4 +1,5 @@
 #include "royarray.h"
+#include "../util/rsort.h"
 
 struct RoyArray_ {
   void   ** data;
@@ -142,6 +143,19 @@ roy_array_clear(RoyArray * array) {
   array->size = 0;
 }
 
+void
+roy_array_sort(RoyArray  * array,
+               RComparer   comparer) {
+  roy_sort(array->data, roy_array_size(array), comparer);
+}
+
+void
+roy_array_parallel_sort(RoyArray      * array,
+                        RoyThreadPool * pool,
+                        RComparer       comparer) {
+  roy_parallel_sort(array->data, roy_array_size(array), comparer, pool);
+}
+
 void
 roy_array_for_each(RoyArray * array,
                    RDoer      doer,
@@ -163,6 +177,18 @@ roy_array_for_which(RoyArray * array,
   }
 }
 
+void
+roy_array_parallel_for_each(RoyArray      * array,
+                            RoyThreadPool * pool,
+                            RDoer           doer,
+                            void          * user_data) {
+  roy_thread_pool_for_each(pool,
+                           array->data,
+                           roy_array_size(array),
+                           doer,
+                           user_data);
+}
+
 /* PRIVATE FUNCTIONS DOWN HERE */
 
 static bool
@@ -2,6 +2,7 @@
 #define ROYARRAY_H
 
 #include "../util/rpre.h"
+#include "../thread/roythreadpool.h"
 
 /// @brief RoyArray: a container that encapsulates fixed size arrays.
 typedef struct RoyArray_ RoyArray;
@@ -141,6 +142,23 @@ bool roy_array_pop_back(RoyArray * array);
  */
 void roy_array_clear(RoyArray * array);
 
+/* OPERATIONS */
+
+/**
+ * @brief Sorts the elements in ascending order.
+ * @param comparer - a function to compare two elements, acting like <=> operator in C++.
+ * @note - This version uses a stable merge sort.
+ */
+void roy_array_sort(RoyArray * array, RComparer comparer);
+
+/**
+ * @brief Sorts the elements in ascending order on 'pool'.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param comparer - a function to compare two elements, may be called from several threads at the same time.
+ * @note - This version uses a stable parallel merge sort, see 'roy_parallel_sort'.
+ */
+void roy_array_parallel_sort(RoyArray * array, RoyThreadPool * pool, RComparer comparer);
+
 /* TRAVERSE */
 
 /**
@@ -158,4 +176,13 @@ void roy_array_for_each(RoyArray * array, RDoer doer, void * user_data);
  */
 void roy_array_for_which(RoyArray * array, RChecker checker, RDoer doer, void * user_data);
 
+/**
+ * @brief Traverses all elements in 'array' concurrently on 'pool', in no particular order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param doer - a function for element traversing, must be safe to call from several threads at the same time.
+ * @param user_data - data to cooperate with 'doer'.
+ * @note - 'array' is split into ranges of indices.
+ */
+void roy_array_parallel_for_each(RoyArray * array, RoyThreadPool * pool, RDoer doer, void * user_data);
+
 #endif // ROYARRAY_H
\ No newline at end of file
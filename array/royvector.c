@@ -1,5 +1,7 @@
 #include "royvector.h"
 #include "royarray.h"
+#include "../util/rparallel.h"
+#include "../util/rstats.h"
 
 struct RoyVector_ {
   void   ** data;
@@ -7,12 +9,16 @@ struct RoyVector_ {
   size_t    capacity;
   size_t    size;
   size_t    capacity_base;
+#ifdef ROY_STATS
+  size_t    reallocs;
+#endif
 };
 
 static bool need_expand(const RoyVector * vector);
 static bool need_shrink(const RoyVector * vector);
 static void expand(RoyVector * vector);
 static void shrink(RoyVector * vector);
+static void reallocate(RoyVector * vector);
 
 RoyVector *
 roy_vector_new(size_t capacity,
@@ -23,6 +29,10 @@ roy_vector_new(size_t capacity,
   ret->capacity      = capacity;
   ret->size          = 0;
   ret->capacity_base = capacity;
+#ifdef ROY_STATS
+  ret->reallocs      = 0;
+#endif
+  R_STATS_ADD(R_STATS_VECTOR_ALLOCATIONS, 1);
   return ret;
 }
 
@@ -59,6 +69,27 @@ roy_vector_empty(const RoyVector * vector) {
   return roy_array_empty((RoyArray *)vector);
 }
 
+void
+roy_vector_reserve(RoyVector * vector,
+                   size_t      capacity) {
+  if (capacity > roy_vector_capacity(vector)) {
+    vector->capacity = capacity;
+    reallocate(vector);
+  }
+}
+
+void
+roy_vector_stats(const RoyVector * vector,
+                 RoyVectorStats  * stats) {
+  stats->size     = roy_vector_size(vector);
+  stats->capacity = roy_vector_capacity(vector);
+#ifdef ROY_STATS
+  stats->reallocs = vector->reallocs;
+#else
+  stats->reallocs = 0;
+#endif
+}
+
 bool
 roy_vector_insert(RoyVector * restrict vector,
                   size_t               position,
@@ -82,6 +113,18 @@ roy_vector_push_back(RoyVector * restrict vector,
   return roy_array_push_back((RoyArray *)vector, data);
 }
 
+size_t
+roy_vector_append(RoyVector    * vector,
+                  void * const * data,
+                  size_t         count) {
+  if (count > 0) {
+    roy_vector_reserve(vector, roy_vector_size(vector) + count);
+    memcpy(vector->data + roy_vector_size(vector), data, count * R_PTR_SIZE);
+    vector->size += count;
+  }
+  return count;
+}
+
 bool
 roy_vector_erase(RoyVector * vector,
                  size_t      position) {
@@ -116,8 +159,146 @@ roy_vector_clear(RoyVector * vector) {
   roy_vector_for_each(vector, vector->deleter, NULL);
   vector->capacity = vector->capacity_base;
   vector->size = 0;
-  vector->data =
-    (void **)realloc(vector->data, roy_vector_capacity(vector) * R_PTR_SIZE);
+  reallocate(vector);
+}
+
+void
+roy_vector_sort(RoyVector * vector,
+                RComparer   comparer) {
+  roy_array_sort((RoyArray *)vector, comparer);
+}
+
+void
+roy_vector_parallel_sort(RoyVector     * vector,
+                         RoyThreadPool * pool,
+                         RComparer       comparer) {
+  roy_array_parallel_sort((RoyArray *)vector, pool, comparer);
+}
+
+void
+roy_vector_reduce(const RoyVector * vector,
+                  void            * accumulator,
+                  RReducer          reducer) {
+  roy_reduce(vector->data,
+             roy_vector_size(vector),
+             roy_visit_array,
+             accumulator,
+             reducer);
+}
+
+void
+roy_vector_parallel_reduce(const RoyVector * vector,
+                           RoyThreadPool   * pool,
+                           void            * accumulator,
+                           size_t            accumulator_size,
+                           RReducer          reducer,
+                           RMerger           merger) {
+  roy_parallel_reduce(vector->data,
+                      roy_vector_size(vector),
+                      roy_visit_array,
+                      pool,
+                      accumulator,
+                      accumulator_size,
+                      reducer,
+                      merger);
+}
+
+size_t
+roy_vector_count_if(const RoyVector * vector,
+                    RChecker          checker) {
+  return roy_count_if(vector->data,
+                      roy_vector_size(vector),
+                      roy_visit_array,
+                      checker);
+}
+
+size_t
+roy_vector_parallel_count_if(const RoyVector * vector,
+                             RoyThreadPool   * pool,
+                             RChecker          checker) {
+  return roy_parallel_count_if(vector->data,
+                               roy_vector_size(vector),
+                               roy_visit_array,
+                               pool,
+                               checker);
+}
+
+size_t
+roy_vector_filter_into(const RoyVector * vector,
+                       RoyVector       * dest,
+                       RChecker          checker,
+                       RMapper           copier,
+                       void            * user_data) {
+  size_t count;
+  void ** data = roy_collect(vector->data,
+                             roy_vector_size(vector),
+                             roy_visit_array,
+                             checker,
+                             copier,
+                             user_data,
+                             &count);
+  roy_vector_append(dest, data, count);
+  free(data);
+  return count;
+}
+
+size_t
+roy_vector_parallel_filter_into(const RoyVector * vector,
+                                RoyThreadPool   * pool,
+                                RoyVector       * dest,
+                                RChecker          checker,
+                                RMapper           copier,
+                                void            * user_data) {
+  size_t count;
+  void ** data = roy_parallel_collect(vector->data,
+                                      roy_vector_size(vector),
+                                      roy_visit_array,
+                                      pool,
+                                      checker,
+                                      copier,
+                                      user_data,
+                                      &count);
+  roy_vector_append(dest, data, count);
+  free(data);
+  return count;
+}
+
+size_t
+roy_vector_transform_into(const RoyVector * vector,
+                          RoyVector       * dest,
+                          RMapper           mapper,
+                          void            * user_data) {
+  size_t count;
+  void ** data = roy_collect(vector->data,
+                             roy_vector_size(vector),
+                             roy_visit_array,
+                             NULL,
+                             mapper,
+                             user_data,
+                             &count);
+  roy_vector_append(dest, data, count);
+  free(data);
+  return count;
+}
+
+size_t
+roy_vector_parallel_transform_into(const RoyVector * vector,
+                                   RoyThreadPool   * pool,
+                                   RoyVector       * dest,
+                                   RMapper           mapper,
+                                   void            * user_data) {
+  size_t count;
+  void ** data = roy_parallel_collect(vector->data,
+                                      roy_vector_size(vector),
+                                      roy_visit_array,
+                                      pool,
+                                      NULL,
+                                      mapper,
+                                      user_data,
+                                      &count);
+  roy_vector_append(dest, data, count);
+  free(data);
+  return count;
 }
 
 void
@@ -135,6 +316,14 @@ roy_vector_for_which(RoyVector * vector,
   roy_array_for_which((RoyArray *) vector, checker, doer, user_data);
 }
 
+void
+roy_vector_parallel_for_each(RoyVector     * vector,
+                             RoyThreadPool * pool,
+                             RDoer           doer,
+                             void          * user_data) {
+  roy_array_parallel_for_each((RoyArray *)vector, pool, doer, user_data);
+}
+
 /* PRIVATE FUNCTIONS BELOW */
 
 static bool
@@ -152,8 +341,7 @@ static void
 expand(RoyVector * vector) {
   if (need_expand(vector)) {
     vector->capacity += vector->capacity_base;
-    vector->data =
-      (void **)realloc(vector->data, roy_vector_capacity(vector) * R_PTR_SIZE);
+    reallocate(vector);
   }
 }
 
@@ -161,7 +349,17 @@ static void
 shrink(RoyVector * vector) {
   if (need_shrink(vector)) {
     vector->capacity -= vector->capacity_base;
-    vector->data =
-      (void **)realloc(vector->data, roy_vector_capacity(vector) * R_PTR_SIZE);
+    reallocate(vector);
   }
 }
+
+// Resizes the storage of 'vector' to its current capacity.
+static void
+reallocate(RoyVector * vector) {
+  vector->data =
+    (void **)realloc(vector->data, roy_vector_capacity(vector) * R_PTR_SIZE);
+#ifdef ROY_STATS
+  vector->reallocs++;
+#endif
+  R_STATS_ADD(R_STATS_VECTOR_REALLOCS, 1);
+}
\ No newline at end of file
@@ -2,10 +2,17 @@
 #define ROYVECTOR_H
 
 #include "../util/rpre.h"
+#include "../thread/roythreadpool.h"
 
 /// @brief RoyVector: a container that encapsulates scalable size vectors.
 typedef struct RoyVector_ RoyVector;
 
+typedef struct RoyVectorStats_ {
+  size_t size;
+  size_t capacity;
+  size_t reallocs; // times the storage has been resized, always 0 without ROY_STATS.
+} RoyVectorStats;
+
 /* CONSTRUCTION AND DESTRUCTION */
 
 /**
@@ -80,6 +87,18 @@ size_t roy_vector_capacity(const RoyVector * vector);
  */
 bool roy_vector_empty(const RoyVector * vector);
 
+/**
+ * @brief Expands the storage of 'vector' so that it can store at least 'capacity' elements without reallocating.
+ * @note - Nothing happens if 'capacity' is not greater than the current capacity.
+ */
+void roy_vector_reserve(RoyVector * vector, size_t capacity);
+
+/**
+ * @brief Reports the size, the capacity and the reallocations of 'vector' into 'stats'.
+ * @note - Reallocations are counted only when roylib is built with ROY_STATS, see "util/rstats.h".
+ */
+void roy_vector_stats(const RoyVector * vector, RoyVectorStats * stats);
+
 /* MODIFIERS */
 
 /**
@@ -115,6 +134,13 @@ bool roy_vector_insert_fast(RoyVector * restrict vector, size_t position, void *
  */
 bool roy_vector_push_back(RoyVector * restrict vector, void * restrict data);
 
+/**
+ * @brief Adds 'count' elements of the pointer array 'data' to the back of 'vector', in order.
+ * @return the number of elements added, i.e. 'count'.
+ * @note - The storage is expanded once for all of them, 'data' itself is left to the caller.
+ */
+size_t roy_vector_append(RoyVector * vector, void * const * data, size_t count);
+
 /**
  * @brief Removes an element from 'vector'.
  * @param position - where the element should be removed.
@@ -154,6 +180,84 @@ bool roy_vector_pop_back(RoyVector * vector);
  */
 void roy_vector_clear(RoyVector * vector);
 
+/* OPERATIONS */
+
+/**
+ * @brief Sorts the elements in ascending order.
+ * @param comparer - a function to compare two elements, acting like <=> operator in C++.
+ * @note - This version uses a stable merge sort.
+ */
+void roy_vector_sort(RoyVector * vector, RComparer comparer);
+
+/**
+ * @brief Sorts the elements in ascending order on 'pool'.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param comparer - a function to compare two elements, may be called from several threads at the same time.
+ * @note - This version uses a stable parallel merge sort, see 'roy_parallel_sort'.
+ */
+void roy_vector_parallel_sort(RoyVector * vector, RoyThreadPool * pool, RComparer comparer);
+
+/**
+ * @brief Folds all elements into 'accumulator' sequentially.
+ * @param reducer - a function to fold an element into 'accumulator'.
+ */
+void roy_vector_reduce(const RoyVector * vector, void * accumulator, RReducer reducer);
+
+/**
+ * @brief Folds all elements into 'accumulator' on 'pool'.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param accumulator - holds the identity of 'merger' on entry, and the result on return.
+ * @param accumulator_size - the size of 'accumulator' in bytes.
+ * @param reducer - a function to fold an element into a partial accumulator, may be called from several threads at the same time.
+ * @param merger - a function to fold a partial accumulator into 'accumulator'.
+ * @note - Partial accumulators are bytewise copies of 'accumulator', see 'roy_parallel_reduce'.
+ */
+void roy_vector_parallel_reduce(const RoyVector * vector, RoyThreadPool * pool, void * accumulator, size_t accumulator_size, RReducer reducer, RMerger merger);
+
+/// @brief Returns the number of elements which meet 'checker'.
+size_t roy_vector_count_if(const RoyVector * vector, RChecker checker);
+
+/**
+ * @brief Returns the number of elements which meet 'checker', counted on 'pool'.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param checker - may be called from several threads at the same time.
+ */
+size_t roy_vector_parallel_count_if(const RoyVector * vector, RoyThreadPool * pool, RChecker checker);
+
+/**
+ * @brief Appends the elements which meet 'checker' to the back of 'dest', keeping their order.
+ * @param copier - a function to copy an element for 'dest', NULL to share the element itself.
+ * @param user_data - data to cooperate with 'copier'.
+ * @return The number of appended elements.
+ * @note - Shared elements are owned by both vectors, make sure only one of the deleters releases them.
+ */
+size_t roy_vector_filter_into(const RoyVector * vector, RoyVector * dest, RChecker checker, RMapper copier, void * user_data);
+
+/**
+ * @brief Appends the elements which meet 'checker' to the back of 'dest' on 'pool', keeping their order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param checker - may be called from several threads at the same time.
+ * @param copier - may be called from several threads at the same time, NULL to share the element itself.
+ * @return The number of appended elements.
+ */
+size_t roy_vector_parallel_filter_into(const RoyVector * vector, RoyThreadPool * pool, RoyVector * dest, RChecker checker, RMapper copier, void * user_data);
+
+/**
+ * @brief Appends what 'mapper' makes of every element to the back of 'dest', keeping their order.
+ * @param mapper - a function to make a new element for 'dest' out of an element.
+ * @param user_data - data to cooperate with 'mapper'.
+ * @return The number of appended elements.
+ */
+size_t roy_vector_transform_into(const RoyVector * vector, RoyVector * dest, RMapper mapper, void * user_data);
+
+/**
+ * @brief Appends what 'mapper' makes of every element to the back of 'dest' on 'pool', keeping their order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param mapper - may be called from several threads at the same time.
+ * @return The number of appended elements.
+ */
+size_t roy_vector_parallel_transform_into(const RoyVector * vector, RoyThreadPool * pool, RoyVector * dest, RMapper mapper, void * user_data);
+
 /* TRAVERSE */
 
 /**
@@ -171,4 +275,13 @@ void roy_vector_for_each(RoyVector * vector, RDoer doer, void * user_data);
  */
 void roy_vector_for_which(RoyVector * vector, RChecker checker, RDoer doer, void * user_data);
 
+/**
+ * @brief Traverses all elements in 'vector' concurrently on 'pool', in no particular order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param doer - a function for element traversing, must be safe to call from several threads at the same time.
+ * @param user_data - data to cooperate with 'doer'.
+ * @note - 'vector' is split into ranges of indices.
+ */
+void roy_vector_parallel_for_each(RoyVector * vector, RoyThreadPool * pool, RDoer doer, void * user_data);
+
 #endif // ROYVECTOR_H
\ No newline at end of file
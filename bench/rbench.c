@@ -0,0 +1,223 @@
+#include "rbench.h"
+#include <math.h>
+#include <time.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const char * DISTRIBUTION_NAMES[] = { "sequential", "random", "zipfian" };
+
+// -1 while closed, the descriptors of the counters in one group led by RBENCH_CYCLES.
+static int  counter_fds[RBENCH_COUNTER_COUNT] = { -1, -1, -1, -1 };
+static bool counters_tried = false;
+
+static double now(void);
+static int compare_double(const void * lhs, const void * rhs);
+static bool counters_open(void);
+static void counters_start(void);
+static bool counters_stop(uint64_t * values);
+
+bool
+rbench_run(const RBenchConfig * config,
+           const char         * name,
+           size_t               operations,
+           RBenchRoutine        setup,
+           RBenchRoutine        body,
+           RBenchRoutine        teardown,
+           void               * context,
+           RBenchResult       * result) {
+  if (config->filter && !strstr(name, config->filter)) {
+    return false;
+  }
+  size_t repetitions = config->repetitions != 0 ? config->repetitions : 1;
+  double * times = malloc(repetitions * sizeof(double));
+  uint64_t totals[RBENCH_COUNTER_COUNT] = { 0 };
+  bool counted = config->counters && counters_open();
+  for (size_t i = 0; i != config->warmup + repetitions; i++) {
+    if (setup) {
+      setup(context);
+    }
+    if (counted) {
+      counters_start();
+    }
+    double begin = now();
+    body(context);
+    double elapsed = now() - begin;
+    uint64_t values[RBENCH_COUNTER_COUNT];
+    if (counted && !counters_stop(values)) {
+      counted = false;
+    }
+    if (teardown) {
+      teardown(context);
+    }
+    if (i >= config->warmup) {
+      times[i - config->warmup] = elapsed;
+      for (size_t j = 0; counted && j != RBENCH_COUNTER_COUNT; j++) {
+        totals[j] += values[j];
+      }
+    }
+  }
+  qsort(times, repetitions, sizeof(double), compare_double);
+  RBenchResult ret = { 0 };
+  ret.median         = repetitions % 2 ? times[repetitions / 2] :
+                                         (times[repetitions / 2 - 1] + times[repetitions / 2]) / 2;
+  ret.p99            = times[(size_t)ceil(repetitions * 0.99) - 1];
+  ret.ops_per_second = ret.median > 0 ? operations / ret.median : 0;
+  ret.counted        = counted;
+  for (size_t j = 0; counted && j != RBENCH_COUNTER_COUNT; j++) {
+    ret.counters[j] = (double)totals[j] / repetitions / (operations != 0 ? operations : 1);
+  }
+  free(times);
+
+  printf("%-32s %10zu %12.3f %12.3f %14.0f", name, operations, ret.median * 1e3, ret.p99 * 1e3, ret.ops_per_second);
+  if (ret.counted) {
+    printf(" %10.1f %10.1f %10.3f %10.3f", ret.counters[RBENCH_CYCLES], ret.counters[RBENCH_INSTRUCTIONS],
+           ret.counters[RBENCH_CACHE_MISSES], ret.counters[RBENCH_BRANCH_MISSES]);
+  } else if (config->counters) {
+    printf(" %10s", "n/a");
+  }
+  printf("\n");
+  fflush(stdout);
+  if (result) {
+    *result = ret;
+  }
+  return true;
+}
+
+void
+rbench_print_header(const RBenchConfig * config) {
+  printf("%-32s %10s %12s %12s %14s", "benchmark", "ops", "median ms", "p99 ms", "ops/s");
+  if (config->counters) {
+    printf(" %10s %10s %10s %10s", "cycles/op", "instr/op", "misses/op", "branch/op");
+  }
+  printf("\n");
+}
+
+void
+rbench_keys(uint64_t           * dest,
+            size_t               count,
+            size_t               universe,
+            RBenchDistribution   distribution,
+            RoyRng             * rng) {
+  universe = universe != 0 ? universe : 1;
+  if (distribution == RBENCH_SEQUENTIAL) {
+    for (size_t i = 0; i != count; i++) {
+      dest[i] = i % universe;
+    }
+  } else if (distribution == RBENCH_RANDOM) {
+    roy_rng_fill_bounded(rng, dest, count, universe);
+  } else {
+    // The generator of Gray et al., "Quickly Generating Billion-Record Synthetic Databases", as used by YCSB.
+    const double theta = 0.99;
+    double zeta_n = 0;
+    for (size_t i = 1; i <= universe; i++) {
+      zeta_n += pow((double)i, -theta);
+    }
+    double zeta_2 = 1 + pow(2, -theta);
+    double alpha  = 1 / (1 - theta);
+    double eta    = (1 - pow(2.0 / universe, 1 - theta)) / (1 - zeta_2 / zeta_n);
+    for (size_t i = 0; i != count; i++) {
+      double u  = roy_rng_double(rng);
+      double uz = u * zeta_n;
+      uint64_t key = uz < 1 ? 0 : uz < zeta_2 ? 1 : (uint64_t)(universe * pow(eta * u - eta + 1, alpha));
+      dest[i] = key < universe ? key : universe - 1;
+    }
+  }
+}
+
+const char *
+rbench_distribution_name(RBenchDistribution distribution) {
+  return DISTRIBUTION_NAMES[distribution];
+}
+
+bool
+rbench_parse_distribution(const char         * name,
+                          RBenchDistribution * distribution) {
+  for (size_t i = 0; i != sizeof(DISTRIBUTION_NAMES) / sizeof(DISTRIBUTION_NAMES[0]); i++) {
+    if (strcmp(name, DISTRIBUTION_NAMES[i]) == 0) {
+      *distribution = (RBenchDistribution)i;
+      return true;
+    }
+  }
+  return false;
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+static double
+now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int
+compare_double(const void * lhs,
+               const void * rhs) {
+  double l = *(const double *)lhs, r = *(const double *)rhs;
+  return l < r ? -1 : l > r;
+}
+
+// Opens the counters once per process, they are unavailable without Linux or with a strict 'perf_event_paranoid'.
+static bool
+counters_open(void) {
+#ifdef __linux__
+  if (!counters_tried) {
+    static const uint64_t CONFIGS[RBENCH_COUNTER_COUNT] = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+    counters_tried = true;
+    for (size_t i = 0; i != RBENCH_COUNTER_COUNT; i++) {
+      struct perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size           = sizeof(attr);
+      attr.type           = PERF_TYPE_HARDWARE;
+      attr.config         = CONFIGS[i];
+      attr.disabled       = i == 0;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv     = 1;
+      attr.read_format    = PERF_FORMAT_GROUP;
+      counter_fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : counter_fds[0], 0);
+      if (counter_fds[i] < 0) {
+        for (size_t j = 0; j != i; j++) {
+          close(counter_fds[j]);
+          counter_fds[j] = -1;
+        }
+        fprintf(stderr, "roybench: hardware counters are unavailable, see /proc/sys/kernel/perf_event_paranoid\n");
+        return false;
+      }
+    }
+  }
+  return counter_fds[0] >= 0;
+#else
+  counters_tried = true;
+  return false;
+#endif
+}
+
+static void
+counters_start(void) {
+#ifdef __linux__
+  ioctl(counter_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(counter_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+// Reads all counters of the group at once, 'values' is unused without Linux.
+static bool
+counters_stop(__attribute__((unused)) uint64_t * values) {
+#ifdef __linux__
+  ioctl(counter_fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  uint64_t buffer[1 + RBENCH_COUNTER_COUNT];
+  if (read(counter_fds[0], buffer, sizeof(buffer)) != (ssize_t)sizeof(buffer) || buffer[0] != RBENCH_COUNTER_COUNT) {
+    return false;
+  }
+  memcpy(values, buffer + 1, sizeof(uint64_t) * RBENCH_COUNTER_COUNT);
+  return true;
+#else
+  return false;
+#endif
+}
@@ -0,0 +1,70 @@
+#ifndef RBENCH_H
+#define RBENCH_H
+
+#include "../util/rpre.h"
+#include "../math/royrng.h"
+
+typedef enum RBenchDistribution_ {
+  RBENCH_SEQUENTIAL, // 0, 1, 2, ... in order.
+  RBENCH_RANDOM,     // uniform over the universe.
+  RBENCH_ZIPFIAN     // a few hot keys, most of them rarely, as in YCSB (theta = 0.99).
+} RBenchDistribution;
+
+typedef enum RBenchCounter_ {
+  RBENCH_CYCLES,
+  RBENCH_INSTRUCTIONS,
+  RBENCH_CACHE_MISSES,
+  RBENCH_BRANCH_MISSES,
+  RBENCH_COUNTER_COUNT
+} RBenchCounter;
+
+typedef struct RBenchConfig_ {
+  size_t       warmup;      // the number of runs before measuring.
+  size_t       repetitions; // the number of runs measured.
+  bool         counters;    // whether to read hardware counters by 'perf_event_open'.
+  const char * filter;      // runs only the benchmarks whose names contain it, NULL to run all.
+} RBenchConfig;
+
+typedef struct RBenchResult_ {
+  double median;                          // seconds per run.
+  double p99;                             // seconds per run, the slowest run unless there are 100 or more.
+  double ops_per_second;                  // operations per run divided by 'median'.
+  double counters[RBENCH_COUNTER_COUNT];  // events per operation, averaged over the measured runs.
+  bool   counted;                         // whether 'counters' are available.
+} RBenchResult;
+
+/// @brief A step of a benchmark, receiving the context passed to 'rbench_run'.
+typedef void (* RBenchRoutine) (void * context);
+
+/**
+ * @brief Times 'body' on 'context', and prints a line of results.
+ * @param operations - the number of operations 'body' performs per run, for the throughput.
+ * @param setup - prepares 'context' before every run, untimed, NULL to skip.
+ * @param teardown - cleans 'context' up after every run, untimed, NULL to skip.
+ * @param result - where to store the results, NULL to print them only.
+ * @retval true - the benchmark has run.
+ * @retval false - 'name' does not match the filter of 'config'.
+ */
+bool rbench_run(const RBenchConfig * config, const char * name, size_t operations,
+                RBenchRoutine setup, RBenchRoutine body, RBenchRoutine teardown, void * context, RBenchResult * result);
+
+/// @brief Prints the column headers for the lines of 'rbench_run'.
+void rbench_print_header(const RBenchConfig * config);
+
+/**
+ * @brief Fills 'dest' with 'count' keys in [0, universe) drawn from 'distribution'.
+ * @note - Zipfian keys take O('universe') time to prepare, once per call.
+ */
+void rbench_keys(uint64_t * dest, size_t count, size_t universe, RBenchDistribution distribution, RoyRng * rng);
+
+/// @brief Returns the name of 'distribution', as accepted by 'rbench_parse_distribution'.
+const char * rbench_distribution_name(RBenchDistribution distribution);
+
+/**
+ * @brief Reads a distribution from its name.
+ * @retval true - 'name' is "sequential", "random" or "zipfian".
+ * @retval false - otherwise, 'distribution' is left unchanged.
+ */
+bool rbench_parse_distribution(const char * name, RBenchDistribution * distribution);
+
+#endif // RBENCH_H
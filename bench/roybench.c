@@ -0,0 +1,572 @@
+#include "../roy.h"
+#include "rbench.h"
+#include <getopt.h>
+
+enum {
+  DEFAULT_COUNT       = 1 << 20,
+  DEFAULT_WARMUP      = 1,
+  DEFAULT_REPETITIONS = 7,
+  DEFAULT_SEED        = 0x2545F491,
+  WORD_LENGTH_MAX     = 0x10
+};
+
+// Shared by all the benchmarks: the containers hold pointers into 'universe', and are searched for 'keys'.
+typedef struct Context_ {
+  size_t          count;
+  uint64_t      * universe;   // 0, 1, ... 'count' - 1.
+  uint64_t      * keys;       // 'count' keys in [0, 'count') of the chosen distribution.
+  uint64_t      * shuffled;   // 'count' random 64-bit keys, for sorting.
+  uint64_t      * order;      // a random permutation of 'universe', to build the trees in.
+  RoyThreadPool * pool;
+  RoyVector     * vector;
+  RoyDeque      * deque;
+  RoySet        * set;
+  RoyMap        * map;
+  RoyUSet       * uset;
+  RoyUMap       * umap;
+  RoyString     * text;       // 'count' comma separated words.
+  RoyDeque      * words;
+  uint64_t        sink;       // results are folded in here so that no work is optimized out.
+} Context;
+
+typedef struct Benchmark_ {
+  const char    * name;
+  RBenchRoutine   setup;
+  RBenchRoutine   body;
+  RBenchRoutine   teardown;
+  bool            degenerate; // whether sequential keys make it quadratic, RoySet is not balanced.
+} Benchmark;
+
+static void keep(void * data, void * user_data);
+static void fold(void * data, void * user_data);
+static void tally(void * data, void * user_data);
+static int  compare_uint(const uint64_t * lhs, const uint64_t * rhs);
+static int  compare_pair(const RoyPair * lhs, const RoyPair * rhs);
+static void delete_pair(RoyPair * pair, void * user_data);
+static void vector_build(Context * context);
+static void vector_destroy(Context * context);
+static void vector_push_back(Context * context);
+static void vector_at(Context * context);
+static void vector_erase_fast(Context * context);
+static void vector_for_each(Context * context);
+static void vector_build_shuffled(Context * context);
+static void vector_sort(Context * context);
+static void vector_parallel_sort(Context * context);
+static void deque_build(Context * context);
+static void deque_destroy(Context * context);
+static void deque_push_back(Context * context);
+static void deque_at(Context * context);
+static void deque_pop_front(Context * context);
+static void deque_for_each(Context * context);
+static void set_build(Context * context);
+static void set_destroy(Context * context);
+static void set_insert(Context * context);
+static void set_find(Context * context);
+static void set_remove(Context * context);
+static void set_for_each(Context * context);
+static void map_build(Context * context);
+static void map_destroy(Context * context);
+static void map_insert(Context * context);
+static void map_find(Context * context);
+static void map_remove(Context * context);
+static void map_for_each(Context * context);
+static void uset_build(Context * context);
+static void uset_destroy(Context * context);
+static void uset_insert(Context * context);
+static void uset_find(Context * context);
+static void uset_remove(Context * context);
+static void uset_for_each(Context * context);
+static void umap_build(Context * context);
+static void umap_destroy(Context * context);
+static void umap_insert(Context * context);
+static void umap_find(Context * context);
+static void umap_remove(Context * context);
+static void umap_for_each(Context * context);
+static void words_destroy(Context * context);
+static void string_split(Context * context);
+static void string_split_char(Context * context);
+static void string_find_literal(Context * context);
+static void string_find_regex(Context * context);
+static RoyString * make_text(size_t count);
+static void usage(const char * program);
+
+// Setups build the container to work on from 'universe', bodies are timed, teardowns destroy the container.
+static const Benchmark BENCHMARKS[] = {
+  { "vector/push_back",     NULL,                                 (RBenchRoutine)vector_push_back,     (RBenchRoutine)vector_destroy, false },
+  { "vector/at",            (RBenchRoutine)vector_build,          (RBenchRoutine)vector_at,            (RBenchRoutine)vector_destroy, false },
+  { "vector/erase_fast",    (RBenchRoutine)vector_build,          (RBenchRoutine)vector_erase_fast,    (RBenchRoutine)vector_destroy, false },
+  { "vector/for_each",      (RBenchRoutine)vector_build,          (RBenchRoutine)vector_for_each,      (RBenchRoutine)vector_destroy, false },
+  { "vector/sort",          (RBenchRoutine)vector_build_shuffled, (RBenchRoutine)vector_sort,          (RBenchRoutine)vector_destroy, false },
+  { "vector/parallel_sort", (RBenchRoutine)vector_build_shuffled, (RBenchRoutine)vector_parallel_sort, (RBenchRoutine)vector_destroy, false },
+  { "deque/push_back",      NULL,                                 (RBenchRoutine)deque_push_back,      (RBenchRoutine)deque_destroy,  false },
+  { "deque/at",             (RBenchRoutine)deque_build,           (RBenchRoutine)deque_at,             (RBenchRoutine)deque_destroy,  false },
+  { "deque/pop_front",      (RBenchRoutine)deque_build,           (RBenchRoutine)deque_pop_front,      (RBenchRoutine)deque_destroy,  false },
+  { "deque/for_each",       (RBenchRoutine)deque_build,           (RBenchRoutine)deque_for_each,       (RBenchRoutine)deque_destroy,  false },
+  { "set/insert",           NULL,                                 (RBenchRoutine)set_insert,           (RBenchRoutine)set_destroy,    true  },
+  { "set/find",             (RBenchRoutine)set_build,             (RBenchRoutine)set_find,             (RBenchRoutine)set_destroy,    false },
+  { "set/remove",           (RBenchRoutine)set_build,             (RBenchRoutine)set_remove,           (RBenchRoutine)set_destroy,    false },
+  { "set/for_each",         (RBenchRoutine)set_build,             (RBenchRoutine)set_for_each,         (RBenchRoutine)set_destroy,    false },
+  { "map/insert",           NULL,                                 (RBenchRoutine)map_insert,           (RBenchRoutine)map_destroy,    true  },
+  { "map/find",             (RBenchRoutine)map_build,             (RBenchRoutine)map_find,             (RBenchRoutine)map_destroy,    false },
+  { "map/remove",           (RBenchRoutine)map_build,             (RBenchRoutine)map_remove,           (RBenchRoutine)map_destroy,    false },
+  { "map/for_each",         (RBenchRoutine)map_build,             (RBenchRoutine)map_for_each,         (RBenchRoutine)map_destroy,    false },
+  { "uset/insert",          NULL,                                 (RBenchRoutine)uset_insert,          (RBenchRoutine)uset_destroy,   false },
+  { "uset/find",            (RBenchRoutine)uset_build,            (RBenchRoutine)uset_find,            (RBenchRoutine)uset_destroy,   false },
+  { "uset/remove",          (RBenchRoutine)uset_build,            (RBenchRoutine)uset_remove,          (RBenchRoutine)uset_destroy,   false },
+  { "uset/for_each",        (RBenchRoutine)uset_build,            (RBenchRoutine)uset_for_each,        (RBenchRoutine)uset_destroy,   false },
+  { "umap/insert",          NULL,                                 (RBenchRoutine)umap_insert,          (RBenchRoutine)umap_destroy,   false },
+  { "umap/find",            (RBenchRoutine)umap_build,            (RBenchRoutine)umap_find,            (RBenchRoutine)umap_destroy,   false },
+  { "umap/remove",          (RBenchRoutine)umap_build,            (RBenchRoutine)umap_remove,          (RBenchRoutine)umap_destroy,   false },
+  { "umap/for_each",        (RBenchRoutine)umap_build,            (RBenchRoutine)umap_for_each,        (RBenchRoutine)umap_destroy,   false },
+  { "string/split",         NULL,                                 (RBenchRoutine)string_split,         (RBenchRoutine)words_destroy,  false },
+  { "string/split_char",    NULL,                                 (RBenchRoutine)string_split_char,    (RBenchRoutine)words_destroy,  false },
+  { "string/find_literal",  NULL,                                 (RBenchRoutine)string_find_literal,  NULL,                          false },
+  { "string/find_regex",    NULL,                                 (RBenchRoutine)string_find_regex,    NULL,                          false }
+};
+
+int
+main(int argc, char ** argv) {
+  static const struct option OPTIONS[] = {
+    { "count",        required_argument, NULL, 'n' },
+    { "warmup",       required_argument, NULL, 'w' },
+    { "repetitions",  required_argument, NULL, 'r' },
+    { "distribution", required_argument, NULL, 'd' },
+    { "seed",         required_argument, NULL, 's' },
+    { "filter",       required_argument, NULL, 'f' },
+    { "counters",     no_argument,       NULL, 'c' },
+    { "help",         no_argument,       NULL, 'h' },
+    { NULL,           0,                 NULL, 0   }
+  };
+  RBenchConfig config = { DEFAULT_WARMUP, DEFAULT_REPETITIONS, false, NULL };
+  RBenchDistribution distribution = RBENCH_RANDOM;
+  size_t count = DEFAULT_COUNT;
+  uint64_t seed = DEFAULT_SEED;
+  for (int option; (option = getopt_long(argc, argv, "n:w:r:d:s:f:ch", OPTIONS, NULL)) != -1; ) {
+    switch (option) {
+      case 'n': count              = strtoull(optarg, NULL, 0); break;
+      case 'w': config.warmup      = strtoull(optarg, NULL, 0); break;
+      case 'r': config.repetitions = strtoull(optarg, NULL, 0); break;
+      case 's': seed               = strtoull(optarg, NULL, 0); break;
+      case 'f': config.filter      = optarg;                    break;
+      case 'c': config.counters    = true;                      break;
+      case 'd':
+        if (rbench_parse_distribution(optarg, &distribution)) {
+          break;
+        }
+        fprintf(stderr, "%s: unknown distribution '%s'\n", argv[0], optarg);
+        // fall through
+      default:
+        usage(argv[0]);
+        return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  count = count != 0 ? count : 1;
+
+  Context context;
+  memset(&context, 0, sizeof(context));
+  context.count    = count;
+  context.universe = malloc(count * sizeof(uint64_t));
+  context.keys     = malloc(count * sizeof(uint64_t));
+  context.shuffled = malloc(count * sizeof(uint64_t));
+  context.order    = malloc(count * sizeof(uint64_t));
+  context.pool     = roy_thread_pool_default();
+  context.text     = make_text(count);
+  RoyRng * rng = roy_rng_new(ROY_RNG_XOSHIRO, seed);
+  for (size_t i = 0; i != count; i++) {
+    context.universe[i] = context.order[i] = i;
+  }
+  for (size_t i = count - 1; i != 0; i--) {
+    size_t j = roy_rng_bounded(rng, i + 1);
+    uint64_t order = context.order[i];
+    context.order[i] = context.order[j];
+    context.order[j] = order;
+  }
+  rbench_keys(context.keys, count, count, distribution, rng);
+  roy_rng_fill(rng, context.shuffled, count);
+  roy_rng_delete(rng, NULL);
+
+  printf("%zu elements, %s keys, %zu warmup and %zu measured runs, %zu threads\n", count,
+         rbench_distribution_name(distribution), config.warmup, config.repetitions, roy_thread_pool_size(context.pool));
+  rbench_print_header(&config);
+  for (size_t i = 0; i != sizeof(BENCHMARKS) / sizeof(BENCHMARKS[0]); i++) {
+    const Benchmark * benchmark = &BENCHMARKS[i];
+    if (benchmark->degenerate && distribution == RBENCH_SEQUENTIAL &&
+        (!config.filter || strstr(benchmark->name, config.filter))) {
+      printf("%-32s skipped for sequential keys\n", benchmark->name);
+      continue;
+    }
+    size_t operations = strncmp(benchmark->name, "string/", 7) == 0 ? roy_string_length(context.text) : count;
+    rbench_run(&config, benchmark->name, operations, benchmark->setup, benchmark->body, benchmark->teardown, &context, NULL);
+  }
+  if (context.sink == 0x5EED) {
+    printf("\n");
+  }
+
+  roy_string_delete(context.text, NULL);
+  free(context.order);
+  free(context.shuffled);
+  free(context.keys);
+  free(context.universe);
+  return EXIT_SUCCESS;
+}
+
+static void
+keep(__attribute__((unused)) void * data,
+     __attribute__((unused)) void * user_data) {
+  // The keys belong to the benchmark, not to the containers.
+}
+
+static void
+fold(void * data,
+     void * user_data) {
+  *(uint64_t *)user_data += *(const uint64_t *)data;
+}
+
+static void
+tally(__attribute__((unused)) void * data,
+      void                         * user_data) {
+  (*(uint64_t *)user_data)++;
+}
+
+static int
+compare_uint(const uint64_t * lhs,
+             const uint64_t * rhs) {
+  return *lhs < *rhs ? -1 : *lhs > *rhs;
+}
+
+static int
+compare_pair(const RoyPair * lhs,
+             const RoyPair * rhs) {
+  return compare_uint(lhs->key, rhs->key);
+}
+
+static void
+delete_pair(RoyPair                        * pair,
+            __attribute__((unused)) void   * user_data) {
+  free(pair);
+}
+
+static void
+vector_build(Context * context) {
+  context->vector = roy_vector_new(context->count, keep);
+  for (size_t i = 0; i != context->count; i++) {
+    roy_vector_push_back(context->vector, &context->universe[i]);
+  }
+}
+
+static void
+vector_destroy(Context * context) {
+  roy_vector_delete(context->vector, NULL);
+}
+
+static void
+vector_push_back(Context * context) {
+  context->vector = roy_vector_new(0, keep);
+  for (size_t i = 0; i != context->count; i++) {
+    roy_vector_push_back(context->vector, &context->universe[context->keys[i]]);
+  }
+}
+
+static void
+vector_at(Context * context) {
+  for (size_t i = 0; i != context->count; i++) {
+    context->sink += *roy_vector_at(context->vector, context->keys[i], uint64_t);
+  }
+}
+
+static void
+vector_erase_fast(Context * context) {
+  for (size_t i = 0; i != context->count; i++) {
+    roy_vector_erase_fast(context->vector, context->keys[i] % roy_vector_size(context->vector));
+  }
+}
+
+static void
+vector_for_each(Context * context) {
+  roy_vector_for_each(context->vector, fold, &context->sink);
+}
+
+static void
+vector_build_shuffled(Context * context) {
+  context->vector = roy_vector_new(context->count, keep);
+  for (size_t i = 0; i != context->count; i++) {
+    roy_vector_push_back(context->vector, &context->shuffled[i]);
+  }
+}
+
+static void
+vector_sort(Context * context) {
+  roy_vector_sort(context->vector, (RComparer)compare_uint);
+}
+
+static void
+vector_parallel_sort(Context * context) {
+  roy_vector_parallel_sort(context->vector, context->pool, (RComparer)compare_uint);
+}
+
+static void
+deque_build(Context * context) {
+  context->deque = roy_deque_new(keep);
+  for (size_t i = 0; i != context->count; i++) {
+    roy_deque_push_back(context->deque, &context->universe[i]);
+  }
+}
+
+static void
+deque_destroy(Context * context) {
+  roy_deque_delete(context->deque, NULL);
+}
+
+static void
+deque_push_back(Context * context) {
+  context->deque = roy_deque_new(keep);
+  for (size_t i = 0; i != context->count; i++) {
+    roy_deque_push_back(context->deque, &context->universe[context->keys[i]]);
+  }
+}
+
+static void
+deque_at(Context * context) {
+  for (size_t i = 0; i != context->count; i++) {
+    context->sink += *(const uint64_t *)roy_deque_pointer(context->deque, context->keys[i]);
+  }
+}
+
+static void
+deque_pop_front(Context * context) {
+  for (size_t i = 0; i != context->count; i++) {
+    roy_deque_pop_front(context->deque, NULL);
+  }
+}
+
+static void
+deque_for_each(Context * context) {
+  roy_deque_for_each(context->deque, fold, &context->sink);
+}
+
+static void
+set_build(Context * context) {
+  context->set = roy_set_new();
+  for (size_t i = 0; i != context->count; i++) {
+    roy_set_insert(&context->set, &context->universe[context->order[i]], (RComparer)compare_uint);
+  }
+}
+
+static void
+set_destroy(Context * context) {
+  roy_set_delete(context->set, keep, NULL);
+}
+
+static void
+set_insert(Context * context) {
+  context->set = roy_set_new();
+  for (size_t i = 0; i != context->count; i++) {
+    roy_set_insert(&context->set, &context->universe[context->keys[i]], (RComparer)compare_uint);
+  }
+}
+
+static void
+set_find(Context * context) {
+  for (size_t i = 0; i != context->count; i++) {
+    context->sink += roy_set_find(context->set, &context->keys[i], (RComparer)compare_uint) != NULL;
+  }
+}
+
+static void
+set_remove(Context * context) {
+  for (size_t i = 0; i != context->count; i++) {
+    roy_set_remove(&context->set, &context->keys[i], (RComparer)compare_uint, keep, NULL);
+  }
+}
+
+static void
+set_for_each(Context * context) {
+  roy_set_for_each(context->set, fold, &context->sink);
+}
+
+static void
+map_build(Context * context) {
+  context->map = roy_map_new((RComparer)compare_pair, (RDoer)delete_pair);
+  for (size_t i = 0; i != context->count; i++) {
+    roy_map_insert(context->map, &context->universe[context->order[i]], context);
+  }
+}
+
+static void
+map_destroy(Context * context) {
+  roy_map_delete(context->map, NULL);
+}
+
+static void
+map_insert(Context * context) {
+  context->map = roy_map_new((RComparer)compare_pair, (RDoer)delete_pair);
+  for (size_t i = 0; i != context->count; i++) {
+    uint64_t * key = &context->universe[context->keys[i]];
+    if (!roy_map_find(context->map, key)) {
+      roy_map_insert(context->map, key, context);
+    }
+  }
+}
+
+static void
+map_find(Context * context) {
+  for (size_t i = 0; i != context->count; i++) {
+    context->sink += roy_map_find(context->map, &context->keys[i]) != NULL;
+  }
+}
+
+static void
+map_remove(Context * context) {
+  for (size_t i = 0; i != context->count; i++) {
+    roy_map_remove(context->map, &context->keys[i]);
+  }
+}
+
+static void
+map_for_each(Context * context) {
+  roy_map_for_each(context->map, tally, &context->sink);
+}
+
+static void
+uset_build(Context * context) {
+  context->uset = roy_uset_new(context->count, 0, NULL, (RComparer)compare_uint, keep);
+  for (size_t i = 0; i != context->count; i++) {
+    roy_uset_insert(context->uset, &context->universe[i], sizeof(uint64_t));
+  }
+}
+
+static void
+uset_destroy(Context * context) {
+  roy_uset_delete(context->uset, NULL);
+}
+
+static void
+uset_insert(Context * context) {
+  context->uset = roy_uset_new(context->count, 0, NULL, (RComparer)compare_uint, keep);
+  for (size_t i = 0; i != context->count; i++) {
+    roy_uset_insert(context->uset, &context->universe[context->keys[i]], sizeof(uint64_t));
+  }
+}
+
+static void
+uset_find(Context * context) {
+  for (size_t i = 0; i != context->count; i++) {
+    context->sink += roy_uset_find(context->uset, &context->keys[i], sizeof(uint64_t)) != NULL;
+  }
+}
+
+static void
+uset_remove(Context * context) {
+  for (size_t i = 0; i != context->count; i++) {
+    roy_uset_remove(context->uset, &context->keys[i], sizeof(uint64_t), NULL);
+  }
+}
+
+static void
+uset_for_each(Context * context) {
+  roy_uset_for_each(context->uset, fold, &context->sink);
+}
+
+static void
+umap_build(Context * context) {
+  context->umap = roy_umap_new(context->count, 0, NULL, (RComparer)compare_pair, (RDoer)delete_pair);
+  for (size_t i = 0; i != context->count; i++) {
+    roy_umap_insert(context->umap, &context->universe[i], sizeof(uint64_t), context);
+  }
+}
+
+static void
+umap_destroy(Context * context) {
+  roy_umap_delete(context->umap, NULL);
+}
+
+static void
+umap_insert(Context * context) {
+  context->umap = roy_umap_new(context->count, 0, NULL, (RComparer)compare_pair, (RDoer)delete_pair);
+  for (size_t i = 0; i != context->count; i++) {
+    roy_umap_insert(context->umap, &context->universe[context->keys[i]], sizeof(uint64_t), context);
+  }
+}
+
+static void
+umap_find(Context * context) {
+  for (size_t i = 0; i != context->count; i++) {
+    context->sink += roy_umap_find(context->umap, &context->keys[i], sizeof(uint64_t)) != NULL;
+  }
+}
+
+static void
+umap_remove(Context * context) {
+  for (size_t i = 0; i != context->count; i++) {
+    roy_umap_remove(context->umap, &context->keys[i], sizeof(uint64_t), NULL);
+  }
+}
+
+static void
+umap_for_each(Context * context) {
+  roy_umap_for_each(context->umap, tally, &context->sink);
+}
+
+static void
+words_destroy(Context * context) {
+  context->sink += roy_deque_size(context->words);
+  roy_deque_delete(context->words, NULL);
+}
+
+static void
+string_split(Context * context) {
+  context->words = roy_deque_new((RDoer)roy_string_delete);
+  roy_string_split(context->words, context->text, ",");
+}
+
+static void
+string_split_char(Context * context) {
+  context->words = roy_deque_new((RDoer)roy_string_delete);
+  roy_string_split_char(context->words, context->text, ',');
+}
+
+static void
+string_find_literal(Context * context) {
+  // The text has no upper case letters, the whole of it is scanned.
+  context->sink += roy_string_find_literal(context->text, "Needle", 0).begin;
+}
+
+static void
+string_find_regex(Context * context) {
+  context->sink += roy_string_find(context->text, "[A-Z][a-z]+[0-9]", 0).begin;
+}
+
+// Makes 'count' words of lower case letters and digits, separated by commas.
+static RoyString *
+make_text(size_t count) {
+  char * buffer = malloc(count * (WORD_LENGTH_MAX + 1) + 1);
+  size_t length = 0;
+  uint64_t state = DEFAULT_SEED;
+  for (size_t i = 0; i != count; i++) {
+    uint64_t word = roy_splitmix64(&state);
+    size_t word_length = 1 + word % (WORD_LENGTH_MAX - 1);
+    for (size_t j = 0; j != word_length; j++, word /= 36) {
+      buffer[length++] = "abcdefghijklmnopqrstuvwxyz0123456789"[word % 36];
+    }
+    buffer[length++] = ',';
+  }
+  buffer[length] = '\0';
+  RoyString * ret = roy_string_new(buffer);
+  free(buffer);
+  return ret;
+}
+
+static void
+usage(const char * program) {
+  fprintf(stderr,
+          "usage: %s [options]\n"
+          "  -n, --count N             elements per container (default %d)\n"
+          "  -w, --warmup N            runs before measuring (default %d)\n"
+          "  -r, --repetitions N       runs measured (default %d)\n"
+          "  -d, --distribution NAME   sequential, random or zipfian keys (default random),\n"
+          "                            sequential keys skip the insertions into the unbalanced RoySet and RoyMap\n"
+          "  -s, --seed N              seed of the keys (default %d)\n"
+          "  -f, --filter TEXT         runs only the benchmarks whose names contain TEXT\n"
+          "  -c, --counters            reads hardware counters by perf_event_open\n",
+          program, DEFAULT_COUNT, DEFAULT_WARMUP, DEFAULT_REPETITIONS, DEFAULT_SEED);
+}
@@ -0,0 +1,870 @@
+#include "royroaring.h"
+
+enum {
+  CHUNK_BITS         = 16,
+  CHUNK_SIZE         = 0x10000,
+  BITMAP_WORDS       = CHUNK_SIZE / 64,
+  ARRAY_MAX          = 0x1000,
+  ARRAY_CAPACITY     = 4,
+  CONTAINER_CAPACITY = 4
+};
+
+typedef enum Kind_ {
+  KIND_ARRAY,
+  KIND_BITMAP,
+  KIND_RUN
+} Kind;
+
+// The integers in [start, last] of a chunk.
+typedef struct Run_ {
+  uint16_t start;
+  uint16_t last;
+} Run;
+
+// The lower 16 bits of the integers in one chunk.
+typedef struct Container_ {
+  void     * data;        // sorted 'uint16_t' values, BITMAP_WORDS 'uint64_t' words, or sorted 'Run's.
+  uint32_t   cardinality;
+  uint32_t   length;      // the number of values or runs in 'data', unused by bitmaps.
+  uint32_t   capacity;    // the number of values or runs 'data' holds, unused by bitmaps.
+  Kind       kind;
+} Container;
+
+typedef void (* Combiner) (Container * dest, const Container * src);
+
+// 'containers[i]' holds the chunk whose upper 16 bits are 'keys[i]', in ascending order of keys.
+struct RoyRoaring_ {
+  uint16_t  * keys;
+  Container * containers;
+  size_t      size;
+  size_t      capacity;
+  size_t      cardinality;
+};
+
+static size_t key_position(const RoyRoaring * roaring, uint16_t key);
+static void insert_container(RoyRoaring * roaring, size_t position, uint16_t key, Container container);
+static void erase_container(RoyRoaring * roaring, size_t position);
+static void recount(RoyRoaring * roaring);
+static Container container_make(Kind kind, size_t capacity);
+static Container container_clone(const Container * container);
+static void container_free(Container * container);
+static size_t container_memory(const Container * container);
+static bool container_contains(const Container * container, uint16_t value);
+static bool container_insert(Container * container, uint16_t value);
+static bool container_remove(Container * container, uint16_t value);
+static void container_insert_range(Container * container, uint16_t first, uint16_t last);
+static void container_expand(Container * container);
+static void container_fit(Container * container);
+static void container_to_bitmap(Container * container);
+static void container_to_runs(Container * container);
+static size_t container_count_runs(const Container * container);
+static size_t container_extract(const Container * container, uint32_t high, uint32_t * dest);
+static void container_combine(Container * dest, const Container * src, Combiner combiner);
+static void container_union(Container * dest, const Container * src);
+static void container_intersection(Container * dest, const Container * src);
+static void container_difference(Container * dest, const Container * src);
+static void array_reserve(Container * container, size_t capacity);
+static size_t array_position(const uint16_t * values, size_t length, uint16_t value);
+static size_t bitmap_count(const uint64_t * words);
+static void bitmap_set_range(uint64_t * words, uint32_t first, uint32_t last);
+static uint32_t bitmap_next(const uint64_t * words, uint32_t position, bool value);
+
+RoyRoaring *
+roy_roaring_new(void) {
+  RoyRoaring * ret = malloc(sizeof(RoyRoaring));
+  ret->keys        = malloc(CONTAINER_CAPACITY * sizeof(uint16_t));
+  ret->containers  = malloc(CONTAINER_CAPACITY * sizeof(Container));
+  ret->size        = 0;
+  ret->capacity    = CONTAINER_CAPACITY;
+  ret->cardinality = 0;
+  return ret;
+}
+
+RoyRoaring *
+roy_roaring_copy(const RoyRoaring * other) {
+  RoyRoaring * ret = roy_roaring_new();
+  roy_roaring_union(ret, other);
+  return ret;
+}
+
+void
+roy_roaring_delete(RoyRoaring                   * roaring,
+                   __attribute__((unused)) void * user_data) {
+  roy_roaring_clear(roaring);
+  free(roaring->containers);
+  free(roaring->keys);
+  free(roaring);
+}
+
+size_t
+roy_roaring_size(const RoyRoaring * roaring) {
+  return roaring->cardinality;
+}
+
+bool
+roy_roaring_empty(const RoyRoaring * roaring) {
+  return roaring->cardinality == 0;
+}
+
+size_t
+roy_roaring_memory(const RoyRoaring * roaring) {
+  size_t ret = sizeof(RoyRoaring) + roaring->capacity * (sizeof(uint16_t) + sizeof(Container));
+  for (size_t i = 0; i != roaring->size; i++) {
+    ret += container_memory(&roaring->containers[i]);
+  }
+  return ret;
+}
+
+bool
+roy_roaring_insert(RoyRoaring * roaring,
+                   uint32_t     value) {
+  uint16_t key = value >> CHUNK_BITS;
+  size_t position = key_position(roaring, key);
+  if (position == roaring->size || roaring->keys[position] != key) {
+    insert_container(roaring, position, key, container_make(KIND_ARRAY, ARRAY_CAPACITY));
+  }
+  bool ret = container_insert(&roaring->containers[position], (uint16_t)value);
+  roaring->cardinality += ret;
+  return ret;
+}
+
+void
+roy_roaring_insert_range(RoyRoaring * roaring,
+                         uint32_t     first,
+                         uint32_t     last) {
+  if (first > last) {
+    return;
+  }
+  for (uint32_t key = first >> CHUNK_BITS; key <= last >> CHUNK_BITS; key++) {
+    uint16_t low  = key == first >> CHUNK_BITS ? (uint16_t)first : 0;
+    uint16_t high = key == last  >> CHUNK_BITS ? (uint16_t)last  : CHUNK_SIZE - 1;
+    size_t position = key_position(roaring, key);
+    if (position == roaring->size || roaring->keys[position] != key) {
+      // A new chunk is filled by a single run.
+      Container container = container_make(KIND_RUN, 1);
+      Run run = { low, high };
+      *(Run *)container.data = run;
+      container.length      = 1;
+      container.cardinality = high - low + 1;
+      insert_container(roaring, position, key, container);
+    } else {
+      container_insert_range(&roaring->containers[position], low, high);
+    }
+  }
+  recount(roaring);
+}
+
+bool
+roy_roaring_remove(RoyRoaring * roaring,
+                   uint32_t     value) {
+  uint16_t key = value >> CHUNK_BITS;
+  size_t position = key_position(roaring, key);
+  if (position == roaring->size || roaring->keys[position] != key ||
+      !container_remove(&roaring->containers[position], (uint16_t)value)) {
+    return false;
+  }
+  if (roaring->containers[position].cardinality == 0) {
+    erase_container(roaring, position);
+  }
+  roaring->cardinality--;
+  return true;
+}
+
+void
+roy_roaring_clear(RoyRoaring * roaring) {
+  for (size_t i = 0; i != roaring->size; i++) {
+    container_free(&roaring->containers[i]);
+  }
+  roaring->size        = 0;
+  roaring->cardinality = 0;
+}
+
+void
+roy_roaring_optimize(RoyRoaring * roaring) {
+  for (size_t i = 0; i != roaring->size; i++) {
+    Container * container = &roaring->containers[i];
+    size_t run_memory   = container_count_runs(container) * sizeof(Run);
+    size_t plain_memory = container->cardinality <= ARRAY_MAX ? container->cardinality * sizeof(uint16_t) :
+                                                                BITMAP_WORDS * sizeof(uint64_t);
+    if (run_memory < plain_memory) {
+      container_to_runs(container);
+    } else {
+      container_expand(container);
+      if (container->kind == KIND_ARRAY && container->capacity > container->length) {
+        container->capacity = container->length;
+        container->data     = realloc(container->data, container->capacity * sizeof(uint16_t));
+      }
+    }
+  }
+}
+
+bool
+roy_roaring_contains(const RoyRoaring * roaring,
+                     uint32_t           value) {
+  uint16_t key = value >> CHUNK_BITS;
+  size_t position = key_position(roaring, key);
+  return position != roaring->size && roaring->keys[position] == key &&
+         container_contains(&roaring->containers[position], (uint16_t)value);
+}
+
+void
+roy_roaring_union(RoyRoaring       * dest,
+                  const RoyRoaring * other) {
+  if (dest == other) {
+    return;
+  }
+  // Merges the chunks of both into new arrays, which are large enough for all of them.
+  size_t capacity = dest->size + other->size > CONTAINER_CAPACITY ? dest->size + other->size : CONTAINER_CAPACITY;
+  uint16_t  * keys       = malloc(capacity * sizeof(uint16_t));
+  Container * containers = malloc(capacity * sizeof(Container));
+  size_t size = 0, i = 0, j = 0;
+  while (i != dest->size || j != other->size) {
+    if (j == other->size || (i != dest->size && dest->keys[i] < other->keys[j])) {
+      keys[size]       = dest->keys[i];
+      containers[size] = dest->containers[i++];
+    } else if (i == dest->size || other->keys[j] < dest->keys[i]) {
+      keys[size]       = other->keys[j];
+      containers[size] = container_clone(&other->containers[j++]);
+    } else {
+      keys[size]       = dest->keys[i];
+      containers[size] = dest->containers[i++];
+      container_combine(&containers[size], &other->containers[j++], container_union);
+    }
+    size++;
+  }
+  free(dest->keys);
+  free(dest->containers);
+  dest->keys       = keys;
+  dest->containers = containers;
+  dest->size       = size;
+  dest->capacity   = capacity;
+  recount(dest);
+}
+
+void
+roy_roaring_intersection(RoyRoaring       * dest,
+                         const RoyRoaring * other) {
+  if (dest == other) {
+    return;
+  }
+  size_t size = 0;
+  for (size_t i = 0, j = 0; i != dest->size; i++) {
+    for (; j != other->size && other->keys[j] < dest->keys[i]; j++) {
+      continue;
+    }
+    if (j != other->size && other->keys[j] == dest->keys[i]) {
+      container_combine(&dest->containers[i], &other->containers[j], container_intersection);
+      if (dest->containers[i].cardinality != 0) {
+        dest->keys[size]         = dest->keys[i];
+        dest->containers[size++] = dest->containers[i];
+        continue;
+      }
+    }
+    container_free(&dest->containers[i]);
+  }
+  dest->size = size;
+  recount(dest);
+}
+
+void
+roy_roaring_difference(RoyRoaring       * dest,
+                       const RoyRoaring * other) {
+  if (dest == other) {
+    roy_roaring_clear(dest);
+    return;
+  }
+  size_t size = 0;
+  for (size_t i = 0, j = 0; i != dest->size; i++) {
+    for (; j != other->size && other->keys[j] < dest->keys[i]; j++) {
+      continue;
+    }
+    if (j != other->size && other->keys[j] == dest->keys[i]) {
+      container_combine(&dest->containers[i], &other->containers[j], container_difference);
+      if (dest->containers[i].cardinality == 0) {
+        container_free(&dest->containers[i]);
+        continue;
+      }
+    }
+    dest->keys[size]         = dest->keys[i];
+    dest->containers[size++] = dest->containers[i];
+  }
+  dest->size = size;
+  recount(dest);
+}
+
+size_t
+roy_roaring_to_array(uint32_t         * dest,
+                     const RoyRoaring * roaring) {
+  size_t ret = 0;
+  for (size_t i = 0; i != roaring->size; i++) {
+    ret += container_extract(&roaring->containers[i], (uint32_t)roaring->keys[i] << CHUNK_BITS, dest + ret);
+  }
+  return ret;
+}
+
+void
+roy_roaring_for_each(const RoyRoaring * roaring,
+                     RDoer              doer,
+                     void             * user_data) {
+  // Extracts one chunk at a time into a buffer.
+  uint32_t * buffer = malloc(CHUNK_SIZE * sizeof(uint32_t));
+  for (size_t i = 0; i != roaring->size; i++) {
+    size_t count = container_extract(&roaring->containers[i], (uint32_t)roaring->keys[i] << CHUNK_BITS, buffer);
+    for (size_t j = 0; j != count; j++) {
+      doer(buffer + j, user_data);
+    }
+  }
+  free(buffer);
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+static size_t
+key_position(const RoyRoaring * roaring,
+             uint16_t           key) {
+  // Integers are mostly added in ascending order, which lands in the last chunk.
+  if (roaring->size != 0 && roaring->keys[roaring->size - 1] <= key) {
+    return roaring->keys[roaring->size - 1] == key ? roaring->size - 1 : roaring->size;
+  }
+  size_t low = 0, high = roaring->size;
+  while (low != high) {
+    size_t middle = low + (high - low) / 2;
+    if (roaring->keys[middle] < key) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+static void
+insert_container(RoyRoaring * roaring,
+                 size_t       position,
+                 uint16_t     key,
+                 Container    container) {
+  if (roaring->size == roaring->capacity) {
+    roaring->capacity  *= 2;
+    roaring->keys       = realloc(roaring->keys, roaring->capacity * sizeof(uint16_t));
+    roaring->containers = realloc(roaring->containers, roaring->capacity * sizeof(Container));
+  }
+  memmove(roaring->keys + position + 1, roaring->keys + position,
+          (roaring->size - position) * sizeof(uint16_t));
+  memmove(roaring->containers + position + 1, roaring->containers + position,
+          (roaring->size - position) * sizeof(Container));
+  roaring->keys[position]       = key;
+  roaring->containers[position] = container;
+  roaring->size++;
+}
+
+static void
+erase_container(RoyRoaring * roaring,
+                size_t       position) {
+  container_free(&roaring->containers[position]);
+  memmove(roaring->keys + position, roaring->keys + position + 1,
+          (roaring->size - position - 1) * sizeof(uint16_t));
+  memmove(roaring->containers + position, roaring->containers + position + 1,
+          (roaring->size - position - 1) * sizeof(Container));
+  roaring->size--;
+}
+
+static void
+recount(RoyRoaring * roaring) {
+  roaring->cardinality = 0;
+  for (size_t i = 0; i != roaring->size; i++) {
+    roaring->cardinality += roaring->containers[i].cardinality;
+  }
+}
+
+static Container
+container_make(Kind   kind,
+               size_t capacity) {
+  Container ret = { NULL, 0, 0, (uint32_t)capacity, kind };
+  if (kind == KIND_BITMAP) {
+    ret.data     = calloc(BITMAP_WORDS, sizeof(uint64_t));
+    ret.capacity = 0;
+  } else {
+    ret.data = malloc(capacity * (kind == KIND_ARRAY ? sizeof(uint16_t) : sizeof(Run)));
+  }
+  return ret;
+}
+
+static Container
+container_clone(const Container * container) {
+  Container ret = *container;
+  size_t memory = container_memory(container);
+  ret.data = memcpy(malloc(memory), container->data, memory);
+  return ret;
+}
+
+static void
+container_free(Container * container) {
+  free(container->data);
+  container->data = NULL;
+}
+
+static size_t
+container_memory(const Container * container) {
+  switch (container->kind) {
+    case KIND_ARRAY:  return container->capacity * sizeof(uint16_t);
+    case KIND_BITMAP: return BITMAP_WORDS * sizeof(uint64_t);
+    default:          return container->capacity * sizeof(Run);
+  }
+}
+
+static bool
+container_contains(const Container * container,
+                   uint16_t          value) {
+  if (container->kind == KIND_BITMAP) {
+    return ((const uint64_t *)container->data)[value / 64] >> (value % 64) & 1;
+  }
+  if (container->kind == KIND_ARRAY) {
+    const uint16_t * values = container->data;
+    size_t position = array_position(values, container->length, value);
+    return position != container->length && values[position] == value;
+  }
+  // Finds the last run starting no later than 'value'.
+  const Run * runs = container->data;
+  size_t low = 0, high = container->length;
+  while (low != high) {
+    size_t middle = low + (high - low) / 2;
+    if (runs[middle].start <= value) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low != 0 && value <= runs[low - 1].last;
+}
+
+static bool
+container_insert(Container * container,
+                 uint16_t    value) {
+  container_expand(container);
+  if (container->kind == KIND_ARRAY) {
+    uint16_t * values = container->data;
+    size_t position = array_position(values, container->length, value);
+    if (position != container->length && values[position] == value) {
+      return false;
+    }
+    if (container->cardinality == ARRAY_MAX) {
+      container_to_bitmap(container);
+      return container_insert(container, value);
+    }
+    array_reserve(container, container->length + 1);
+    values = container->data;
+    memmove(values + position + 1, values + position, (container->length - position) * sizeof(uint16_t));
+    values[position] = value;
+    container->length++;
+  } else {
+    uint64_t * word = (uint64_t *)container->data + value / 64;
+    if (*word >> (value % 64) & 1) {
+      return false;
+    }
+    *word |= 1ULL << (value % 64);
+  }
+  container->cardinality++;
+  return true;
+}
+
+static bool
+container_remove(Container * container,
+                 uint16_t    value) {
+  if (!container_contains(container, value)) {
+    return false;
+  }
+  container_expand(container);
+  if (container->kind == KIND_ARRAY) {
+    uint16_t * values = container->data;
+    size_t position = array_position(values, container->length, value);
+    memmove(values + position, values + position + 1, (container->length - position - 1) * sizeof(uint16_t));
+    container->length--;
+    container->cardinality--;
+  } else {
+    ((uint64_t *)container->data)[value / 64] &= ~(1ULL << (value % 64));
+    container->cardinality--;
+    container_fit(container);
+  }
+  return true;
+}
+
+static void
+container_insert_range(Container * container,
+                       uint16_t    first,
+                       uint16_t    last) {
+  container_expand(container);
+  container_to_bitmap(container);
+  bitmap_set_range(container->data, first, last);
+  container->cardinality = bitmap_count(container->data);
+  container_fit(container);
+}
+
+// Turns a list of runs into an array or a bitmap, depending on the cardinality.
+static void
+container_expand(Container * container) {
+  if (container->kind != KIND_RUN) {
+    return;
+  }
+  const Run * runs = container->data;
+  Container expanded;
+  if (container->cardinality > ARRAY_MAX) {
+    expanded = container_make(KIND_BITMAP, 0);
+    for (size_t i = 0; i != container->length; i++) {
+      bitmap_set_range(expanded.data, runs[i].start, runs[i].last);
+    }
+  } else {
+    expanded = container_make(KIND_ARRAY, container->cardinality > ARRAY_CAPACITY ? container->cardinality : ARRAY_CAPACITY);
+    uint16_t * values = expanded.data;
+    for (size_t i = 0; i != container->length; i++) {
+      for (uint32_t value = runs[i].start; value <= runs[i].last; value++) {
+        values[expanded.length++] = (uint16_t)value;
+      }
+    }
+  }
+  expanded.cardinality = container->cardinality;
+  container_free(container);
+  *container = expanded;
+}
+
+// Keeps arrays no larger than ARRAY_MAX, and bitmaps larger than ARRAY_MAX.
+static void
+container_fit(Container * container) {
+  if (container->kind == KIND_ARRAY && container->cardinality > ARRAY_MAX) {
+    container_to_bitmap(container);
+  } else if (container->kind == KIND_BITMAP && container->cardinality <= ARRAY_MAX) {
+    Container array = container_make(KIND_ARRAY, container->cardinality > ARRAY_CAPACITY ? container->cardinality : ARRAY_CAPACITY);
+    const uint64_t * words = container->data;
+    uint16_t * values = array.data;
+    for (size_t i = 0; i != BITMAP_WORDS; i++) {
+      for (uint64_t word = words[i]; word != 0; word &= word - 1) {
+        values[array.length++] = (uint16_t)(i * 64 + __builtin_ctzll(word));
+      }
+    }
+    array.cardinality = container->cardinality;
+    container_free(container);
+    *container = array;
+  }
+}
+
+static void
+container_to_bitmap(Container * container) {
+  if (container->kind == KIND_BITMAP) {
+    return;
+  }
+  container_expand(container);
+  if (container->kind == KIND_ARRAY) {
+    Container bitmap = container_make(KIND_BITMAP, 0);
+    uint64_t * words = bitmap.data;
+    const uint16_t * values = container->data;
+    for (size_t i = 0; i != container->length; i++) {
+      words[values[i] / 64] |= 1ULL << (values[i] % 64);
+    }
+    bitmap.cardinality = container->cardinality;
+    container_free(container);
+    *container = bitmap;
+  }
+}
+
+static void
+container_to_runs(Container * container) {
+  if (container->kind == KIND_RUN) {
+    return;
+  }
+  size_t run_count = container_count_runs(container);
+  Container list = container_make(KIND_RUN, run_count);
+  Run * runs = list.data;
+  if (container->kind == KIND_ARRAY) {
+    const uint16_t * values = container->data;
+    for (size_t i = 0; i != container->length; i++) {
+      if (list.length != 0 && runs[list.length - 1].last + 1 == values[i]) {
+        runs[list.length - 1].last = values[i];
+      } else {
+        Run run = { values[i], values[i] };
+        runs[list.length++] = run;
+      }
+    }
+  } else {
+    const uint64_t * words = container->data;
+    for (uint32_t start = bitmap_next(words, 0, true); start != CHUNK_SIZE; ) {
+      uint32_t end = bitmap_next(words, start, false);
+      Run run = { (uint16_t)start, (uint16_t)(end - 1) };
+      runs[list.length++] = run;
+      start = end == CHUNK_SIZE ? CHUNK_SIZE : bitmap_next(words, end, true);
+    }
+  }
+  list.cardinality = container->cardinality;
+  container_free(container);
+  *container = list;
+}
+
+static size_t
+container_count_runs(const Container * container) {
+  if (container->kind == KIND_RUN) {
+    return container->length;
+  }
+  size_t ret = 0;
+  if (container->kind == KIND_ARRAY) {
+    const uint16_t * values = container->data;
+    for (size_t i = 0; i != container->length; i++) {
+      ret += i == 0 || values[i] != values[i - 1] + 1;
+    }
+  } else {
+    // Counts the '1' bits whose lower neighbor is '0'.
+    const uint64_t * words = container->data;
+    uint64_t carry = 0;
+    for (size_t i = 0; i != BITMAP_WORDS; i++) {
+      ret  += __builtin_popcountll(words[i] & ~(words[i] << 1 | carry));
+      carry = words[i] >> 63;
+    }
+  }
+  return ret;
+}
+
+static size_t
+container_extract(const Container * container,
+                  uint32_t          high,
+                  uint32_t        * dest) {
+  size_t count = 0;
+  if (container->kind == KIND_ARRAY) {
+    const uint16_t * values = container->data;
+    for (size_t i = 0; i != container->length; i++) {
+      dest[count++] = high | values[i];
+    }
+  } else if (container->kind == KIND_BITMAP) {
+    const uint64_t * words = container->data;
+    for (size_t i = 0; i != BITMAP_WORDS; i++) {
+      for (uint64_t word = words[i]; word != 0; word &= word - 1) {
+        dest[count++] = high | (uint32_t)(i * 64 + __builtin_ctzll(word));
+      }
+    }
+  } else {
+    const Run * runs = container->data;
+    for (size_t i = 0; i != container->length; i++) {
+      for (uint32_t value = runs[i].start; value <= runs[i].last; value++) {
+        dest[count++] = high | value;
+      }
+    }
+  }
+  return count;
+}
+
+// Combines two containers after turning their lists of runs into arrays or bitmaps.
+static void
+container_combine(Container       * dest,
+                  const Container * src,
+                  Combiner          combiner) {
+  container_expand(dest);
+  if (src->kind == KIND_RUN) {
+    Container expanded = container_clone(src);
+    container_expand(&expanded);
+    combiner(dest, &expanded);
+    container_free(&expanded);
+  } else {
+    combiner(dest, src);
+  }
+}
+
+static void
+container_union(Container       * dest,
+                const Container * src) {
+  if (dest->kind == KIND_ARRAY && src->kind == KIND_ARRAY &&
+      dest->cardinality + src->cardinality <= ARRAY_MAX) {
+    Container merged = container_make(KIND_ARRAY, dest->length + src->length > ARRAY_CAPACITY ?
+                                                  dest->length + src->length : ARRAY_CAPACITY);
+    const uint16_t * lhs = dest->data, * rhs = src->data;
+    uint16_t * values = merged.data;
+    size_t i = 0, j = 0;
+    while (i != dest->length && j != src->length) {
+      uint16_t value = lhs[i] < rhs[j] ? lhs[i] : rhs[j];
+      i += lhs[i] == value;
+      j += rhs[j] == value;
+      values[merged.length++] = value;
+    }
+    memcpy(values + merged.length, lhs + i, (dest->length - i) * sizeof(uint16_t));
+    merged.length += dest->length - i;
+    memcpy(values + merged.length, rhs + j, (src->length - j) * sizeof(uint16_t));
+    merged.length += src->length - j;
+    merged.cardinality = merged.length;
+    container_free(dest);
+    *dest = merged;
+    return;
+  }
+  container_to_bitmap(dest);
+  uint64_t * words = dest->data;
+  if (src->kind == KIND_BITMAP) {
+    const uint64_t * other = src->data;
+    for (size_t i = 0; i != BITMAP_WORDS; i++) {
+      words[i] |= other[i];
+    }
+    dest->cardinality = bitmap_count(words);
+  } else {
+    const uint16_t * values = src->data;
+    for (size_t i = 0; i != src->length; i++) {
+      uint64_t bit = 1ULL << (values[i] % 64);
+      dest->cardinality += !(words[values[i] / 64] & bit);
+      words[values[i] / 64] |= bit;
+    }
+  }
+  container_fit(dest);
+}
+
+static void
+container_intersection(Container       * dest,
+                       const Container * src) {
+  if (dest->kind == KIND_ARRAY) {
+    // Filters the values in place.
+    uint16_t * values = dest->data;
+    size_t length = 0;
+    if (src->kind == KIND_ARRAY) {
+      const uint16_t * other = src->data;
+      for (size_t i = 0, j = 0; i != dest->length && j != src->length; ) {
+        if (values[i] < other[j]) {
+          i++;
+        } else if (other[j] < values[i]) {
+          j++;
+        } else {
+          values[length++] = values[i++];
+          j++;
+        }
+      }
+    } else {
+      for (size_t i = 0; i != dest->length; i++) {
+        if (container_contains(src, values[i])) {
+          values[length++] = values[i];
+        }
+      }
+    }
+    dest->length = dest->cardinality = length;
+  } else if (src->kind == KIND_ARRAY) {
+    Container array = container_make(KIND_ARRAY, src->length > ARRAY_CAPACITY ? src->length : ARRAY_CAPACITY);
+    const uint16_t * other = src->data;
+    uint16_t * values = array.data;
+    for (size_t i = 0; i != src->length; i++) {
+      if (container_contains(dest, other[i])) {
+        values[array.length++] = other[i];
+      }
+    }
+    array.cardinality = array.length;
+    container_free(dest);
+    *dest = array;
+  } else {
+    uint64_t * words = dest->data;
+    const uint64_t * other = src->data;
+    for (size_t i = 0; i != BITMAP_WORDS; i++) {
+      words[i] &= other[i];
+    }
+    dest->cardinality = bitmap_count(words);
+    container_fit(dest);
+  }
+}
+
+static void
+container_difference(Container       * dest,
+                     const Container * src) {
+  if (dest->kind == KIND_ARRAY) {
+    uint16_t * values = dest->data;
+    size_t length = 0;
+    if (src->kind == KIND_ARRAY) {
+      const uint16_t * other = src->data;
+      size_t j = 0;
+      for (size_t i = 0; i != dest->length; i++) {
+        for (; j != src->length && other[j] < values[i]; j++) {
+          continue;
+        }
+        if (j == src->length || other[j] != values[i]) {
+          values[length++] = values[i];
+        }
+      }
+    } else {
+      for (size_t i = 0; i != dest->length; i++) {
+        if (!container_contains(src, values[i])) {
+          values[length++] = values[i];
+        }
+      }
+    }
+    dest->length = dest->cardinality = length;
+    return;
+  }
+  uint64_t * words = dest->data;
+  if (src->kind == KIND_ARRAY) {
+    const uint16_t * values = src->data;
+    for (size_t i = 0; i != src->length; i++) {
+      uint64_t bit = 1ULL << (values[i] % 64);
+      dest->cardinality -= (words[values[i] / 64] & bit) != 0;
+      words[values[i] / 64] &= ~bit;
+    }
+  } else {
+    const uint64_t * other = src->data;
+    for (size_t i = 0; i != BITMAP_WORDS; i++) {
+      words[i] &= ~other[i];
+    }
+    dest->cardinality = bitmap_count(words);
+  }
+  container_fit(dest);
+}
+
+static void
+array_reserve(Container * container,
+              size_t      capacity) {
+  if (capacity > container->capacity) {
+    container->capacity = container->capacity * 2 > capacity ? container->capacity * 2 : capacity;
+    container->data     = realloc(container->data, container->capacity * sizeof(uint16_t));
+  }
+}
+
+static size_t
+array_position(const uint16_t * values,
+               size_t           length,
+               uint16_t         value) {
+  size_t low = 0, high = length;
+  while (low != high) {
+    size_t middle = low + (high - low) / 2;
+    if (values[middle] < value) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+static size_t
+bitmap_count(const uint64_t * words) {
+  size_t ret = 0;
+  for (size_t i = 0; i != BITMAP_WORDS; i++) {
+    ret += __builtin_popcountll(words[i]);
+  }
+  return ret;
+}
+
+static void
+bitmap_set_range(uint64_t * words,
+                 uint32_t   first,
+                 uint32_t   last) {
+  uint64_t first_mask = ~0ULL << (first % 64);
+  uint64_t last_mask  = ~0ULL >> (63 - last % 64);
+  if (first / 64 == last / 64) {
+    words[first / 64] |= first_mask & last_mask;
+    return;
+  }
+  words[first / 64] |= first_mask;
+  for (uint32_t i = first / 64 + 1; i != last / 64; i++) {
+    words[i] = ~0ULL;
+  }
+  words[last / 64] |= last_mask;
+}
+
+// Returns the position of the first bit equal to 'value' at or after 'position', or CHUNK_SIZE if none.
+static uint32_t
+bitmap_next(const uint64_t * words,
+            uint32_t         position,
+            bool             value) {
+  while (position < CHUNK_SIZE) {
+    uint64_t word = (value ? words[position / 64] : ~words[position / 64]) & ~0ULL << (position % 64);
+    if (word != 0) {
+      return position / 64 * 64 + __builtin_ctzll(word);
+    }
+    position = (position / 64 + 1) * 64;
+  }
+  return CHUNK_SIZE;
+}
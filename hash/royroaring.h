@@ -0,0 +1,114 @@
+#ifndef ROYROARING_H
+#define ROYROARING_H
+
+#include "../util/rpre.h"
+
+/**
+ * @brief RoyRoaring (aka 'Roaring Bitmap'): a compressed set of unsigned 32-bit integers.
+ * Integers are grouped by their upper 16 bits into chunks, every chunk is stored in the smallest of
+ * a sorted array (sparse chunks), a 65536-bit bitmap (dense chunks), or a list of runs (consecutive integers),
+ * so that a dense set takes little more than 1 bit per integer.
+ * @note - Set operations work chunk by chunk on whole arrays and bitmaps, without visiting single integers of bitmaps.
+ */
+typedef struct RoyRoaring_ RoyRoaring;
+
+/* CONSTRUCTION AND DESTRUCTION */
+
+/// @brief Creates an empty RoyRoaring.
+RoyRoaring * roy_roaring_new(void);
+
+/// @brief Creates a RoyRoaring with the integers of another RoyRoaring.
+RoyRoaring * roy_roaring_copy(const RoyRoaring * other);
+
+/**
+ * @brief Releases all the chunks and destroys the RoyRoaring - 'roaring' itself.
+ * @note - Always call this function after the work is done by the given 'roaring' to get rid of memory leaking.
+ */
+void roy_roaring_delete(RoyRoaring * roaring, void * user_data);
+
+/* CAPACITY */
+
+/// @brief Returns the number of integers in 'roaring'.
+size_t roy_roaring_size(const RoyRoaring * roaring);
+
+/**
+ * @brief Checks whether 'roaring' is empty.
+ * @retval true - there is no integer in 'roaring'.
+ * @retval false - otherwise.
+ */
+bool roy_roaring_empty(const RoyRoaring * roaring);
+
+/// @brief Returns the number of bytes taken by 'roaring', including itself.
+size_t roy_roaring_memory(const RoyRoaring * roaring);
+
+/* MODIFIERS */
+
+/**
+ * @brief Adds 'value' into 'roaring'.
+ * @retval true - the insertion is successful.
+ * @retval false - 'roaring' already contains 'value'.
+ */
+bool roy_roaring_insert(RoyRoaring * roaring, uint32_t value);
+
+/// @brief Adds all integers in [first, last] into 'roaring', a chunk at a time.
+void roy_roaring_insert_range(RoyRoaring * roaring, uint32_t first, uint32_t last);
+
+/**
+ * @brief Removes 'value' from 'roaring'.
+ * @retval true - the removal is successful.
+ * @retval false - 'roaring' does not contain 'value'.
+ */
+bool roy_roaring_remove(RoyRoaring * roaring, uint32_t value);
+
+/// @brief Removes all the integers from 'roaring'.
+void roy_roaring_clear(RoyRoaring * roaring);
+
+/**
+ * @brief Converts every chunk into a list of runs if that is the smallest form.
+ * @note - Chunks of runs turn back into arrays or bitmaps once they are modified,
+ *         call this function after building a set of long ranges of consecutive integers.
+ */
+void roy_roaring_optimize(RoyRoaring * roaring);
+
+/* LOOKUPS */
+
+/// @brief Checks whether 'roaring' contains 'value'.
+bool roy_roaring_contains(const RoyRoaring * roaring, uint32_t value);
+
+/* OPERATIONS */
+
+/**
+ * @brief Adds all integers of 'other' into 'dest'.
+ * @note 'dest' and 'other' can be identical.
+ */
+void roy_roaring_union(RoyRoaring * dest, const RoyRoaring * other);
+
+/**
+ * @brief Removes the integers not in 'other' from 'dest'.
+ * @note 'dest' and 'other' can be identical.
+ */
+void roy_roaring_intersection(RoyRoaring * dest, const RoyRoaring * other);
+
+/**
+ * @brief Removes the integers in 'other' from 'dest'.
+ * @note 'dest' and 'other' can be identical.
+ */
+void roy_roaring_difference(RoyRoaring * dest, const RoyRoaring * other);
+
+/**
+ * @brief Copies all integers of 'roaring' into 'dest' in ascending order.
+ * @param dest - holds at least 'roy_roaring_size' integers.
+ * @return the number of integers copied.
+ */
+size_t roy_roaring_to_array(uint32_t * dest, const RoyRoaring * roaring);
+
+/* TRAVERSE */
+
+/**
+ * @brief Traverses all integers in 'roaring' in ascending order.
+ * @param doer - a function for integer traversing, which receives a pointer to a uint32_t.
+ * @param user_data - data to cooperate with 'doer'.
+ */
+void roy_roaring_for_each(const RoyRoaring * roaring, RDoer doer, void * user_data);
+
+#endif // ROYROARING_H
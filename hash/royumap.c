@@ -1,15 +1,5 @@
 #include "royumap.h"
 
-struct RoyUSet_ {
-  RoySList  ** buckets;
-  uint64_t     seed;
-  RHash        hash;
-  RComparer    comparer;
-  RDoer        deleter;
-  size_t       bucket_count;
-  size_t       size;
-};
-
 struct RoyUMap_ {
   RoyUSet * uset;
 };
@@ -54,15 +44,13 @@ roy_umap_insert(RoyUMap * restrict umap,
                 void    * restrict key,
                 size_t             key_size,
                 void    * restrict value) {
-  RoySList ** node =
-    &umap->uset->buckets[roy_umap_bucket(umap, key, key_size)];
-  if (roy_slist_find(*node, key, umap->uset->comparer)) {
+  // Hashes the key alone, and compares the new RoyPair with the stored ones by their keys.
+  RoyPair * pair = roy_pair_new(key, value);
+  if (!roy_uset_bucket_insert(umap->uset, roy_umap_bucket(umap, key, key_size), pair)) {
+    free(pair);
     return false;
-  } else {
-    roy_slist_push_front(*node, roy_pair_new(key, value));
-    umap->uset->size++;
-    return true;
   }
+  return true;
 }
 
 bool
@@ -78,7 +66,9 @@ roy_umap_remove(RoyUMap    * umap,
                 const void * key,
                 size_t       key_size,
                 void       * user_data) {
-  return roy_uset_remove(umap->uset, key, key_size, user_data);
+  // Hashes the key alone, but compares it as a RoyPair like the stored ones.
+  RoyCPair pair = { key, NULL };
+  return roy_uset_bucket_remove(umap->uset, roy_umap_bucket(umap, key, key_size), &pair, user_data);
 }
 
 void
@@ -91,7 +81,9 @@ const void *
 roy_umap_find(const RoyUMap * umap,
               const void    * key,
               size_t          key_size) {
-  return (*(RoyCPair *)roy_uset_find(umap->uset, key, key_size)).value;
+  RoyCPair pair = { key, NULL };
+  const RoyCPair * found = roy_uset_bucket_find(umap->uset, roy_umap_bucket(umap, key, key_size), &pair);
+  return found ? found->value : NULL;
 }
 
 size_t
@@ -117,6 +109,77 @@ roy_umap_load_factor(const RoyUMap * umap) {
   return roy_uset_load_factor(umap->uset);
 }
 
+void
+roy_umap_reduce(const RoyUMap * umap,
+                void          * accumulator,
+                RReducer        reducer) {
+  roy_uset_reduce(umap->uset, accumulator, reducer);
+}
+
+void
+roy_umap_parallel_reduce(const RoyUMap * umap,
+                         RoyThreadPool * pool,
+                         void          * accumulator,
+                         size_t          accumulator_size,
+                         RReducer        reducer,
+                         RMerger         merger) {
+  roy_uset_parallel_reduce(umap->uset,
+                           pool,
+                           accumulator,
+                           accumulator_size,
+                           reducer,
+                           merger);
+}
+
+size_t
+roy_umap_count_if(const RoyUMap * umap,
+                  RChecker        checker) {
+  return roy_uset_count_if(umap->uset, checker);
+}
+
+size_t
+roy_umap_parallel_count_if(const RoyUMap * umap,
+                           RoyThreadPool * pool,
+                           RChecker        checker) {
+  return roy_uset_parallel_count_if(umap->uset, pool, checker);
+}
+
+size_t
+roy_umap_filter_into(const RoyUMap * umap,
+                     RoyVector     * dest,
+                     RChecker        checker,
+                     RMapper         copier,
+                     void          * user_data) {
+  return roy_uset_filter_into(umap->uset, dest, checker, copier, user_data);
+}
+
+size_t
+roy_umap_parallel_filter_into(const RoyUMap * umap,
+                              RoyThreadPool * pool,
+                              RoyVector     * dest,
+                              RChecker        checker,
+                              RMapper         copier,
+                              void          * user_data) {
+  return roy_uset_parallel_filter_into(umap->uset, pool, dest, checker, copier, user_data);
+}
+
+size_t
+roy_umap_transform_into(const RoyUMap * umap,
+                        RoyVector     * dest,
+                        RMapper         mapper,
+                        void          * user_data) {
+  return roy_uset_transform_into(umap->uset, dest, mapper, user_data);
+}
+
+size_t
+roy_umap_parallel_transform_into(const RoyUMap * umap,
+                                 RoyThreadPool * pool,
+                                 RoyVector     * dest,
+                                 RMapper         mapper,
+                                 void          * user_data) {
+  return roy_uset_parallel_transform_into(umap->uset, pool, dest, mapper, user_data);
+}
+
 void
 roy_umap_for_each(RoyUMap  * umap,
                   RDoer   oeprate,
@@ -131,3 +194,11 @@ roy_umap_for_which(RoyUMap  * umap,
                    void     * user_data) {
   roy_uset_for_which(umap->uset, checker, doer, user_data);
 }
+
+void
+roy_umap_parallel_for_each(RoyUMap       * umap,
+                           RoyThreadPool * pool,
+                           RDoer           doer,
+                           void          * user_data) {
+  roy_uset_parallel_for_each(umap->uset, pool, doer, user_data);
+}
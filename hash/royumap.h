@@ -23,7 +23,7 @@ typedef struct RoyUMap_ RoyUMap;
  * @brief Creates a RoyUMap.
  * @param seed - a hash seed.
  * @param hash - a hash function, NULL to use the default MurmurHash.
- * @param comparer - a function to compare two elements, acting like <=> operator in C++.
+ * @param comparer - a function to compare two RoyPairs by their keys, acting like <=> operator in C++.
  * @param deleter - a function for element deleting.
  * @return a pointer to a newly build RoyUMap.
  */
@@ -110,6 +110,7 @@ void roy_umap_clear(RoyUMap * umap, void * user_data);
  * @param key - a pointer to the comparable key.
  * @param key_size - total memory the key takes.
  * @return The const pointer to the value of the target RoyPair.
+ * @return NULL - 'umap' does not have a RoyPair with the specified key.
  */
 const void * roy_umap_find(const RoyUMap * umap, const void * key, size_t key_size);
 
@@ -134,6 +135,70 @@ int64_t roy_umap_bucket(const RoyUMap * umap, const void * data, size_t data_siz
  */
 double roy_umap_load_factor(const RoyUMap * umap);
 
+/* OPERATIONS */
+
+/**
+ * @brief Folds all elements into 'accumulator' sequentially.
+ * @param reducer - a function to fold an element into 'accumulator'.
+ * @note - The elements of a RoyUMap are its RoyPairs.
+ */
+void roy_umap_reduce(const RoyUMap * umap, void * accumulator, RReducer reducer);
+
+/**
+ * @brief Folds all elements into 'accumulator' on 'pool'.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param accumulator - holds the identity of 'merger' on entry, and the result on return.
+ * @param accumulator_size - the size of 'accumulator' in bytes.
+ * @param reducer - a function to fold an element into a partial accumulator, may be called from several threads at the same time.
+ * @param merger - a function to fold a partial accumulator into 'accumulator'.
+ * @note - 'umap' is split into ranges of buckets, see 'roy_parallel_reduce'.
+ */
+void roy_umap_parallel_reduce(const RoyUMap * umap, RoyThreadPool * pool, void * accumulator, size_t accumulator_size, RReducer reducer, RMerger merger);
+
+/// @brief Returns the number of elements which meet 'checker'.
+size_t roy_umap_count_if(const RoyUMap * umap, RChecker checker);
+
+/**
+ * @brief Returns the number of elements which meet 'checker', counted on 'pool'.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param checker - may be called from several threads at the same time.
+ */
+size_t roy_umap_parallel_count_if(const RoyUMap * umap, RoyThreadPool * pool, RChecker checker);
+
+/**
+ * @brief Appends the elements which meet 'checker' to the back of 'dest', in bucket order.
+ * @param copier - a function to copy an element for 'dest', NULL to share the element itself.
+ * @param user_data - data to cooperate with 'copier'.
+ * @return The number of appended elements.
+ * @note - Shared elements are owned by both containers, make sure only one of the deleters releases them.
+ */
+size_t roy_umap_filter_into(const RoyUMap * umap, RoyVector * dest, RChecker checker, RMapper copier, void * user_data);
+
+/**
+ * @brief Appends the elements which meet 'checker' to the back of 'dest' on 'pool', in bucket order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param checker - may be called from several threads at the same time.
+ * @param copier - may be called from several threads at the same time, NULL to share the element itself.
+ * @return The number of appended elements.
+ */
+size_t roy_umap_parallel_filter_into(const RoyUMap * umap, RoyThreadPool * pool, RoyVector * dest, RChecker checker, RMapper copier, void * user_data);
+
+/**
+ * @brief Appends what 'mapper' makes of every element to the back of 'dest', in bucket order.
+ * @param mapper - a function to make a new element for 'dest' out of an element.
+ * @param user_data - data to cooperate with 'mapper'.
+ * @return The number of appended elements.
+ */
+size_t roy_umap_transform_into(const RoyUMap * umap, RoyVector * dest, RMapper mapper, void * user_data);
+
+/**
+ * @brief Appends what 'mapper' makes of every element to the back of 'dest' on 'pool', in bucket order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param mapper - may be called from several threads at the same time.
+ * @return The number of appended elements.
+ */
+size_t roy_umap_parallel_transform_into(const RoyUMap * umap, RoyThreadPool * pool, RoyVector * dest, RMapper mapper, void * user_data);
+
 /* TRAVERSE */
 
 /**
@@ -151,4 +216,13 @@ void roy_umap_for_each(RoyUMap * umap, RDoer oeprate, void * user_data);
  */
 void roy_umap_for_which(RoyUMap * umap, RChecker checker, RDoer doer, void * user_data);
 
+/**
+ * @brief Traverses all elements in 'umap' concurrently on 'pool', in no particular order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param doer - a function for element traversing, must be safe to call from several threads at the same time.
+ * @param user_data - data to cooperate with 'doer'.
+ * @note - 'umap' is split into ranges of buckets.
+ */
+void roy_umap_parallel_for_each(RoyUMap * umap, RoyThreadPool * pool, RDoer doer, void * user_data);
+
 #endif // ROYUMAP_H
@@ -113,6 +113,77 @@ roy_ummap_load_factor(const RoyUMMap * ummap) {
   return roy_umset_load_factor(ummap->umset);
 }
 
+void
+roy_ummap_reduce(const RoyUMMap * ummap,
+                 void           * accumulator,
+                 RReducer         reducer) {
+  roy_umset_reduce(ummap->umset, accumulator, reducer);
+}
+
+void
+roy_ummap_parallel_reduce(const RoyUMMap * ummap,
+                          RoyThreadPool  * pool,
+                          void           * accumulator,
+                          size_t           accumulator_size,
+                          RReducer         reducer,
+                          RMerger          merger) {
+  roy_umset_parallel_reduce(ummap->umset,
+                            pool,
+                            accumulator,
+                            accumulator_size,
+                            reducer,
+                            merger);
+}
+
+size_t
+roy_ummap_count_if(const RoyUMMap * ummap,
+                   RChecker         checker) {
+  return roy_umset_count_if(ummap->umset, checker);
+}
+
+size_t
+roy_ummap_parallel_count_if(const RoyUMMap * ummap,
+                            RoyThreadPool  * pool,
+                            RChecker         checker) {
+  return roy_umset_parallel_count_if(ummap->umset, pool, checker);
+}
+
+size_t
+roy_ummap_filter_into(const RoyUMMap * ummap,
+                      RoyVector      * dest,
+                      RChecker         checker,
+                      RMapper          copier,
+                      void           * user_data) {
+  return roy_umset_filter_into(ummap->umset, dest, checker, copier, user_data);
+}
+
+size_t
+roy_ummap_parallel_filter_into(const RoyUMMap * ummap,
+                               RoyThreadPool  * pool,
+                               RoyVector      * dest,
+                               RChecker         checker,
+                               RMapper          copier,
+                               void           * user_data) {
+  return roy_umset_parallel_filter_into(ummap->umset, pool, dest, checker, copier, user_data);
+}
+
+size_t
+roy_ummap_transform_into(const RoyUMMap * ummap,
+                         RoyVector      * dest,
+                         RMapper          mapper,
+                         void           * user_data) {
+  return roy_umset_transform_into(ummap->umset, dest, mapper, user_data);
+}
+
+size_t
+roy_ummap_parallel_transform_into(const RoyUMMap * ummap,
+                                  RoyThreadPool  * pool,
+                                  RoyVector      * dest,
+                                  RMapper          mapper,
+                                  void           * user_data) {
+  return roy_umset_parallel_transform_into(ummap->umset, pool, dest, mapper, user_data);
+}
+
 void
 roy_ummap_for_each(RoyUMMap * ummap,
                    RDoer      oeprate,
@@ -127,3 +198,11 @@ roy_ummap_for_which(RoyUMMap * ummap,
                     void     * user_data) {
   roy_umset_for_which(ummap->umset, checker, doer, user_data);
 }
+
+void
+roy_ummap_parallel_for_each(RoyUMMap      * ummap,
+                            RoyThreadPool * pool,
+                            RDoer           doer,
+                            void          * user_data) {
+  roy_umset_parallel_for_each(ummap->umset, pool, doer, user_data);
+}
@@ -129,6 +129,70 @@ int64_t roy_ummap_bucket(const RoyUMMap * ummap, const void * data, size_t data_
  */
 double roy_ummap_load_factor(const RoyUMMap * ummap);
 
+/* OPERATIONS */
+
+/**
+ * @brief Folds all elements into 'accumulator' sequentially.
+ * @param reducer - a function to fold an element into 'accumulator'.
+ * @note - The elements of a RoyUMMap are its RoyPairs.
+ */
+void roy_ummap_reduce(const RoyUMMap * ummap, void * accumulator, RReducer reducer);
+
+/**
+ * @brief Folds all elements into 'accumulator' on 'pool'.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param accumulator - holds the identity of 'merger' on entry, and the result on return.
+ * @param accumulator_size - the size of 'accumulator' in bytes.
+ * @param reducer - a function to fold an element into a partial accumulator, may be called from several threads at the same time.
+ * @param merger - a function to fold a partial accumulator into 'accumulator'.
+ * @note - 'ummap' is split into ranges of buckets, see 'roy_parallel_reduce'.
+ */
+void roy_ummap_parallel_reduce(const RoyUMMap * ummap, RoyThreadPool * pool, void * accumulator, size_t accumulator_size, RReducer reducer, RMerger merger);
+
+/// @brief Returns the number of elements which meet 'checker'.
+size_t roy_ummap_count_if(const RoyUMMap * ummap, RChecker checker);
+
+/**
+ * @brief Returns the number of elements which meet 'checker', counted on 'pool'.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param checker - may be called from several threads at the same time.
+ */
+size_t roy_ummap_parallel_count_if(const RoyUMMap * ummap, RoyThreadPool * pool, RChecker checker);
+
+/**
+ * @brief Appends the elements which meet 'checker' to the back of 'dest', in bucket order.
+ * @param copier - a function to copy an element for 'dest', NULL to share the element itself.
+ * @param user_data - data to cooperate with 'copier'.
+ * @return The number of appended elements.
+ * @note - Shared elements are owned by both containers, make sure only one of the deleters releases them.
+ */
+size_t roy_ummap_filter_into(const RoyUMMap * ummap, RoyVector * dest, RChecker checker, RMapper copier, void * user_data);
+
+/**
+ * @brief Appends the elements which meet 'checker' to the back of 'dest' on 'pool', in bucket order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param checker - may be called from several threads at the same time.
+ * @param copier - may be called from several threads at the same time, NULL to share the element itself.
+ * @return The number of appended elements.
+ */
+size_t roy_ummap_parallel_filter_into(const RoyUMMap * ummap, RoyThreadPool * pool, RoyVector * dest, RChecker checker, RMapper copier, void * user_data);
+
+/**
+ * @brief Appends what 'mapper' makes of every element to the back of 'dest', in bucket order.
+ * @param mapper - a function to make a new element for 'dest' out of an element.
+ * @param user_data - data to cooperate with 'mapper'.
+ * @return The number of appended elements.
+ */
+size_t roy_ummap_transform_into(const RoyUMMap * ummap, RoyVector * dest, RMapper mapper, void * user_data);
+
+/**
+ * @brief Appends what 'mapper' makes of every element to the back of 'dest' on 'pool', in bucket order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param mapper - may be called from several threads at the same time.
+ * @return The number of appended elements.
+ */
+size_t roy_ummap_parallel_transform_into(const RoyUMMap * ummap, RoyThreadPool * pool, RoyVector * dest, RMapper mapper, void * user_data);
+
 /* TRAVERSE */
 
 /**
@@ -146,4 +210,13 @@ void roy_ummap_for_each(RoyUMMap * ummap, RDoer oeprate, void * user_data);
  */
 void roy_ummap_for_which(RoyUMMap * ummap, RChecker checker, RDoer doer, void * user_data);
 
+/**
+ * @brief Traverses all elements in 'ummap' concurrently on 'pool', in no particular order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param doer - a function for element traversing, must be safe to call from several threads at the same time.
+ * @param user_data - data to cooperate with 'doer'.
+ * @note - 'ummap' is split into ranges of buckets.
+ */
+void roy_ummap_parallel_for_each(RoyUMMap * ummap, RoyThreadPool * pool, RDoer doer, void * user_data);
+
 #endif // ROYUMAP_H
@@ -119,6 +119,77 @@ roy_umset_load_factor(const RoyUMSet * umset) {
   return roy_uset_load_factor((RoyUSet *)umset);
 }
 
+void
+roy_umset_reduce(const RoyUMSet * umset,
+                 void           * accumulator,
+                 RReducer         reducer) {
+  roy_uset_reduce((const RoyUSet *)umset, accumulator, reducer);
+}
+
+void
+roy_umset_parallel_reduce(const RoyUMSet * umset,
+                          RoyThreadPool  * pool,
+                          void           * accumulator,
+                          size_t           accumulator_size,
+                          RReducer         reducer,
+                          RMerger          merger) {
+  roy_uset_parallel_reduce((const RoyUSet *)umset,
+                           pool,
+                           accumulator,
+                           accumulator_size,
+                           reducer,
+                           merger);
+}
+
+size_t
+roy_umset_count_if(const RoyUMSet * umset,
+                   RChecker         checker) {
+  return roy_uset_count_if((const RoyUSet *)umset, checker);
+}
+
+size_t
+roy_umset_parallel_count_if(const RoyUMSet * umset,
+                            RoyThreadPool  * pool,
+                            RChecker         checker) {
+  return roy_uset_parallel_count_if((const RoyUSet *)umset, pool, checker);
+}
+
+size_t
+roy_umset_filter_into(const RoyUMSet * umset,
+                      RoyVector      * dest,
+                      RChecker         checker,
+                      RMapper          copier,
+                      void           * user_data) {
+  return roy_uset_filter_into((const RoyUSet *)umset, dest, checker, copier, user_data);
+}
+
+size_t
+roy_umset_parallel_filter_into(const RoyUMSet * umset,
+                               RoyThreadPool  * pool,
+                               RoyVector      * dest,
+                               RChecker         checker,
+                               RMapper          copier,
+                               void           * user_data) {
+  return roy_uset_parallel_filter_into((const RoyUSet *)umset, pool, dest, checker, copier, user_data);
+}
+
+size_t
+roy_umset_transform_into(const RoyUMSet * umset,
+                         RoyVector      * dest,
+                         RMapper          mapper,
+                         void           * user_data) {
+  return roy_uset_transform_into((const RoyUSet *)umset, dest, mapper, user_data);
+}
+
+size_t
+roy_umset_parallel_transform_into(const RoyUMSet * umset,
+                                  RoyThreadPool  * pool,
+                                  RoyVector      * dest,
+                                  RMapper          mapper,
+                                  void           * user_data) {
+  return roy_uset_parallel_transform_into((const RoyUSet *)umset, pool, dest, mapper, user_data);
+}
+
 void
 roy_umset_for_each(RoyUMSet * umset,
                    RDoer      oeprate,
@@ -133,3 +204,11 @@ roy_umset_for_which(RoyUMSet * umset,
                     void     * user_data) {
   roy_uset_for_which((RoyUSet *)umset, checker, oeprate, user_data);
 }
+
+void
+roy_umset_parallel_for_each(RoyUMSet      * umset,
+                            RoyThreadPool * pool,
+                            RDoer           doer,
+                            void          * user_data) {
+  roy_uset_parallel_for_each((RoyUSet *)umset, pool, doer, user_data);
+}
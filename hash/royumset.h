@@ -2,7 +2,9 @@
 #define ROYUMSET_H
 
 #include "../util/rpre.h"
+#include "../thread/roythreadpool.h"
 #include "../list/royslist.h"
+#include "../array/royvector.h"
 
 /**
  * RoyUMSet (aka 'Unordered Multi-Set' / 'Hash Multi-Set'): an associative container that contains a set of objects.
@@ -136,6 +138,69 @@ int64_t roy_umset_bucket(const RoyUMSet * umset, const void * key, size_t key_si
  */
 double roy_umset_load_factor(const RoyUMSet * umset);
 
+/* OPERATIONS */
+
+/**
+ * @brief Folds all elements into 'accumulator' sequentially.
+ * @param reducer - a function to fold an element into 'accumulator'.
+ */
+void roy_umset_reduce(const RoyUMSet * umset, void * accumulator, RReducer reducer);
+
+/**
+ * @brief Folds all elements into 'accumulator' on 'pool'.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param accumulator - holds the identity of 'merger' on entry, and the result on return.
+ * @param accumulator_size - the size of 'accumulator' in bytes.
+ * @param reducer - a function to fold an element into a partial accumulator, may be called from several threads at the same time.
+ * @param merger - a function to fold a partial accumulator into 'accumulator'.
+ * @note - 'umset' is split into ranges of buckets, see 'roy_parallel_reduce'.
+ */
+void roy_umset_parallel_reduce(const RoyUMSet * umset, RoyThreadPool * pool, void * accumulator, size_t accumulator_size, RReducer reducer, RMerger merger);
+
+/// @brief Returns the number of elements which meet 'checker'.
+size_t roy_umset_count_if(const RoyUMSet * umset, RChecker checker);
+
+/**
+ * @brief Returns the number of elements which meet 'checker', counted on 'pool'.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param checker - may be called from several threads at the same time.
+ */
+size_t roy_umset_parallel_count_if(const RoyUMSet * umset, RoyThreadPool * pool, RChecker checker);
+
+/**
+ * @brief Appends the elements which meet 'checker' to the back of 'dest', in bucket order.
+ * @param copier - a function to copy an element for 'dest', NULL to share the element itself.
+ * @param user_data - data to cooperate with 'copier'.
+ * @return The number of appended elements.
+ * @note - Shared elements are owned by both containers, make sure only one of the deleters releases them.
+ */
+size_t roy_umset_filter_into(const RoyUMSet * umset, RoyVector * dest, RChecker checker, RMapper copier, void * user_data);
+
+/**
+ * @brief Appends the elements which meet 'checker' to the back of 'dest' on 'pool', in bucket order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param checker - may be called from several threads at the same time.
+ * @param copier - may be called from several threads at the same time, NULL to share the element itself.
+ * @return The number of appended elements.
+ */
+size_t roy_umset_parallel_filter_into(const RoyUMSet * umset, RoyThreadPool * pool, RoyVector * dest, RChecker checker, RMapper copier, void * user_data);
+
+/**
+ * @brief Appends what 'mapper' makes of every element to the back of 'dest', in bucket order.
+ * @param mapper - a function to make a new element for 'dest' out of an element.
+ * @param user_data - data to cooperate with 'mapper'.
+ * @return The number of appended elements.
+ */
+size_t roy_umset_transform_into(const RoyUMSet * umset, RoyVector * dest, RMapper mapper, void * user_data);
+
+/**
+ * @brief Appends what 'mapper' makes of every element to the back of 'dest' on 'pool', in bucket order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param mapper - may be called from several threads at the same time.
+ * @return The number of appended elements.
+ */
+size_t roy_umset_parallel_transform_into(const RoyUMSet * umset, RoyThreadPool * pool, RoyVector * dest, RMapper mapper, void * user_data);
+
 /* TRAVERSE */
 
 /**
@@ -153,4 +218,13 @@ void roy_umset_for_each(RoyUMSet * umset, RDoer oeprate, void * user_data);
  */
 void roy_umset_for_which(RoyUMSet * umset, RChecker checker, RDoer oeprate, void * user_data);
 
+/**
+ * @brief Traverses all elements in 'umset' concurrently on 'pool', in no particular order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param doer - a function for element traversing, must be safe to call from several threads at the same time.
+ * @param user_data - data to cooperate with 'doer'.
+ * @note - 'umset' is split into ranges of buckets.
+ */
+void roy_umset_parallel_for_each(RoyUMSet * umset, RoyThreadPool * pool, RDoer doer, void * user_data);
+
 #endif // ROYUMSET_H
\ No newline at end of file
@@ -1,13 +1,10 @@
 #include "royuset.h"
 #include "../util/rhash.h"
 #include "../math/roymath.h"
+#include "../util/rparallel.h"
+#include "../util/rstats.h"
 #include <math.h>
 
-struct RoySList_ {
-  void             * data;
-  struct RoySList_ * next;
-};
-
 struct RoyUSet_ {
   RoySList  ** buckets;
   uint64_t     seed;
@@ -18,7 +15,16 @@ struct RoyUSet_ {
   size_t       size;
 };
 
+typedef struct {
+  RoyUSet * uset;
+  RDoer     doer;
+  void    * user_data;
+} BucketJob;
+
 static bool valid_bucket_index(const RoyUSet * uset, size_t bucket_index);
+static RoySList * bucket_find(const RoyUSet * uset, RoySList * bucket, const void * data);
+static void bucket_range(size_t begin, size_t end, BucketJob * job);
+static void visit_buckets(const RoyUSet * uset, size_t begin, size_t end, RDoer doer, void * user_data);
 
 RoyUSet *
 roy_uset_new(size_t    bucket_count,
@@ -37,6 +43,7 @@ roy_uset_new(size_t    bucket_count,
   for (size_t i = 0; i != roy_uset_bucket_count(ret); i++) {
     ret->buckets[i] = roy_slist_new();
   }
+  R_STATS_ADD(R_STATS_USET_ALLOCATIONS, 2 + roy_uset_bucket_count(ret));
   return ret;
 }
 
@@ -61,7 +68,7 @@ roy_uset_cpointer(const RoyUSet * uset,
   }
   const RoySList * iter = roy_slist_citerator(uset->buckets[bucket_index],
                                               bucket_position);
-  return iter ? iter->data : NULL;
+  return iter ? roy_slist_data(iter) : NULL;
 }
 
 size_t
@@ -78,14 +85,7 @@ bool
 roy_uset_insert(RoyUSet * restrict uset,
                 void    * restrict data,
                 size_t             data_size) {
-  RoySList ** node = &uset->buckets[roy_uset_bucket(uset, data, data_size)];
-  if (roy_slist_find(*node, data, uset->comparer)) {
-    return false;
-  } else {
-    roy_slist_push_front(*node, data);
-    uset->size++;
-    return true;
-  }
+  return roy_uset_bucket_insert(uset, roy_uset_bucket(uset, data, data_size), data);
 }
 
 bool
@@ -109,24 +109,14 @@ roy_uset_remove(RoyUSet    * uset,
                 const void * key,
                 size_t       key_size,
                 void       * user_data) {
-  RoySList ** node = &uset->buckets[roy_uset_bucket(uset, key, key_size)];
-  size_t remove_count =
-    roy_slist_remove(*node, key, uset->comparer, uset->deleter, user_data);
-  uset->size -= remove_count;
-  return remove_count;
+  return roy_uset_bucket_remove(uset, roy_uset_bucket(uset, key, key_size), key, user_data);
 }
 
 const void *
 roy_uset_find(const RoyUSet * uset,
               const void    * data,
               size_t          data_size) {
-  RoySList ** node = &uset->buckets[roy_uset_bucket(uset, data, data_size)];
-  for (RoySList * iter = roy_slist_begin(*node); iter; iter = iter->next) {
-    if (uset->comparer(data, iter->data) == 0) {
-      return iter->data;
-    }
-  }
-  return NULL;
+  return roy_uset_bucket_find(uset, roy_uset_bucket(uset, data, data_size), data);
 }
 
 void
@@ -156,11 +146,189 @@ roy_uset_bucket(const RoyUSet * uset,
          roy_uset_bucket_count(uset);
 }
 
+bool
+roy_uset_bucket_insert(RoyUSet * restrict uset,
+                       size_t             bucket_index,
+                       void    * restrict data) {
+  RoySList * node = uset->buckets[bucket_index];
+  if (bucket_find(uset, node, data)) {
+    return false;
+  }
+  roy_slist_push_front(node, data);
+  R_STATS_ADD(R_STATS_USET_ALLOCATIONS, 1);
+  uset->size++;
+  return true;
+}
+
+size_t
+roy_uset_bucket_remove(RoyUSet    * uset,
+                       size_t       bucket_index,
+                       const void * data,
+                       void       * user_data) {
+  RoySList * node = uset->buckets[bucket_index];
+  R_STATS_ADD(R_STATS_USET_LOOKUPS, 1);
+  R_STATS_ADD(R_STATS_USET_PROBES, roy_slist_size(node));
+  size_t remove_count =
+    roy_slist_remove(node, data, uset->comparer, uset->deleter, user_data);
+  uset->size -= remove_count;
+  return remove_count;
+}
+
+const void *
+roy_uset_bucket_find(const RoyUSet * uset,
+                     size_t          bucket_index,
+                     const void    * data) {
+  RoySList * iter = bucket_find(uset, uset->buckets[bucket_index], data);
+  return iter ? roy_slist_data(iter) : NULL;
+}
+
 double
 roy_uset_load_factor(const RoyUSet * uset) {
   return (double)roy_uset_size(uset) / (double)roy_uset_bucket_count(uset);
 }
 
+void
+roy_uset_stats(const RoyUSet * uset,
+               RoyUSetStats  * stats) {
+  memset(stats, 0, sizeof(RoyUSetStats));
+  stats->size         = roy_uset_size(uset);
+  stats->bucket_count = roy_uset_bucket_count(uset);
+  stats->load_factor  = roy_uset_load_factor(uset);
+  for (size_t i = 0; i != roy_uset_bucket_count(uset); i++) {
+    size_t length = roy_uset_bucket_size(uset, i);
+    stats->chains[length < ROY_USET_STATS_CHAINS ? length : ROY_USET_STATS_CHAINS - 1]++;
+    if (length > stats->longest_chain) {
+      stats->longest_chain = length;
+    }
+  }
+}
+
+void
+roy_uset_reduce(const RoyUSet * uset,
+                void          * accumulator,
+                RReducer        reducer) {
+  roy_reduce(uset,
+             roy_uset_bucket_count(uset),
+             (RVisitor)visit_buckets,
+             accumulator,
+             reducer);
+}
+
+void
+roy_uset_parallel_reduce(const RoyUSet * uset,
+                         RoyThreadPool * pool,
+                         void          * accumulator,
+                         size_t          accumulator_size,
+                         RReducer        reducer,
+                         RMerger         merger) {
+  roy_parallel_reduce(uset,
+                      roy_uset_bucket_count(uset),
+                      (RVisitor)visit_buckets,
+                      pool,
+                      accumulator,
+                      accumulator_size,
+                      reducer,
+                      merger);
+}
+
+size_t
+roy_uset_count_if(const RoyUSet * uset,
+                  RChecker        checker) {
+  return roy_count_if(uset,
+                      roy_uset_bucket_count(uset),
+                      (RVisitor)visit_buckets,
+                      checker);
+}
+
+size_t
+roy_uset_parallel_count_if(const RoyUSet * uset,
+                           RoyThreadPool * pool,
+                           RChecker        checker) {
+  return roy_parallel_count_if(uset,
+                               roy_uset_bucket_count(uset),
+                               (RVisitor)visit_buckets,
+                               pool,
+                               checker);
+}
+
+size_t
+roy_uset_filter_into(const RoyUSet * uset,
+                     RoyVector     * dest,
+                     RChecker        checker,
+                     RMapper         copier,
+                     void          * user_data) {
+  size_t count;
+  void ** data = roy_collect(uset,
+                             roy_uset_bucket_count(uset),
+                             (RVisitor)visit_buckets,
+                             checker,
+                             copier,
+                             user_data,
+                             &count);
+  roy_vector_append(dest, data, count);
+  free(data);
+  return count;
+}
+
+size_t
+roy_uset_parallel_filter_into(const RoyUSet * uset,
+                              RoyThreadPool * pool,
+                              RoyVector     * dest,
+                              RChecker        checker,
+                              RMapper         copier,
+                              void          * user_data) {
+  size_t count;
+  void ** data = roy_parallel_collect(uset,
+                                      roy_uset_bucket_count(uset),
+                                      (RVisitor)visit_buckets,
+                                      pool,
+                                      checker,
+                                      copier,
+                                      user_data,
+                                      &count);
+  roy_vector_append(dest, data, count);
+  free(data);
+  return count;
+}
+
+size_t
+roy_uset_transform_into(const RoyUSet * uset,
+                        RoyVector     * dest,
+                        RMapper         mapper,
+                        void          * user_data) {
+  size_t count;
+  void ** data = roy_collect(uset,
+                             roy_uset_bucket_count(uset),
+                             (RVisitor)visit_buckets,
+                             NULL,
+                             mapper,
+                             user_data,
+                             &count);
+  roy_vector_append(dest, data, count);
+  free(data);
+  return count;
+}
+
+size_t
+roy_uset_parallel_transform_into(const RoyUSet * uset,
+                                 RoyThreadPool * pool,
+                                 RoyVector     * dest,
+                                 RMapper         mapper,
+                                 void          * user_data) {
+  size_t count;
+  void ** data = roy_parallel_collect(uset,
+                                      roy_uset_bucket_count(uset),
+                                      (RVisitor)visit_buckets,
+                                      pool,
+                                      NULL,
+                                      mapper,
+                                      user_data,
+                                      &count);
+  roy_vector_append(dest, data, count);
+  free(data);
+  return count;
+}
+
 void
 roy_uset_for_each(RoyUSet * uset,
                   RDoer     oeprate,
@@ -184,6 +352,20 @@ roy_uset_for_which(RoyUSet  * uset,
   }
 }
 
+void
+roy_uset_parallel_for_each(RoyUSet       * uset,
+                           RoyThreadPool * pool,
+                           RDoer           doer,
+                           void          * user_data) {
+  BucketJob job = { uset, doer, user_data };
+  roy_thread_pool_for_range(pool,
+                            0,
+                            roy_uset_bucket_count(uset),
+                            0,
+                            (RRangeDoer)bucket_range,
+                            &job);
+}
+
 /* PRIVATE FUNCTIONS */
 
 static bool
@@ -191,3 +373,39 @@ valid_bucket_index(const RoyUSet * uset,
                    size_t          bucket_index) {
   return bucket_index < roy_uset_bucket_count(uset);
 }
+
+// Returns the node of 'bucket' holding an element equal to 'data', counting the elements compared.
+static RoySList *
+bucket_find(const RoyUSet * uset,
+            RoySList      * bucket,
+            const void    * data) {
+  R_STATS_ADD(R_STATS_USET_LOOKUPS, 1);
+  for (RoySList * iter = roy_slist_begin(bucket); iter; iter = roy_slist_next(iter)) {
+    R_STATS_ADD(R_STATS_USET_PROBES, 1);
+    if (uset->comparer(data, roy_slist_data(iter)) == 0) {
+      return iter;
+    }
+  }
+  return NULL;
+}
+
+static void
+bucket_range(size_t      begin,
+             size_t      end,
+             BucketJob * job) {
+  for (size_t i = begin; i != end; i++) {
+    roy_slist_for_each(job->uset->buckets[i], job->doer, job->user_data);
+  }
+}
+
+static void
+visit_buckets(const RoyUSet * uset,
+              size_t          begin,
+              size_t          end,
+              RDoer           doer,
+              void          * user_data) {
+  for (size_t i = begin; i != end; i++) {
+    roy_slist_for_each(uset->buckets[i], doer, user_data);
+  }
+}
+
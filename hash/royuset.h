@@ -2,7 +2,9 @@
 #define ROYUSET_H
 
 #include "../util/rpre.h"
+#include "../thread/roythreadpool.h"
 #include "../list/royslist.h"
+#include "../array/royvector.h"
 
 
 /**
@@ -14,6 +16,18 @@
  */
 typedef struct RoyUSet_ RoyUSet;
 
+enum {
+  ROY_USET_STATS_CHAINS = 8 // the number of chain lengths told apart by RoyUSetStats, longer ones are counted as the last.
+};
+
+typedef struct RoyUSetStats_ {
+  size_t size;
+  size_t bucket_count;
+  double load_factor;
+  size_t longest_chain;
+  size_t chains[ROY_USET_STATS_CHAINS]; // 'chains[i]' buckets hold i elements, 'chains[0]' are empty.
+} RoyUSetStats;
+
 /* CONSTRUCTION & DESTRUCTION */
 
 /**
@@ -134,12 +148,105 @@ size_t roy_uset_bucket_size(const RoyUSet * uset, size_t bucket_index);
  */
 int64_t roy_uset_bucket(const RoyUSet * uset, const void * key, size_t key_size);
 
+/**
+ * @brief Inserts 'data' into the bucket with index 'bucket_index', unless the bucket holds an equivalent element.
+ * @retval true - the insertion is successful.
+ * @retval false - there is an equivalent element already.
+ * @note - For containers built on RoyUSet which hash a part of their elements only, e.g. the key of a RoyUMap pair,
+ *         'bucket_index' must be 'roy_uset_bucket' of that part, or 'data' can not be found again.
+ */
+bool roy_uset_bucket_insert(RoyUSet * restrict uset, size_t bucket_index, void * restrict data);
+
+/**
+ * @brief Removes all the elements equivalent to 'data' from the bucket with index 'bucket_index'.
+ * @param user_data - data to cooperate with 'deleter'.
+ * @return the number of elements removed.
+ */
+size_t roy_uset_bucket_remove(RoyUSet * uset, size_t bucket_index, const void * data, void * user_data);
+
+/**
+ * @brief Finds the element equivalent to 'data' in the bucket with index 'bucket_index'.
+ * @return a const pointer to the element.
+ * @return NULL - the bucket holds no equivalent element.
+ */
+const void * roy_uset_bucket_find(const RoyUSet * uset, size_t bucket_index, const void * data);
+
 /**
  * @brief Returns the average number of elements per buckets,
  * that is, size() divided by bucket_count().
  */
 double roy_uset_load_factor(const RoyUSet * uset);
 
+/**
+ * @brief Reports the size of 'uset' and a histogram of the lengths of its bucket chains into 'stats', in linear time.
+ * @note - A 'longest_chain' far above 'load_factor' means that the hash function clusters the elements of 'uset'.
+ * @note - Elements compared per lookup are counted process-wide when roylib is built with ROY_STATS, see "util/rstats.h".
+ */
+void roy_uset_stats(const RoyUSet * uset, RoyUSetStats * stats);
+
+/* OPERATIONS */
+
+/**
+ * @brief Folds all elements into 'accumulator' sequentially.
+ * @param reducer - a function to fold an element into 'accumulator'.
+ */
+void roy_uset_reduce(const RoyUSet * uset, void * accumulator, RReducer reducer);
+
+/**
+ * @brief Folds all elements into 'accumulator' on 'pool'.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param accumulator - holds the identity of 'merger' on entry, and the result on return.
+ * @param accumulator_size - the size of 'accumulator' in bytes.
+ * @param reducer - a function to fold an element into a partial accumulator, may be called from several threads at the same time.
+ * @param merger - a function to fold a partial accumulator into 'accumulator'.
+ * @note - 'uset' is split into ranges of buckets, see 'roy_parallel_reduce'.
+ */
+void roy_uset_parallel_reduce(const RoyUSet * uset, RoyThreadPool * pool, void * accumulator, size_t accumulator_size, RReducer reducer, RMerger merger);
+
+/// @brief Returns the number of elements which meet 'checker'.
+size_t roy_uset_count_if(const RoyUSet * uset, RChecker checker);
+
+/**
+ * @brief Returns the number of elements which meet 'checker', counted on 'pool'.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param checker - may be called from several threads at the same time.
+ */
+size_t roy_uset_parallel_count_if(const RoyUSet * uset, RoyThreadPool * pool, RChecker checker);
+
+/**
+ * @brief Appends the elements which meet 'checker' to the back of 'dest', in bucket order.
+ * @param copier - a function to copy an element for 'dest', NULL to share the element itself.
+ * @param user_data - data to cooperate with 'copier'.
+ * @return The number of appended elements.
+ * @note - Shared elements are owned by both containers, make sure only one of the deleters releases them.
+ */
+size_t roy_uset_filter_into(const RoyUSet * uset, RoyVector * dest, RChecker checker, RMapper copier, void * user_data);
+
+/**
+ * @brief Appends the elements which meet 'checker' to the back of 'dest' on 'pool', in bucket order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param checker - may be called from several threads at the same time.
+ * @param copier - may be called from several threads at the same time, NULL to share the element itself.
+ * @return The number of appended elements.
+ */
+size_t roy_uset_parallel_filter_into(const RoyUSet * uset, RoyThreadPool * pool, RoyVector * dest, RChecker checker, RMapper copier, void * user_data);
+
+/**
+ * @brief Appends what 'mapper' makes of every element to the back of 'dest', in bucket order.
+ * @param mapper - a function to make a new element for 'dest' out of an element.
+ * @param user_data - data to cooperate with 'mapper'.
+ * @return The number of appended elements.
+ */
+size_t roy_uset_transform_into(const RoyUSet * uset, RoyVector * dest, RMapper mapper, void * user_data);
+
+/**
+ * @brief Appends what 'mapper' makes of every element to the back of 'dest' on 'pool', in bucket order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param mapper - may be called from several threads at the same time.
+ * @return The number of appended elements.
+ */
+size_t roy_uset_parallel_transform_into(const RoyUSet * uset, RoyThreadPool * pool, RoyVector * dest, RMapper mapper, void * user_data);
+
 /* TRAVERSE */
 
 /**
@@ -157,4 +264,13 @@ void roy_uset_for_each(RoyUSet * uset, RDoer oeprate, void * user_data);
  */
 void roy_uset_for_which(RoyUSet * uset, RChecker checker, RDoer doer, void * user_data);
 
+/**
+ * @brief Traverses all elements in 'uset' concurrently on 'pool', in no particular order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param doer - a function for element traversing, must be safe to call from several threads at the same time.
+ * @param user_data - data to cooperate with 'doer'.
+ * @note - 'uset' is split into ranges of buckets.
+ */
+void roy_uset_parallel_for_each(RoyUSet * uset, RoyThreadPool * pool, RDoer doer, void * user_data);
+
 #endif // ROYUSET_H
\ No newline at end of file
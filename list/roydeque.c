@@ -1,77 +1,88 @@
 #include "roydeque.h"
+#include "../util/rsort.h"
+#include "../util/rparallel.h"
 
-struct RoyList_ {
-  void            * data;
-  struct RoyList_ * next;
-  struct RoyList_ * prev;
+enum {
+  BLOCK_CAPACITY    = 0x40,
+  MAP_CAPACITY_BASE = 0x08
 };
 
+// Element i lives in slot (front + i) % BLOCK_CAPACITY of block (front + i) / BLOCK_CAPACITY,
+// only the blocks holding at least one element are allocated.
 struct RoyDeque_ {
-  RoyList * head;
-  RoyList * tail;
-  RDoer     deleter;
+  void  *** map;
+  size_t    map_capacity;
+  size_t    front;
   size_t    size;
+  RDoer     deleter;
 };
 
+typedef struct {
+  const RoyDeque * deque;
+  RDoer            doer;
+  void           * user_data;
+} ForEachJob;
+
+static void ** slot(const RoyDeque * deque, size_t position);
+static void    recenter(RoyDeque * deque);
+static void    drop_front(RoyDeque * deque);
+static void    drop_back(RoyDeque * deque);
+static void    cut_back(RoyDeque * deque, size_t size);
+static void ** gather(const RoyDeque * deque);
+static void    scatter(RoyDeque * deque, void ** data);
+static void    visit_range(const RoyDeque * deque, size_t begin, size_t end, RDoer doer, void * user_data);
+static void    for_each_range(size_t begin, size_t end, ForEachJob * job);
+static size_t  append(RoyDeque * deque, void ** data, size_t count);
+
 RoyDeque *
 roy_deque_new(RDoer deleter) {
-  RoyDeque * ret = malloc(sizeof(RoyDeque));
-  ret->head      = roy_list_new();
-  ret->tail      = ret->head->next;
-  ret->deleter   = deleter;
-  ret->size      = 0;
+  RoyDeque * ret    = malloc(sizeof(RoyDeque));
+  ret->map          = calloc(MAP_CAPACITY_BASE, sizeof(void **));
+  ret->map_capacity = MAP_CAPACITY_BASE;
+  ret->front        = MAP_CAPACITY_BASE / 2 * BLOCK_CAPACITY;
+  ret->size         = 0;
+  ret->deleter      = deleter;
   return ret;
 }
 
 void
 roy_deque_delete(RoyDeque * deque,
                  void     * user_data) {
-  roy_list_delete(deque->head, deque->deleter, user_data);
+  roy_deque_clear(deque, user_data);
+  free(deque->map);
   free(deque);
 }
 
 void *
 roy_deque_pointer(RoyDeque * deque,
                   size_t     position) {
-  RoyList * pnode =
-    (position <= deque->size / 2)            ?
-    roy_list_iterator(deque->head, position) :
-    roy_list_riterator(deque->tail, roy_deque_size(deque) - position - 1);
-  return pnode ? pnode->data : NULL;
+  return position < roy_deque_size(deque) ? *slot(deque, position) : NULL;
 }
 
 const void *
 roy_deque_cpointer(const RoyDeque * deque,
                    size_t           position) {
-  const RoyList * pnode =
-    (position <= deque->size / 2)            ?
-    roy_list_iterator(deque->head, position) :
-    roy_list_riterator(deque->tail, roy_deque_size(deque) - position - 1);
-  return pnode ? pnode->data : NULL;
+  return position < roy_deque_size(deque) ? *slot(deque, position) : NULL;
 }
 
 void *
 roy_deque_front(RoyDeque * deque) {
-  RoyList * pnode = roy_list_begin(deque->head);
-  return pnode ? pnode->data : NULL;
+  return roy_deque_pointer(deque, 0);
 }
 
 const void *
 roy_deque_cfront(const RoyDeque * deque) {
-  const RoyList * pnode = roy_list_cbegin(deque->head);
-  return pnode ? pnode->data : NULL;
+  return roy_deque_cpointer(deque, 0);
 }
 
 void *
 roy_deque_back(RoyDeque * deque) {
-  RoyList * pnode = roy_list_rbegin(deque->tail);
-  return pnode ? pnode->data : NULL;
+  return roy_deque_pointer(deque, roy_deque_size(deque) - 1);
 }
 
 const void *
 roy_deque_cback(const RoyDeque * deque) {
-  const RoyList * pnode = roy_list_crbegin(deque->tail);
-  return pnode ? pnode->data : NULL;
+  return roy_deque_cpointer(deque, roy_deque_size(deque) - 1);
 }
 
 size_t
@@ -86,24 +97,54 @@ roy_deque_empty(const RoyDeque * deque) {
 
 bool
 roy_deque_insert(RoyDeque * restrict deque,
-                 size_t                position,
+                 size_t               position,
                  void     * restrict data) {
-  return (position <= deque->size / 2)                      ?
-         roy_list_insert(deque->head, position, data)       :
-         roy_list_insert_reverse(deque->tail, deque->size - position - 1, data);
+  if (position > roy_deque_size(deque)) {
+    return false;
+  }
+  if (position <= roy_deque_size(deque) / 2) {
+    roy_deque_push_front(deque, data);
+    for (size_t i = 0; i != position; i++) {
+      *slot(deque, i) = *slot(deque, i + 1);
+    }
+  } else {
+    roy_deque_push_back(deque, data);
+    for (size_t i = roy_deque_size(deque) - 1; i != position; i--) {
+      *slot(deque, i) = *slot(deque, i - 1);
+    }
+  }
+  *slot(deque, position) = data;
+  return true;
 }
 
 void
 roy_deque_push_front(RoyDeque * restrict deque,
                      void     * restrict data) {
-  roy_list_push_front(deque->head, data);
+  if (deque->front == 0) {
+    recenter(deque);
+  }
+  deque->front--;
+  void *** block = &deque->map[deque->front / BLOCK_CAPACITY];
+  if (!*block) {
+    *block = calloc(BLOCK_CAPACITY, R_PTR_SIZE);
+  }
+  (*block)[deque->front % BLOCK_CAPACITY] = data;
   deque->size++;
 }
 
 void
 roy_deque_push_back(RoyDeque * restrict deque,
                     void     * restrict data) {
-  roy_list_push_back(deque->tail, data);
+  size_t last = deque->front + roy_deque_size(deque);
+  if (last / BLOCK_CAPACITY >= deque->map_capacity) {
+    recenter(deque);
+    last = deque->front + roy_deque_size(deque);
+  }
+  void *** block = &deque->map[last / BLOCK_CAPACITY];
+  if (!*block) {
+    *block = calloc(BLOCK_CAPACITY, R_PTR_SIZE);
+  }
+  (*block)[last % BLOCK_CAPACITY] = data;
   deque->size++;
 }
 
@@ -111,39 +152,59 @@ bool
 roy_deque_erase(RoyDeque * deque,
                 size_t     position,
                 void     * user_data) {
-  return (position <= deque->size / 2) ?
-         roy_list_erase(deque->head, position, deque->deleter, user_data) :
-         roy_list_erase_reverse(deque->tail,
-                                deque->size - position - 1,
-                                deque->deleter, user_data);
+  if (position >= roy_deque_size(deque)) {
+    return false;
+  }
+  if (deque->deleter) {
+    deque->deleter(*slot(deque, position), user_data);
+  }
+  if (position < roy_deque_size(deque) / 2) {
+    for (size_t i = position; i != 0; i--) {
+      *slot(deque, i) = *slot(deque, i - 1);
+    }
+    drop_front(deque);
+  } else {
+    for (size_t i = position; i + 1 != roy_deque_size(deque); i++) {
+      *slot(deque, i) = *slot(deque, i + 1);
+    }
+    drop_back(deque);
+  }
+  return true;
 }
 
 bool
 roy_deque_pop_front(RoyDeque * deque,
                     void     * user_data) {
-  if (roy_list_pop_front(deque->head, deque->deleter, user_data)) {
-    deque->size--;
-    return true;
+  if (roy_deque_empty(deque)) {
+    return false;
+  }
+  if (deque->deleter) {
+    deque->deleter(*slot(deque, 0), user_data);
   }
-  return false;
+  drop_front(deque);
+  return true;
 }
 
 bool
 roy_deque_pop_back(RoyDeque * deque,
                    void     * user_data) {
-  if (roy_list_pop_back(deque->tail, deque->deleter, user_data)) {
-    deque->size--;
-    return true;
+  if (roy_deque_empty(deque)) {
+    return false;
   }
-  return false;
+  if (deque->deleter) {
+    deque->deleter(*slot(deque, roy_deque_size(deque) - 1), user_data);
+  }
+  drop_back(deque);
+  return true;
 }
 
 void
 roy_deque_clear(RoyDeque * deque,
                 void     * user_data) {
-  while (!roy_deque_empty(deque)) {
-    roy_deque_pop_front(deque, user_data);
+  if (deque->deleter) {
+    roy_deque_for_each(deque, deque->deleter, user_data);
   }
+  cut_back(deque, 0);
 }
 
 size_t
@@ -151,42 +212,216 @@ roy_deque_remove(RoyDeque   * deque,
                  const void * data,
                  RComparer    comparer,
                  void       * user_data) {
-  return
-    roy_list_remove(deque->head, data, comparer, deque->deleter, user_data);
+  size_t count = 0;
+  for (size_t i = 0; i != roy_deque_size(deque); i++) {
+    void * element = *slot(deque, i);
+    if (comparer(element, data) == 0) {
+      if (deque->deleter) {
+        deque->deleter(element, user_data);
+      }
+    } else {
+      *slot(deque, count++) = element;
+    }
+  }
+  size_t ret = roy_deque_size(deque) - count;
+  cut_back(deque, count);
+  return ret;
 }
 
 size_t
 roy_deque_remove_if(RoyDeque * deque,
                     RChecker   checker,
                     void     * user_data) {
-  return roy_list_remove_if(deque->head, checker, deque->deleter, user_data);
+  size_t count = 0;
+  for (size_t i = 0; i != roy_deque_size(deque); i++) {
+    void * element = *slot(deque, i);
+    if (checker(element)) {
+      if (deque->deleter) {
+        deque->deleter(element, user_data);
+      }
+    } else {
+      *slot(deque, count++) = element;
+    }
+  }
+  size_t ret = roy_deque_size(deque) - count;
+  cut_back(deque, count);
+  return ret;
 }
 
 void
 roy_deque_reverse(RoyDeque * deque) {
-  RoyList * phead = deque->head;
-  roy_list_reverse(&deque->head);
-  deque->tail = phead;
+  for (size_t i = 0, j = roy_deque_size(deque); i + 1 < j; i++, j--) {
+    void ** lhs = slot(deque, i);
+    void ** rhs = slot(deque, j - 1);
+    void * temp = *lhs;
+    *lhs = *rhs;
+    *rhs = temp;
+  }
 }
 
 size_t
 roy_deque_unique(RoyDeque  * deque,
                  RComparer   comparer,
                  void      * user_data) {
-  return roy_list_unique(deque->head, comparer, deque->deleter, user_data);
+  if (roy_deque_empty(deque)) {
+    return 0;
+  }
+  size_t count = 1;
+  for (size_t i = 1; i != roy_deque_size(deque); i++) {
+    void * element = *slot(deque, i);
+    if (comparer(*slot(deque, count - 1), element) == 0) {
+      if (deque->deleter) {
+        deque->deleter(element, user_data);
+      }
+    } else {
+      *slot(deque, count++) = element;
+    }
+  }
+  size_t ret = roy_deque_size(deque) - count;
+  cut_back(deque, count);
+  return ret;
 }
 
 void
 roy_deque_sort(RoyDeque  * deque,
                RComparer   comparer) {
-  roy_list_sort(deque->head, comparer);
+  void ** data = gather(deque);
+  roy_sort(data, roy_deque_size(deque), comparer);
+  scatter(deque, data);
+}
+
+void
+roy_deque_parallel_sort(RoyDeque      * deque,
+                        RoyThreadPool * pool,
+                        RComparer       comparer) {
+  void ** data = gather(deque);
+  roy_parallel_sort(data, roy_deque_size(deque), comparer, pool);
+  scatter(deque, data);
+}
+
+void
+roy_deque_reduce(const RoyDeque * deque,
+                 void           * accumulator,
+                 RReducer         reducer) {
+  roy_reduce(deque,
+             roy_deque_size(deque),
+             (RVisitor)visit_range,
+             accumulator,
+             reducer);
+}
+
+void
+roy_deque_parallel_reduce(const RoyDeque * deque,
+                          RoyThreadPool  * pool,
+                          void           * accumulator,
+                          size_t           accumulator_size,
+                          RReducer         reducer,
+                          RMerger          merger) {
+  roy_parallel_reduce(deque,
+                      roy_deque_size(deque),
+                      (RVisitor)visit_range,
+                      pool,
+                      accumulator,
+                      accumulator_size,
+                      reducer,
+                      merger);
+}
+
+size_t
+roy_deque_count_if(const RoyDeque * deque,
+                   RChecker         checker) {
+  return roy_count_if(deque,
+                      roy_deque_size(deque),
+                      (RVisitor)visit_range,
+                      checker);
+}
+
+size_t
+roy_deque_parallel_count_if(const RoyDeque * deque,
+                            RoyThreadPool  * pool,
+                            RChecker         checker) {
+  return roy_parallel_count_if(deque,
+                               roy_deque_size(deque),
+                               (RVisitor)visit_range,
+                               pool,
+                               checker);
+}
+
+size_t
+roy_deque_filter_into(const RoyDeque * deque,
+                      RoyDeque       * dest,
+                      RChecker         checker,
+                      RMapper          copier,
+                      void           * user_data) {
+  size_t count;
+  void ** data = roy_collect(deque,
+                             roy_deque_size(deque),
+                             (RVisitor)visit_range,
+                             checker,
+                             copier,
+                             user_data,
+                             &count);
+  return append(dest, data, count);
+}
+
+size_t
+roy_deque_parallel_filter_into(const RoyDeque * deque,
+                               RoyThreadPool  * pool,
+                               RoyDeque       * dest,
+                               RChecker         checker,
+                               RMapper          copier,
+                               void           * user_data) {
+  size_t count;
+  void ** data = roy_parallel_collect(deque,
+                                      roy_deque_size(deque),
+                                      (RVisitor)visit_range,
+                                      pool,
+                                      checker,
+                                      copier,
+                                      user_data,
+                                      &count);
+  return append(dest, data, count);
+}
+
+size_t
+roy_deque_transform_into(const RoyDeque * deque,
+                         RoyDeque       * dest,
+                         RMapper          mapper,
+                         void           * user_data) {
+  size_t count;
+  void ** data = roy_collect(deque,
+                             roy_deque_size(deque),
+                             (RVisitor)visit_range,
+                             NULL,
+                             mapper,
+                             user_data,
+                             &count);
+  return append(dest, data, count);
+}
+
+size_t
+roy_deque_parallel_transform_into(const RoyDeque * deque,
+                                  RoyThreadPool  * pool,
+                                  RoyDeque       * dest,
+                                  RMapper          mapper,
+                                  void           * user_data) {
+  size_t count;
+  void ** data = roy_parallel_collect(deque,
+                                      roy_deque_size(deque),
+                                      (RVisitor)visit_range,
+                                      pool,
+                                      NULL,
+                                      mapper,
+                                      user_data,
+                                      &count);
+  return append(dest, data, count);
 }
 
 void
 roy_deque_for_each(RoyDeque * deque,
                    RDoer      doer,
                    void     * user_data) {
-  roy_list_for_each(deque->head, doer, user_data);
+  visit_range(deque, 0, roy_deque_size(deque), doer, user_data);
 }
 
 void
@@ -194,5 +429,145 @@ roy_deque_for_which(RoyDeque * deque,
                     RChecker   checker,
                     RDoer      doer,
                     void     * user_data) {
-  roy_list_for_which(deque->head, checker, doer, user_data);
+  for (size_t i = 0; i != roy_deque_size(deque); i++) {
+    void * element = *slot(deque, i);
+    if (checker(element)) {
+      doer(element, user_data);
+    }
+  }
+}
+
+void
+roy_deque_parallel_for_each(RoyDeque      * deque,
+                            RoyThreadPool * pool,
+                            RDoer           doer,
+                            void          * user_data) {
+  ForEachJob job = { deque, doer, user_data };
+  roy_thread_pool_for_range(pool,
+                            0,
+                            roy_deque_size(deque),
+                            0,
+                            (RRangeDoer)for_each_range,
+                            &job);
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+static void **
+slot(const RoyDeque * deque,
+     size_t           position) {
+  size_t index = deque->front + position;
+  return &deque->map[index / BLOCK_CAPACITY][index % BLOCK_CAPACITY];
+}
+
+// Moves the allocated blocks to the middle of a map with a free block at both ends at least.
+static void
+recenter(RoyDeque * deque) {
+  size_t first = deque->front / BLOCK_CAPACITY;
+  size_t used = roy_deque_empty(deque) ?
+                0 : (deque->front + roy_deque_size(deque) - 1) / BLOCK_CAPACITY - first + 1;
+  size_t capacity = deque->map_capacity;
+  while (capacity < (used + 2) * 2) {
+    capacity *= 2;
+  }
+  void *** map = calloc(capacity, sizeof(void **));
+  size_t first_new = (capacity - used) / 2;
+  memcpy(map + first_new, deque->map + first, used * sizeof(void **));
+  free(deque->map);
+  deque->map          = map;
+  deque->map_capacity = capacity;
+  deque->front        = first_new * BLOCK_CAPACITY + deque->front % BLOCK_CAPACITY;
+}
+
+// Forgets the first element, and releases its block once the block is no longer used.
+static void
+drop_front(RoyDeque * deque) {
+  size_t block = deque->front / BLOCK_CAPACITY;
+  deque->front++;
+  deque->size--;
+  if (roy_deque_empty(deque) || deque->front / BLOCK_CAPACITY != block) {
+    free(deque->map[block]);
+    deque->map[block] = NULL;
+  }
+}
+
+// Forgets the last element, and releases its block once the block is no longer used.
+static void
+drop_back(RoyDeque * deque) {
+  size_t block = (deque->front + roy_deque_size(deque) - 1) / BLOCK_CAPACITY;
+  deque->size--;
+  if (roy_deque_empty(deque) ||
+      (deque->front + roy_deque_size(deque) - 1) / BLOCK_CAPACITY != block) {
+    free(deque->map[block]);
+    deque->map[block] = NULL;
+  }
+}
+
+// Forgets every element from 'size' on, without deleting them.
+static void
+cut_back(RoyDeque * deque,
+         size_t     size) {
+  while (roy_deque_size(deque) > size) {
+    drop_back(deque);
+  }
+}
+
+static void **
+gather(const RoyDeque * deque) {
+  size_t count;
+  void ** ret = roy_collect(deque,
+                            roy_deque_size(deque),
+                            (RVisitor)visit_range,
+                            NULL,
+                            NULL,
+                            NULL,
+                            &count);
+  return ret;
+}
+
+// Writes 'data' back over the elements in order, and releases 'data'.
+static void
+scatter(RoyDeque *  deque,
+        void     ** data) {
+  for (size_t i = 0; i != roy_deque_size(deque); i++) {
+    *slot(deque, i) = data[i];
+  }
+  free(data);
+}
+
+static void
+visit_range(const RoyDeque * deque,
+            size_t           begin,
+            size_t           end,
+            RDoer            doer,
+            void           * user_data) {
+  size_t index = deque->front + begin;
+  size_t last = deque->front + end;
+  while (index < last) {
+    void ** block = deque->map[index / BLOCK_CAPACITY];
+    size_t stop = (index / BLOCK_CAPACITY + 1) * BLOCK_CAPACITY;
+    stop = stop < last ? stop : last;
+    for (; index != stop; index++) {
+      doer(block[index % BLOCK_CAPACITY], user_data);
+    }
+  }
+}
+
+static void
+for_each_range(size_t       begin,
+               size_t       end,
+               ForEachJob * job) {
+  visit_range(job->deque, begin, end, job->doer, job->user_data);
+}
+
+// Pushes 'count' elements of 'data' to the back of 'deque', and releases 'data'.
+static size_t
+append(RoyDeque *  deque,
+       void     ** data,
+       size_t      count) {
+  for (size_t i = 0; i != count; i++) {
+    roy_deque_push_back(deque, data[i]);
+  }
+  free(data);
+  return count;
 }
\ No newline at end of file
@@ -1,11 +1,12 @@
 #ifndef ROYDEQUE_H
 #define ROYDEQUE_H
 
-#include "roylist.h"
+#include "../util/rpre.h"
+#include "../thread/roythreadpool.h"
 
 /**
- * @brief RoyDeque: a double ended queue powered by a RoyDeque inside,
- *        which supports fast insertion and removal from both end of the queue.
+ * @brief RoyDeque: a double ended queue whose elements are stored in fixed-size blocks indexed by a central map,
+ *        which supports constant time random access, and constant time insertion and removal at both ends.
  */
 typedef struct RoyDeque_ RoyDeque;
 
@@ -30,18 +31,16 @@ void roy_deque_delete(RoyDeque * deque, void * user_data);
 /* ELEMENT ACCESS */
 
 /**
- * @brief Accesses specified element.
+ * @brief Accesses specified element in constant time.
  * @return a pointer to the element at 'position' in 'deque'.
  * @return NULL - 'position' exceeds.
- * @note - The iteration begins from the front end if 'position' is in smaller half of 'deque', and vise versa.
  */
 void * roy_deque_pointer(RoyDeque * deque, size_t position);
 
 /**
- * @brief Accesses specified element.
+ * @brief Accesses specified element in constant time.
  * @return a const pointer to the element at 'position' in 'deque'.
  * @return NULL - 'position' exceeds or 'deque' is empty.
- * @note - The iteration begins from the front end if 'position' is in smaller half of 'deque', and vise versa.
  */
 const void * roy_deque_cpointer(const RoyDeque * deque, size_t position);
 
@@ -70,10 +69,9 @@ void * roy_deque_back(RoyDeque * deque);
 const void * roy_deque_cback(const RoyDeque * deque);
 
 /**
- * @brief Accesses specified element.
+ * @brief Accesses specified element in constant time.
  * @return a typed pointer to the element at 'position' in 'deque'.
  * @return NULL - 'position' exceeds or 'deque' is empty.
- * @note - The iteration begins from the front end if 'position' is in smaller half of 'deque', and vise versa.
  */
 #define roy_deque_at(deque, position, element_type)  \
         ((element_type *)roy_deque_pointer((deque), (position)))
@@ -98,7 +96,7 @@ bool roy_deque_empty(const RoyDeque * deque);
  * @param data - a pointer to the new element.
  * @retval true - the insertion is successful.
  * @retval false - 'position' exceeds.
- * @note - The iteration begins from the front end if 'position' is in smaller half of 'deque', and vise versa.
+ * @note - The elements between 'position' and the nearer end of 'deque' are moved by one.
  * @note - The behavior is undefined if 'data' is uninitialized.
  */
 bool roy_deque_insert(RoyDeque * restrict deque, size_t position, void * restrict data);
@@ -123,6 +121,7 @@ void roy_deque_push_back(RoyDeque * restrict deque, void * restrict data);
  * @param user_data - data to cooperate with 'deleter'.
  * @retval true - the removal is successful.
  * @retval false - 'position' exceeds or 'deque' is empty.
+ * @note - The elements between 'position' and the nearer end of 'deque' are moved by one.
  * @note - The behavior is undefined if 'deleter' deletes elements in a wrong manner.
  */
 bool roy_deque_erase(RoyDeque * deque, size_t position, void * user_data);
@@ -190,10 +189,79 @@ size_t roy_deque_unique(RoyDeque * deque, RComparer comparer, void * user_data);
 /**
  * @brief Sorts the elements in ascending order.
  * @param comparer - a function to compare two elements, acting like <=> operator in C++.
- * @note - This version uses heap sort strategy powered by RoyMSet.
+ * @note - This version uses a stable merge sort, see 'roy_sort'.
  */
 void roy_deque_sort(RoyDeque * deque, RComparer comparer);
 
+/**
+ * @brief Sorts the elements in ascending order on 'pool'.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param comparer - a function to compare two elements, may be called from several threads at the same time.
+ * @note - The elements are gathered into a contiguous buffer, sorted by 'roy_parallel_sort' and written back in order.
+ */
+void roy_deque_parallel_sort(RoyDeque * deque, RoyThreadPool * pool, RComparer comparer);
+
+/**
+ * @brief Folds all elements into 'accumulator' sequentially.
+ * @param reducer - a function to fold an element into 'accumulator'.
+ */
+void roy_deque_reduce(const RoyDeque * deque, void * accumulator, RReducer reducer);
+
+/**
+ * @brief Folds all elements into 'accumulator' on 'pool'.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param accumulator - holds the identity of 'merger' on entry, and the result on return.
+ * @param accumulator_size - the size of 'accumulator' in bytes.
+ * @param reducer - a function to fold an element into a partial accumulator, may be called from several threads at the same time.
+ * @param merger - a function to fold a partial accumulator into 'accumulator'.
+ * @note - 'deque' is split into ranges of indices, see 'roy_parallel_reduce'.
+ */
+void roy_deque_parallel_reduce(const RoyDeque * deque, RoyThreadPool * pool, void * accumulator, size_t accumulator_size, RReducer reducer, RMerger merger);
+
+/// @brief Returns the number of elements which meet 'checker'.
+size_t roy_deque_count_if(const RoyDeque * deque, RChecker checker);
+
+/**
+ * @brief Returns the number of elements which meet 'checker', counted on 'pool'.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param checker - may be called from several threads at the same time.
+ */
+size_t roy_deque_parallel_count_if(const RoyDeque * deque, RoyThreadPool * pool, RChecker checker);
+
+/**
+ * @brief Appends the elements which meet 'checker' to the back of 'dest', keeping their order.
+ * @param copier - a function to copy an element for 'dest', NULL to share the element itself.
+ * @param user_data - data to cooperate with 'copier'.
+ * @return The number of appended elements.
+ * @note - Shared elements are owned by both deques, make sure only one of the deleters releases them.
+ */
+size_t roy_deque_filter_into(const RoyDeque * deque, RoyDeque * dest, RChecker checker, RMapper copier, void * user_data);
+
+/**
+ * @brief Appends the elements which meet 'checker' to the back of 'dest' on 'pool', keeping their order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param checker - may be called from several threads at the same time.
+ * @param copier - may be called from several threads at the same time, NULL to share the element itself.
+ * @return The number of appended elements.
+ */
+size_t roy_deque_parallel_filter_into(const RoyDeque * deque, RoyThreadPool * pool, RoyDeque * dest, RChecker checker, RMapper copier, void * user_data);
+
+/**
+ * @brief Appends what 'mapper' makes of every element to the back of 'dest', keeping their order.
+ * @param mapper - a function to make a new element for 'dest' out of an element.
+ * @param user_data - data to cooperate with 'mapper'.
+ * @return The number of appended elements.
+ */
+size_t roy_deque_transform_into(const RoyDeque * deque, RoyDeque * dest, RMapper mapper, void * user_data);
+
+/**
+ * @brief Appends what 'mapper' makes of every element to the back of 'dest' on 'pool', keeping their order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param mapper - may be called from several threads at the same time.
+ * @return The number of appended elements.
+ */
+size_t roy_deque_parallel_transform_into(const RoyDeque * deque, RoyThreadPool * pool, RoyDeque * dest, RMapper mapper, void * user_data);
+
 /* TRAVERSE */
 
 /**
@@ -211,4 +279,13 @@ void roy_deque_for_each(RoyDeque * deque, RDoer doer, void * user_data);
  */
 void roy_deque_for_which(RoyDeque * deque, RChecker checker, RDoer doer, void * user_data);
 
+/**
+ * @brief Traverses all elements in 'deque' concurrently on 'pool', in no particular order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param doer - a function for element traversing, must be safe to call from several threads at the same time.
+ * @param user_data - data to cooperate with 'doer'.
+ * @note - 'deque' is split into ranges of indices.
+ */
+void roy_deque_parallel_for_each(RoyDeque * deque, RoyThreadPool * pool, RDoer doer, void * user_data);
+
 #endif // ROYDEQUE_H
\ No newline at end of file
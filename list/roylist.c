@@ -1,5 +1,6 @@
 #include "roylist.h"
 #include "../tree/roymset.h"
+#include "../util/rsort.h"
 
 struct RoyList_ {
   void            * data;
@@ -320,6 +321,24 @@ roy_list_sort(RoyList   * list,
   roy_mset_delete(mset, NULL, NULL);
 }
 
+void
+roy_list_parallel_sort(RoyList       * list,
+                       RoyThreadPool * pool,
+                       RComparer       comparer) {
+  size_t count = roy_list_size(list);
+  void ** data = calloc(count, R_PTR_SIZE);
+  RoyList * iter = roy_list_begin(list);
+  for (size_t i = 0; i != count; i++, iter = iter->next) {
+    data[i] = iter->data;
+  }
+  roy_parallel_sort(data, count, comparer, pool);
+  iter = roy_list_begin(list);
+  for (size_t i = 0; i != count; i++, iter = iter->next) {
+    iter->data = data[i];
+  }
+  free(data);
+}
+
 void
 roy_list_for_each(RoyList * list,
                   RDoer     doer,
@@ -344,6 +363,23 @@ void roy_list_for_which(RoyList  * list,
   } 
 }
 
+void
+roy_list_parallel_for_each(RoyList       * list,
+                           RoyThreadPool * pool,
+                           RDoer           doer,
+                           void          * user_data) {
+  size_t count = roy_list_size(list);
+  void ** data = calloc(count, R_PTR_SIZE);
+  size_t i = 0;
+  for (RoyList * iter = roy_list_begin(list);
+       iter && iter->next;
+       iter = iter->next) {
+    data[i++] = iter->data;
+  }
+  roy_thread_pool_for_each(pool, data, count, doer, user_data);
+  free(data);
+}
+
 /* PRIVATE FUNCTIONS BELOW */
 
 static RoyList *
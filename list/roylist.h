@@ -2,6 +2,7 @@
 #define ROYLIST_H
 
 #include "../util/rpre.h"
+#include "../thread/roythreadpool.h"
 
 /**
  * @brief RoyList: a container implemented as a double-linked list which supports fast insertion and removal
@@ -271,6 +272,14 @@ size_t roy_list_unique(RoyList * list, RComparer comparer, RDoer deleter, void *
  */
 void roy_list_sort(RoyList * list, RComparer comparer);
 
+/**
+ * @brief Sorts the elements in ascending order on 'pool'.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param comparer - a function to compare two elements, may be called from several threads at the same time.
+ * @note - The elements are gathered into a contiguous buffer, sorted by 'roy_parallel_sort' and written back in order.
+ */
+void roy_list_parallel_sort(RoyList * list, RoyThreadPool * pool, RComparer comparer);
+
 /* TRAVERSE */
 
 /**
@@ -288,4 +297,13 @@ void roy_list_for_each(RoyList * list, RDoer doer, void * user_data);
  */
 void roy_list_for_which(RoyList * list, RChecker checker, RDoer doer, void * user_data);
 
+/**
+ * @brief Traverses all elements in 'list' concurrently on 'pool', in no particular order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param doer - a function for element traversing, must be safe to call from several threads at the same time.
+ * @param user_data - data to cooperate with 'doer'.
+ * @note - The elements are gathered into an array by one sequential pass before the concurrent traverse.
+ */
+void roy_list_parallel_for_each(RoyList * list, RoyThreadPool * pool, RDoer doer, void * user_data);
+
 #endif // ROYLIST_H
\ No newline at end of file
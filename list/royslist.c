@@ -35,6 +35,21 @@ roy_slist_cbegin(const RoySList * slist) {
   return slist->next;
 }
 
+RoySList *
+roy_slist_next(RoySList * iter) {
+  return iter->next;
+}
+
+const RoySList *
+roy_slist_cnext(const RoySList * iter) {
+  return iter->next;
+}
+
+void *
+roy_slist_data(const RoySList * iter) {
+  return iter->data;
+}
+
 RoySList *
 roy_slist_iterator(RoySList * slist,
                    size_t     position) {
@@ -229,6 +244,21 @@ void roy_slist_for_which(RoySList * slist,
   } 
 }
 
+void
+roy_slist_parallel_for_each(RoySList      * slist,
+                            RoyThreadPool * pool,
+                            RDoer           doer,
+                            void          * user_data) {
+  size_t count = roy_slist_size(slist);
+  void ** data = calloc(count, R_PTR_SIZE);
+  size_t i = 0;
+  for (RoySList * iter = roy_slist_begin(slist); iter; iter = iter->next) {
+    data[i++] = iter->data;
+  }
+  roy_thread_pool_for_each(pool, data, count, doer, user_data);
+  free(data);
+}
+
 /* PRIVATE FUNCTIONS BELOW */
 
 static RoySList *
@@ -2,6 +2,7 @@
 #define ROYSLIST_H
 
 #include "../util/rpre.h"
+#include "../thread/roythreadpool.h"
 
 /**
  * @brief RoySList: a container implemented as a singly-linked list which supports fast insertion and removal
@@ -55,8 +56,23 @@ RoySList * roy_slist_begin(RoySList * slist);
  */
 const RoySList * roy_slist_cbegin(const RoySList * slist);
 
+/**
+ * @return an iterator to the element following the one 'iter' refers to.
+ * @return NULL - 'iter' refers to the last element.
+ */
+RoySList * roy_slist_next(RoySList * iter);
+
+/**
+ * @return a const iterator to the element following the one 'iter' refers to.
+ * @return NULL - 'iter' refers to the last element.
+ */
+const RoySList * roy_slist_cnext(const RoySList * iter);
+
 /* ELEMENT ACCESS */
 
+/// @brief Returns the element that the iterator 'iter' refers to.
+void * roy_slist_data(const RoySList * iter);
+
 /**
  * @brief Accesses specified element.
  * @return a typed pointer to the element at 'position'.
@@ -184,4 +200,13 @@ void roy_slist_for_each(RoySList * slist, RDoer doer, void * user_data);
  */
 void roy_slist_for_which(RoySList * slist, RChecker checker, RDoer doer, void * user_data);
 
+/**
+ * @brief Traverses all elements in 'slist' concurrently on 'pool', in no particular order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param doer - a function for element traversing, must be safe to call from several threads at the same time.
+ * @param user_data - data to cooperate with 'doer'.
+ * @note - The elements are gathered into an array by one sequential pass before the concurrent traverse.
+ */
+void roy_slist_parallel_for_each(RoySList * slist, RoyThreadPool * pool, RDoer doer, void * user_data);
+
 #endif // ROYSLIST_H
\ No newline at end of file
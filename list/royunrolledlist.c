@@ -0,0 +1,494 @@
+#include "royunrolledlist.h"
+#include "../util/rsort.h"
+
+enum {
+  NODE_CAPACITY = 0x10
+};
+
+typedef struct Node_ {
+  struct Node_ * prev;
+  struct Node_ * next;
+  size_t         count;
+  void         * data[NODE_CAPACITY];
+} Node;
+
+struct RoyUnrolledList_ {
+  Node   * head;
+  Node   * tail;
+  size_t   size;
+  RDoer    deleter;
+};
+
+// Decides which elements 'sift' drops.
+typedef enum {
+  SIEVE_EQUAL,     // equivalent to 'data'
+  SIEVE_CHECKED,   // meets 'checker'
+  SIEVE_DUPLICATE  // equivalent to the last element kept
+} SieveMode;
+
+typedef struct {
+  SieveMode    mode;
+  const void * data;
+  RComparer    comparer;
+  RChecker     checker;
+} Sieve;
+
+typedef struct {
+  Node  ** nodes;
+  RDoer    doer;
+  void   * user_data;
+} NodeJob;
+
+static Node * node_new(void);
+static void   link_after(RoyUnrolledList * list, Node * node, Node * next);
+static void   unlink_node(RoyUnrolledList * list, Node * node);
+static Node * locate(const RoyUnrolledList * list, size_t position, size_t * offset);
+static void   split(RoyUnrolledList * list, Node * node);
+static void   settle(RoyUnrolledList * list, Node * node);
+static bool   drops(const Sieve * sieve, const void * element, const void * last);
+static size_t sift(RoyUnrolledList * list, const Sieve * sieve, void * user_data);
+static void   node_range(size_t begin, size_t end, NodeJob * job);
+
+RoyUnrolledList *
+roy_unrolled_list_new(RDoer deleter) {
+  RoyUnrolledList * ret = malloc(sizeof(RoyUnrolledList));
+  ret->head    = NULL;
+  ret->tail    = NULL;
+  ret->size    = 0;
+  ret->deleter = deleter;
+  return ret;
+}
+
+void
+roy_unrolled_list_delete(RoyUnrolledList * list,
+                         void            * user_data) {
+  roy_unrolled_list_clear(list, user_data);
+  free(list);
+}
+
+void *
+roy_unrolled_list_pointer(RoyUnrolledList * list,
+                          size_t            position) {
+  if (position >= roy_unrolled_list_size(list)) {
+    return NULL;
+  }
+  size_t offset;
+  Node * node = locate(list, position, &offset);
+  return node->data[offset];
+}
+
+const void *
+roy_unrolled_list_cpointer(const RoyUnrolledList * list,
+                           size_t                  position) {
+  if (position >= roy_unrolled_list_size(list)) {
+    return NULL;
+  }
+  size_t offset;
+  const Node * node = locate(list, position, &offset);
+  return node->data[offset];
+}
+
+void *
+roy_unrolled_list_front(RoyUnrolledList * list) {
+  return list->head ? list->head->data[0] : NULL;
+}
+
+void *
+roy_unrolled_list_back(RoyUnrolledList * list) {
+  return list->tail ? list->tail->data[list->tail->count - 1] : NULL;
+}
+
+size_t
+roy_unrolled_list_size(const RoyUnrolledList * list) {
+  return list->size;
+}
+
+bool
+roy_unrolled_list_empty(const RoyUnrolledList * list) {
+  return roy_unrolled_list_size(list) == 0;
+}
+
+bool
+roy_unrolled_list_insert(RoyUnrolledList * restrict list,
+                         size_t                     position,
+                         void            * restrict data) {
+  if (position > roy_unrolled_list_size(list)) {
+    return false;
+  }
+  if (position == roy_unrolled_list_size(list)) {
+    roy_unrolled_list_push_back(list, data);
+    return true;
+  }
+  size_t offset;
+  Node * node = locate(list, position, &offset);
+  if (node->count == NODE_CAPACITY) {
+    split(list, node);
+    if (offset > node->count) {
+      offset -= node->count;
+      node = node->next;
+    }
+  }
+  memmove(node->data + offset + 1,
+          node->data + offset,
+          (node->count - offset) * R_PTR_SIZE);
+  node->data[offset] = data;
+  node->count++;
+  list->size++;
+  return true;
+}
+
+void
+roy_unrolled_list_push_front(RoyUnrolledList * restrict list,
+                             void            * restrict data) {
+  if (!list->head || list->head->count == NODE_CAPACITY) {
+    link_after(list, NULL, node_new());
+  }
+  Node * node = list->head;
+  memmove(node->data + 1, node->data, node->count * R_PTR_SIZE);
+  node->data[0] = data;
+  node->count++;
+  list->size++;
+}
+
+void
+roy_unrolled_list_push_back(RoyUnrolledList * restrict list,
+                            void            * restrict data) {
+  if (!list->tail || list->tail->count == NODE_CAPACITY) {
+    link_after(list, list->tail, node_new());
+  }
+  list->tail->data[list->tail->count++] = data;
+  list->size++;
+}
+
+bool
+roy_unrolled_list_erase(RoyUnrolledList * list,
+                        size_t            position,
+                        void            * user_data) {
+  if (position >= roy_unrolled_list_size(list)) {
+    return false;
+  }
+  size_t offset;
+  Node * node = locate(list, position, &offset);
+  if (list->deleter) {
+    list->deleter(node->data[offset], user_data);
+  }
+  memmove(node->data + offset,
+          node->data + offset + 1,
+          (node->count - offset - 1) * R_PTR_SIZE);
+  node->count--;
+  list->size--;
+  settle(list, node);
+  return true;
+}
+
+bool
+roy_unrolled_list_pop_front(RoyUnrolledList * list,
+                            void            * user_data) {
+  return roy_unrolled_list_erase(list, 0, user_data);
+}
+
+bool
+roy_unrolled_list_pop_back(RoyUnrolledList * list,
+                           void            * user_data) {
+  return roy_unrolled_list_erase(list,
+                                 roy_unrolled_list_size(list) - 1,
+                                 user_data);
+}
+
+void
+roy_unrolled_list_clear(RoyUnrolledList * list,
+                        void            * user_data) {
+  if (list->deleter) {
+    roy_unrolled_list_for_each(list, list->deleter, user_data);
+  }
+  while (list->head) {
+    unlink_node(list, list->head);
+  }
+  list->size = 0;
+}
+
+size_t
+roy_unrolled_list_remove(RoyUnrolledList * list,
+                         const void      * data,
+                         RComparer         comparer,
+                         void            * user_data) {
+  Sieve sieve = { SIEVE_EQUAL, data, comparer, NULL };
+  return sift(list, &sieve, user_data);
+}
+
+size_t
+roy_unrolled_list_remove_if(RoyUnrolledList * list,
+                            RChecker          checker,
+                            void            * user_data) {
+  Sieve sieve = { SIEVE_CHECKED, NULL, NULL, checker };
+  return sift(list, &sieve, user_data);
+}
+
+void
+roy_unrolled_list_reverse(RoyUnrolledList * list) {
+  if (roy_unrolled_list_empty(list)) {
+    return;
+  }
+  Node * lhs = list->head;
+  Node * rhs = list->tail;
+  size_t lhs_offset = 0;
+  size_t rhs_offset = rhs->count - 1;
+  for (size_t i = 0, j = roy_unrolled_list_size(list) - 1; i < j; i++, j--) {
+    void * temp = lhs->data[lhs_offset];
+    lhs->data[lhs_offset] = rhs->data[rhs_offset];
+    rhs->data[rhs_offset] = temp;
+    if (++lhs_offset == lhs->count) {
+      lhs = lhs->next;
+      lhs_offset = 0;
+    }
+    if (rhs_offset-- == 0 && rhs->prev) {
+      rhs = rhs->prev;
+      rhs_offset = rhs->count - 1;
+    }
+  }
+}
+
+size_t
+roy_unrolled_list_unique(RoyUnrolledList * list,
+                         RComparer         comparer,
+                         void            * user_data) {
+  Sieve sieve = { SIEVE_DUPLICATE, NULL, comparer, NULL };
+  return sift(list, &sieve, user_data);
+}
+
+void
+roy_unrolled_list_sort(RoyUnrolledList * list,
+                       RComparer         comparer) {
+  void ** data = calloc(roy_unrolled_list_size(list), R_PTR_SIZE);
+  size_t count = 0;
+  for (Node * node = list->head; node; node = node->next) {
+    memcpy(data + count, node->data, node->count * R_PTR_SIZE);
+    count += node->count;
+  }
+  roy_sort(data, count, comparer);
+  count = 0;
+  for (Node * node = list->head; node; node = node->next) {
+    memcpy(node->data, data + count, node->count * R_PTR_SIZE);
+    count += node->count;
+  }
+  free(data);
+}
+
+void
+roy_unrolled_list_for_each(RoyUnrolledList * list,
+                           RDoer             doer,
+                           void            * user_data) {
+  for (Node * node = list->head; node; node = node->next) {
+    for (size_t i = 0; i != node->count; i++) {
+      doer(node->data[i], user_data);
+    }
+  }
+}
+
+void
+roy_unrolled_list_for_which(RoyUnrolledList * list,
+                            RChecker          checker,
+                            RDoer             doer,
+                            void            * user_data) {
+  for (Node * node = list->head; node; node = node->next) {
+    for (size_t i = 0; i != node->count; i++) {
+      if (checker(node->data[i])) {
+        doer(node->data[i], user_data);
+      }
+    }
+  }
+}
+
+void
+roy_unrolled_list_parallel_for_each(RoyUnrolledList * list,
+                                    RoyThreadPool   * pool,
+                                    RDoer             doer,
+                                    void            * user_data) {
+  size_t count = 0;
+  for (Node * node = list->head; node; node = node->next) {
+    count++;
+  }
+  NodeJob job = { calloc(count, sizeof(Node *)), doer, user_data };
+  count = 0;
+  for (Node * node = list->head; node; node = node->next) {
+    job.nodes[count++] = node;
+  }
+  roy_thread_pool_for_range(pool, 0, count, 0, (RRangeDoer)node_range, &job);
+  free(job.nodes);
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+static Node *
+node_new(void) {
+  Node * ret = malloc(sizeof(Node));
+  ret->prev  = NULL;
+  ret->next  = NULL;
+  ret->count = 0;
+  return ret;
+}
+
+// Links 'next' right after 'node', or at the beginning of 'list' if 'node' is NULL.
+static void
+link_after(RoyUnrolledList * list,
+           Node            * node,
+           Node            * next) {
+  next->prev = node;
+  next->next = node ? node->next : list->head;
+  if (next->next) {
+    next->next->prev = next;
+  } else {
+    list->tail = next;
+  }
+  if (node) {
+    node->next = next;
+  } else {
+    list->head = next;
+  }
+}
+
+static void
+unlink_node(RoyUnrolledList * list,
+            Node            * node) {
+  if (node->prev) {
+    node->prev->next = node->next;
+  } else {
+    list->head = node->next;
+  }
+  if (node->next) {
+    node->next->prev = node->prev;
+  } else {
+    list->tail = node->prev;
+  }
+  free(node);
+}
+
+// Returns the node holding element 'position', 'offset' receives its index in the node.
+static Node *
+locate(const RoyUnrolledList * list,
+       size_t                  position,
+       size_t                * offset) {
+  Node * node;
+  if (position < roy_unrolled_list_size(list) / 2) {
+    node = list->head;
+    while (position >= node->count) {
+      position -= node->count;
+      node = node->next;
+    }
+  } else {
+    size_t rest = roy_unrolled_list_size(list) - position;
+    node = list->tail;
+    while (rest > node->count) {
+      rest -= node->count;
+      node = node->prev;
+    }
+    position = node->count - rest;
+  }
+  *offset = position;
+  return node;
+}
+
+// Moves the upper half of 'node' into a new node right after it.
+static void
+split(RoyUnrolledList * list,
+      Node            * node) {
+  Node * next = node_new();
+  next->count = node->count - node->count / 2;
+  node->count /= 2;
+  memcpy(next->data, node->data + node->count, next->count * R_PTR_SIZE);
+  link_after(list, node, next);
+}
+
+// Releases 'node' once it is empty, or merges it with a neighbor once it is sparse.
+static void
+settle(RoyUnrolledList * list,
+       Node            * node) {
+  if (node->count == 0) {
+    unlink_node(list, node);
+    return;
+  }
+  if (node->count >= NODE_CAPACITY / 4) {
+    return;
+  }
+  if (node->next && node->count + node->next->count <= NODE_CAPACITY) {
+    Node * next = node->next;
+    memcpy(node->data + node->count, next->data, next->count * R_PTR_SIZE);
+    node->count += next->count;
+    unlink_node(list, next);
+  } else if (node->prev && node->prev->count + node->count <= NODE_CAPACITY) {
+    Node * prev = node->prev;
+    memcpy(prev->data + prev->count, node->data, node->count * R_PTR_SIZE);
+    prev->count += node->count;
+    unlink_node(list, node);
+  }
+}
+
+static bool
+drops(const Sieve * sieve,
+      const void  * element,
+      const void  * last) {
+  switch (sieve->mode) {
+  case SIEVE_EQUAL:
+    return sieve->comparer(element, sieve->data) == 0;
+  case SIEVE_CHECKED:
+    return sieve->checker(element);
+  case SIEVE_DUPLICATE:
+    return last && sieve->comparer(last, element) == 0;
+  }
+  return false;
+}
+
+// Deletes the elements 'sieve' drops and packs the rest into full nodes, returns the number deleted.
+// The writing cursor never passes the reading one, so the elements are moved in place.
+static size_t
+sift(RoyUnrolledList * list,
+     const Sieve     * sieve,
+     void            * user_data) {
+  Node * writer = list->head;
+  size_t written = 0;
+  size_t kept = 0;
+  const void * last = NULL;
+  for (Node * node = list->head; node; node = node->next) {
+    for (size_t i = 0; i != node->count; i++) {
+      void * element = node->data[i];
+      if (drops(sieve, element, last)) {
+        if (list->deleter) {
+          list->deleter(element, user_data);
+        }
+        continue;
+      }
+      if (written == NODE_CAPACITY) {
+        writer->count = NODE_CAPACITY;
+        writer = writer->next;
+        written = 0;
+      }
+      writer->data[written++] = element;
+      last = element;
+      kept++;
+    }
+  }
+  size_t ret = roy_unrolled_list_size(list) - kept;
+  list->size = kept;
+  if (kept == 0) {
+    while (list->head) {
+      unlink_node(list, list->head);
+    }
+    return ret;
+  }
+  writer->count = written;
+  while (writer->next) {
+    unlink_node(list, writer->next);
+  }
+  return ret;
+}
+
+static void
+node_range(size_t    begin,
+           size_t    end,
+           NodeJob * job) {
+  for (size_t i = begin; i != end; i++) {
+    for (size_t j = 0; j != job->nodes[i]->count; j++) {
+      job->doer(job->nodes[i]->data[j], job->user_data);
+    }
+  }
+}
\ No newline at end of file
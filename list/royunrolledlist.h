@@ -0,0 +1,200 @@
+#ifndef ROYUNROLLEDLIST_H
+#define ROYUNROLLEDLIST_H
+
+#include "../util/rpre.h"
+#include "../thread/roythreadpool.h"
+
+/**
+ * @brief RoyUnrolledList: a double-linked list whose every node holds a small array of elements,
+ *        which keeps the fast insertion and removal of RoyList, but costs far less memory per element
+ *        and traverses mostly contiguous memory.
+ */
+typedef struct RoyUnrolledList_ RoyUnrolledList;
+
+/* CONSTRUCTION AND DESTRUCTION */
+
+/**
+ * @brief Creates an empty RoyUnrolledList.
+ * @param deleter - a function for element deleting, NULL if the elements are not owned by the list.
+ * @return The newly build RoyUnrolledList.
+ */
+RoyUnrolledList * roy_unrolled_list_new(RDoer deleter);
+
+/**
+ * @brief Releases all the elements and destroys the RoyUnrolledList - 'list' itself.
+ * @param user_data - data to cooperate with 'deleter'.
+ * @note - Always call this function after the work is done by the given 'list' to get rid of memory leaking.
+ * @note - The behavior is undefined if 'deleter' deletes elements in a wrong manner.
+ */
+void roy_unrolled_list_delete(RoyUnrolledList * list, void * user_data);
+
+/* ELEMENT ACCESS */
+
+/**
+ * @brief Accesses specified element.
+ * @return a pointer to the element at 'position' in 'list'.
+ * @return NULL - 'position' exceeds.
+ * @note - The iteration skips whole nodes, and begins from the nearer end of 'list'.
+ */
+void * roy_unrolled_list_pointer(RoyUnrolledList * list, size_t position);
+
+/**
+ * @brief Accesses specified element.
+ * @return a const pointer to the element at 'position' in 'list'.
+ * @return NULL - 'position' exceeds.
+ * @note - The iteration skips whole nodes, and begins from the nearer end of 'list'.
+ */
+const void * roy_unrolled_list_cpointer(const RoyUnrolledList * list, size_t position);
+
+/**
+ * @return a pointer to the first element in 'list'.
+ * @return NULL - 'list' is empty.
+ */
+void * roy_unrolled_list_front(RoyUnrolledList * list);
+
+/**
+ * @return a pointer to the last element in 'list'.
+ * @return NULL - 'list' is empty.
+ */
+void * roy_unrolled_list_back(RoyUnrolledList * list);
+
+/**
+ * @brief Accesses specified element.
+ * @return a typed pointer to the element at 'position' in 'list'.
+ * @return NULL - 'position' exceeds.
+ */
+#define roy_unrolled_list_at(list, position, element_type) \
+        ((element_type *)roy_unrolled_list_pointer((list), (position)))
+
+/* CAPACITY */
+
+/// @brief Returns the number of elements in 'list'.
+size_t roy_unrolled_list_size(const RoyUnrolledList * list);
+
+/**
+ * @brief Checks whether 'list' is empty.
+ * @retval true - there is no element in 'list'.
+ * @retval false - otherwise.
+ */
+bool roy_unrolled_list_empty(const RoyUnrolledList * list);
+
+/* MODIFIERS */
+
+/**
+ * @brief Inserts an element into 'list'.
+ * @param position - where the new element should be exactly settled.
+ * @param data - a pointer to the new element.
+ * @retval true - the insertion is successful.
+ * @retval false - 'position' exceeds.
+ * @note - A full node is split into two half-full nodes first.
+ */
+bool roy_unrolled_list_insert(RoyUnrolledList * restrict list, size_t position, void * restrict data);
+
+/// @brief Adds an element at the beginning of 'list'.
+void roy_unrolled_list_push_front(RoyUnrolledList * restrict list, void * restrict data);
+
+/// @brief Adds an element at the end of 'list'.
+void roy_unrolled_list_push_back(RoyUnrolledList * restrict list, void * restrict data);
+
+/**
+ * @brief Removes specified element from 'list'.
+ * @param position - where the element should be removed.
+ * @param user_data - data to cooperate with 'deleter'.
+ * @retval true - the removal is successful.
+ * @retval false - 'position' exceeds.
+ * @note - A node which becomes sparse is merged with its successor whenever they fit into one node.
+ * @note - The behavior is undefined if 'deleter' deletes elements in a wrong manner.
+ */
+bool roy_unrolled_list_erase(RoyUnrolledList * list, size_t position, void * user_data);
+
+/**
+ * @brief Removes the first element from 'list'.
+ * @param user_data - data to cooperate with 'deleter'.
+ * @retval true - the removal is successful.
+ * @retval false - 'list' is empty.
+ */
+bool roy_unrolled_list_pop_front(RoyUnrolledList * list, void * user_data);
+
+/**
+ * @brief Removes the last element from 'list'.
+ * @param user_data - data to cooperate with 'deleter'.
+ * @retval true - the removal is successful.
+ * @retval false - 'list' is empty.
+ */
+bool roy_unrolled_list_pop_back(RoyUnrolledList * list, void * user_data);
+
+/**
+ * @brief Removes all the elements from 'list'.
+ * @param user_data - data to cooperate with 'deleter'.
+ * @note - The behavior is undefined if 'deleter' deletes elements in a wrong manner.
+ */
+void roy_unrolled_list_clear(RoyUnrolledList * list, void * user_data);
+
+/* LIST OPERATIONS */
+
+/**
+ * @brief Removes all elements equivalent to 'data'.
+ * @param data - a pointer to the comparable element.
+ * @param comparer - a function to compare two elements, returns 0 if current element is equal to the given 'data'.
+ * @param user_data - data to cooperate with 'deleter'.
+ * @return the number of elements being removed from 'list'.
+ * @note - The survivors are packed into full nodes by one pass.
+ */
+size_t roy_unrolled_list_remove(RoyUnrolledList * list, const void * data, RComparer comparer, void * user_data);
+
+/**
+ * @brief Removes all elements meet 'checker'.
+ * @param checker - a function to check whether the given element meet the checker.
+ * @param user_data - data to cooperate with 'deleter'.
+ * @return the number of elements being removed from 'list'.
+ * @note - The survivors are packed into full nodes by one pass.
+ */
+size_t roy_unrolled_list_remove_if(RoyUnrolledList * list, RChecker checker, void * user_data);
+
+/// @brief Reverses the order of the elements in 'list'.
+void roy_unrolled_list_reverse(RoyUnrolledList * list);
+
+/**
+ * @brief Removes all consecutive duplicate elements from 'list',
+ *        only the first element in each group of equal elements is left.
+ * @param comparer - a function to compare two elements, returns 0 if they are equal.
+ * @param user_data - data to cooperate with 'deleter'.
+ * @return the number of elements being removed from 'list'.
+ * @note - The survivors are packed into full nodes by one pass.
+ */
+size_t roy_unrolled_list_unique(RoyUnrolledList * list, RComparer comparer, void * user_data);
+
+/**
+ * @brief Sorts the elements in ascending order.
+ * @param comparer - a function to compare two elements, acting like <=> operator in C++.
+ * @note - This version uses a stable merge sort, see 'roy_sort'.
+ */
+void roy_unrolled_list_sort(RoyUnrolledList * list, RComparer comparer);
+
+/* TRAVERSE */
+
+/**
+ * @brief Traverses all elements in 'list' sequentially.
+ * @param doer - a function for element traversing.
+ * @param user_data - data to cooperate with 'doer'.
+ */
+void roy_unrolled_list_for_each(RoyUnrolledList * list, RDoer doer, void * user_data);
+
+/**
+ * @brief Traverses elements whichever meets 'checker' in 'list'.
+ * @param checker - a function to check whether the given element meet the checker.
+ * @param doer - a function for element traversing.
+ * @param user_data - data to cooperate with 'doer'.
+ */
+void roy_unrolled_list_for_which(RoyUnrolledList * list, RChecker checker, RDoer doer, void * user_data);
+
+/**
+ * @brief Traverses all elements in 'list' concurrently on 'pool', in no particular order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param doer - a function for element traversing, must be safe to call from several threads at the same time.
+ * @param user_data - data to cooperate with 'doer'.
+ * @note - The node arrays are gathered by one sequential pass, then split into ranges of nodes.
+ */
+void roy_unrolled_list_parallel_for_each(RoyUnrolledList * list, RoyThreadPool * pool, RDoer doer, void * user_data);
+
+#endif // ROYUNROLLEDLIST_H
@@ -1,5 +1,9 @@
 #include "roybit.h"
 
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
 uint64_t
 roy_uint_set_bits(uint64_t * dest,
                   uint64_t   src,
@@ -38,10 +42,33 @@ roy_uint_rol(uint64_t * number,
 
 size_t
 roy_uint_count_bit(uint64_t number) {
-  size_t count = 0;
+  return __builtin_popcountll(number);
+}
+
+size_t
+roy_uint_count_trailing_zeros(uint64_t number) {
+  return number != 0 ? (size_t)__builtin_ctzll(number) : 64;
+}
+
+size_t
+roy_uint_count_leading_zeros(uint64_t number) {
+  return number != 0 ? (size_t)__builtin_clzll(number) : 64;
+}
+
+size_t
+roy_uint_select_bit(uint64_t number,
+                    size_t   rank) {
+  if (rank >= roy_uint_count_bit(number)) {
+    return 64;
+  }
+#ifdef __BMI2__
+  // Deposits a single '1' onto the 'rank'-th '1' of 'number'.
+  return __builtin_ctzll(_pdep_u64(1ULL << rank, number));
+#else
   // 'n & n - 1' deletes the rightmost '1' of n.
-  for (; number != 0; number &= number - 1) {
-    count++;
+  for (; rank != 0; rank--) {
+    number &= number - 1;
   }
-  return count;
+  return __builtin_ctzll(number);
+#endif
 }
@@ -34,7 +34,20 @@ uint64_t roy_uint_ror(uint64_t * number, size_t steps, size_t width);
  */
 uint64_t roy_uint_rol(uint64_t * number, size_t steps, size_t width);
 
-/// @brief Counts '1' bits in unsigned integer 'number'.
+/// @brief Counts '1' bits in unsigned integer 'number', by the popcnt instruction if the target has one.
 size_t roy_uint_count_bit(uint64_t number);
 
+/// @brief Counts '0' bits below the lowest '1' bit in unsigned integer 'number', 64 if 'number' is 0.
+size_t roy_uint_count_trailing_zeros(uint64_t number);
+
+/// @brief Counts '0' bits above the highest '1' bit in unsigned integer 'number', 64 if 'number' is 0.
+size_t roy_uint_count_leading_zeros(uint64_t number);
+
+/**
+ * @brief Finds the 'rank'-th '1' bit in unsigned integer 'number', counting from 0 at the lowest bit.
+ * @return the position of the bit found.
+ * @return 64 - 'number' has no more than 'rank' '1' bits.
+ */
+size_t roy_uint_select_bit(uint64_t number, size_t rank);
+
 #endif // ROYBIT_H
\ No newline at end of file
@@ -0,0 +1,492 @@
+#include "roybitset.h"
+#include "roybit.h"
+#include <pthread.h>
+
+// AVX2 kernels are compiled with a target attribute, and chosen at run time if the processor supports them.
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define ROY_BITSET_X86
+#endif
+
+enum {
+  WORD_BITS     = 64,
+  BLOCK_WORDS   =  8,
+  BLOCK_BITS    = WORD_BITS * BLOCK_WORDS,
+  SELECT_SAMPLE = 0x400
+};
+
+typedef enum Combination_ {
+  COMBINE_AND,
+  COMBINE_OR,
+  COMBINE_XOR,
+  COMBINE_ANDNOT
+} Combination;
+
+typedef struct Kernels_ {
+  size_t (* count)     (const uint64_t * words, size_t count);
+  size_t (* count_and) (const uint64_t * lhs, const uint64_t * rhs, size_t count);
+  void   (* combine)   (uint64_t * dest, const uint64_t * src, size_t count, Combination combination);
+} Kernels;
+
+struct RoyBitset_ {
+  uint64_t * words;
+  size_t     size;
+  size_t     word_count;
+  uint64_t * ranks;       // 'ranks[i]' is the number of '1' bits in the first 'i' blocks.
+  size_t   * samples;     // 'samples[i]' is the block of the 'i * SELECT_SAMPLE'-th '1' bit.
+  size_t     sample_count;
+  bool       ranks_valid;
+};
+
+static Kernels        kernels;
+static pthread_once_t kernels_once = PTHREAD_ONCE_INIT;
+
+static const Kernels * local_kernels(void);
+static void choose_kernels(void);
+static bool combine(RoyBitset * dest, const RoyBitset * other, Combination combination);
+static void mask_tail(RoyBitset * bitset);
+static void build_ranks(RoyBitset * bitset);
+static size_t count_scalar(const uint64_t * words, size_t count);
+static size_t count_and_scalar(const uint64_t * lhs, const uint64_t * rhs, size_t count);
+static void combine_scalar(uint64_t * dest, const uint64_t * src, size_t count, Combination combination);
+#ifdef ROY_BITSET_X86
+static size_t count_popcnt(const uint64_t * words, size_t count);
+static size_t count_and_popcnt(const uint64_t * lhs, const uint64_t * rhs, size_t count);
+static __m256i count_block_avx2(__m256i block);
+static size_t count_avx2(const uint64_t * words, size_t count);
+static size_t count_and_avx2(const uint64_t * lhs, const uint64_t * rhs, size_t count);
+static void combine_avx2(uint64_t * dest, const uint64_t * src, size_t count, Combination combination);
+#endif
+
+RoyBitset *
+roy_bitset_new(size_t size) {
+  RoyBitset * ret = malloc(sizeof(RoyBitset));
+  ret->size         = size;
+  ret->word_count   = (size + WORD_BITS - 1) / WORD_BITS;
+  // A spare word keeps the allocation non-empty for a bitset of no bits.
+  ret->words        = calloc(ret->word_count + 1, sizeof(uint64_t));
+  ret->ranks        = NULL;
+  ret->samples      = NULL;
+  ret->sample_count = 0;
+  ret->ranks_valid  = false;
+  return ret;
+}
+
+RoyBitset *
+roy_bitset_copy(const RoyBitset * other) {
+  RoyBitset * ret = roy_bitset_new(other->size);
+  memcpy(ret->words, other->words, other->word_count * sizeof(uint64_t));
+  return ret;
+}
+
+void
+roy_bitset_delete(RoyBitset                    * bitset,
+                  __attribute__((unused)) void * user_data) {
+  free(bitset->samples);
+  free(bitset->ranks);
+  free(bitset->words);
+  free(bitset);
+}
+
+bool
+roy_bitset_test(const RoyBitset * bitset,
+                size_t            position) {
+  return position < bitset->size &&
+         (bitset->words[position / WORD_BITS] >> (position % WORD_BITS) & 1);
+}
+
+const uint64_t *
+roy_bitset_words(const RoyBitset * bitset) {
+  return bitset->words;
+}
+
+size_t
+roy_bitset_size(const RoyBitset * bitset) {
+  return bitset->size;
+}
+
+size_t
+roy_bitset_count(const RoyBitset * bitset) {
+  return local_kernels()->count(bitset->words, bitset->word_count);
+}
+
+bool
+roy_bitset_set(RoyBitset * bitset,
+               size_t      position) {
+  if (position >= bitset->size) {
+    return false;
+  }
+  bitset->words[position / WORD_BITS] |= 1ULL << (position % WORD_BITS);
+  bitset->ranks_valid = false;
+  return true;
+}
+
+bool
+roy_bitset_reset(RoyBitset * bitset,
+                 size_t      position) {
+  if (position >= bitset->size) {
+    return false;
+  }
+  bitset->words[position / WORD_BITS] &= ~(1ULL << (position % WORD_BITS));
+  bitset->ranks_valid = false;
+  return true;
+}
+
+bool
+roy_bitset_flip(RoyBitset * bitset,
+                size_t      position) {
+  if (position >= bitset->size) {
+    return false;
+  }
+  bitset->words[position / WORD_BITS] ^= 1ULL << (position % WORD_BITS);
+  bitset->ranks_valid = false;
+  return true;
+}
+
+bool
+roy_bitset_set_range(RoyBitset * bitset,
+                     size_t      position,
+                     size_t      count,
+                     bool        value) {
+  if (position > bitset->size || count > bitset->size - position) {
+    return false;
+  }
+  if (count == 0) {
+    return true;
+  }
+  size_t first = position / WORD_BITS, last = (position + count - 1) / WORD_BITS;
+  uint64_t first_mask = ~0ULL << (position % WORD_BITS);
+  uint64_t last_mask  = ~0ULL >> (WORD_BITS - 1 - (position + count - 1) % WORD_BITS);
+  if (first == last) {
+    first_mask &= last_mask;
+  }
+  uint64_t * words = bitset->words;
+  words[first] = value ? words[first] | first_mask : words[first] & ~first_mask;
+  if (first != last) {
+    memset(words + first + 1, value ? 0xFF : 0x00, (last - first - 1) * sizeof(uint64_t));
+    words[last] = value ? words[last] | last_mask : words[last] & ~last_mask;
+  }
+  bitset->ranks_valid = false;
+  return true;
+}
+
+void
+roy_bitset_set_all(RoyBitset * bitset) {
+  memset(bitset->words, 0xFF, bitset->word_count * sizeof(uint64_t));
+  mask_tail(bitset);
+}
+
+void
+roy_bitset_reset_all(RoyBitset * bitset) {
+  memset(bitset->words, 0x00, bitset->word_count * sizeof(uint64_t));
+  bitset->ranks_valid = false;
+}
+
+void
+roy_bitset_flip_all(RoyBitset * bitset) {
+  for (size_t i = 0; i != bitset->word_count; i++) {
+    bitset->words[i] = ~bitset->words[i];
+  }
+  mask_tail(bitset);
+}
+
+bool
+roy_bitset_and(RoyBitset       * dest,
+               const RoyBitset * other) {
+  return combine(dest, other, COMBINE_AND);
+}
+
+bool
+roy_bitset_or(RoyBitset       * dest,
+              const RoyBitset * other) {
+  return combine(dest, other, COMBINE_OR);
+}
+
+bool
+roy_bitset_xor(RoyBitset       * dest,
+               const RoyBitset * other) {
+  return combine(dest, other, COMBINE_XOR);
+}
+
+bool
+roy_bitset_andnot(RoyBitset       * dest,
+                  const RoyBitset * other) {
+  return combine(dest, other, COMBINE_ANDNOT);
+}
+
+size_t
+roy_bitset_count_and(const RoyBitset * lhs,
+                     const RoyBitset * rhs) {
+  size_t count = lhs->word_count < rhs->word_count ? lhs->word_count : rhs->word_count;
+  return local_kernels()->count_and(lhs->words, rhs->words, count);
+}
+
+size_t
+roy_bitset_find_next(const RoyBitset * bitset,
+                     size_t            position) {
+  if (position >= bitset->size) {
+    return bitset->size;
+  }
+  size_t index = position / WORD_BITS;
+  uint64_t word = bitset->words[index] & ~0ULL << (position % WORD_BITS);
+  while (word == 0) {
+    if (++index == bitset->word_count) {
+      return bitset->size;
+    }
+    word = bitset->words[index];
+  }
+  return index * WORD_BITS + roy_uint_count_trailing_zeros(word);
+}
+
+size_t
+roy_bitset_rank(RoyBitset * bitset,
+                size_t      position) {
+  if (position > bitset->size) {
+    position = bitset->size;
+  }
+  build_ranks(bitset);
+  size_t block = position / BLOCK_BITS, index = position / WORD_BITS;
+  size_t ret = bitset->ranks[block] +
+               local_kernels()->count(bitset->words + block * BLOCK_WORDS, index - block * BLOCK_WORDS);
+  if (position % WORD_BITS != 0) {
+    ret += roy_uint_count_bit(bitset->words[index] & ~(~0ULL << (position % WORD_BITS)));
+  }
+  return ret;
+}
+
+size_t
+roy_bitset_select(RoyBitset * bitset,
+                  size_t      rank) {
+  build_ranks(bitset);
+  size_t block_count = (bitset->word_count + BLOCK_WORDS - 1) / BLOCK_WORDS;
+  if (rank >= bitset->ranks[block_count]) {
+    return bitset->size;
+  }
+  // Finds the last block preceded by no more than 'rank' '1' bits, between the two nearest samples.
+  size_t sample = rank / SELECT_SAMPLE;
+  size_t low  = bitset->samples[sample];
+  size_t high = sample + 1 < bitset->sample_count ? bitset->samples[sample + 1] + 1 : block_count;
+  while (high - low > 1) {
+    size_t middle = low + (high - low) / 2;
+    if (bitset->ranks[middle] <= rank) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+  rank -= bitset->ranks[low];
+  size_t index = low * BLOCK_WORDS;
+  for (size_t count; (count = roy_uint_count_bit(bitset->words[index])) <= rank; index++) {
+    rank -= count;
+  }
+  return index * WORD_BITS + roy_uint_select_bit(bitset->words[index], rank);
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+static const Kernels *
+local_kernels(void) {
+  pthread_once(&kernels_once, choose_kernels);
+  return &kernels;
+}
+
+static void
+choose_kernels(void) {
+  Kernels scalar = { count_scalar, count_and_scalar, combine_scalar };
+  kernels = scalar;
+#ifdef ROY_BITSET_X86
+  if (__builtin_cpu_supports("popcnt")) {
+    Kernels popcnt = { count_popcnt, count_and_popcnt, combine_scalar };
+    kernels = popcnt;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    Kernels avx2 = { count_avx2, count_and_avx2, combine_avx2 };
+    kernels = avx2;
+  }
+#endif
+}
+
+static bool
+combine(RoyBitset       * dest,
+        const RoyBitset * other,
+        Combination       combination) {
+  if (dest->size != other->size) {
+    return false;
+  }
+  local_kernels()->combine(dest->words, other->words, dest->word_count, combination);
+  dest->ranks_valid = false;
+  return true;
+}
+
+// Clears the bits beyond the size in the last word.
+static void
+mask_tail(RoyBitset * bitset) {
+  if (bitset->size % WORD_BITS != 0) {
+    bitset->words[bitset->word_count - 1] &= ~(~0ULL << (bitset->size % WORD_BITS));
+  }
+  bitset->ranks_valid = false;
+}
+
+static void
+build_ranks(RoyBitset * bitset) {
+  if (bitset->ranks_valid) {
+    return;
+  }
+  size_t block_count = (bitset->word_count + BLOCK_WORDS - 1) / BLOCK_WORDS;
+  if (bitset->ranks == NULL) {
+    bitset->ranks = malloc((block_count + 1) * sizeof(uint64_t));
+  }
+  const Kernels * local = local_kernels();
+  bitset->ranks[0] = 0;
+  for (size_t i = 0; i != block_count; i++) {
+    size_t begin = i * BLOCK_WORDS;
+    size_t count = bitset->word_count - begin < BLOCK_WORDS ? bitset->word_count - begin : BLOCK_WORDS;
+    bitset->ranks[i + 1] = bitset->ranks[i] + local->count(bitset->words + begin, count);
+  }
+  // One sample per SELECT_SAMPLE '1' bits that exist, no slot is left unwritten when they are an exact multiple.
+  size_t total = bitset->ranks[block_count];
+  bitset->sample_count = total != 0 ? (total + SELECT_SAMPLE - 1) / SELECT_SAMPLE : 1;
+  bitset->samples      = realloc(bitset->samples, bitset->sample_count * sizeof(size_t));
+  bitset->samples[0]   = 0;
+  for (size_t i = 0, sample = 1; i != block_count; i++) {
+    for (; sample != bitset->sample_count && sample * SELECT_SAMPLE < bitset->ranks[i + 1]; sample++) {
+      bitset->samples[sample] = i;
+    }
+  }
+  bitset->ranks_valid = true;
+}
+
+static size_t
+count_scalar(const uint64_t * words,
+             size_t           count) {
+  size_t ret = 0;
+  for (size_t i = 0; i != count; i++) {
+    ret += __builtin_popcountll(words[i]);
+  }
+  return ret;
+}
+
+static size_t
+count_and_scalar(const uint64_t * lhs,
+                 const uint64_t * rhs,
+                 size_t           count) {
+  size_t ret = 0;
+  for (size_t i = 0; i != count; i++) {
+    ret += __builtin_popcountll(lhs[i] & rhs[i]);
+  }
+  return ret;
+}
+
+static void
+combine_scalar(uint64_t       * dest,
+               const uint64_t * src,
+               size_t           count,
+               Combination      combination) {
+  switch (combination) {
+    case COMBINE_AND:
+      for (size_t i = 0; i != count; i++) { dest[i] &= src[i]; }
+      break;
+    case COMBINE_OR:
+      for (size_t i = 0; i != count; i++) { dest[i] |= src[i]; }
+      break;
+    case COMBINE_XOR:
+      for (size_t i = 0; i != count; i++) { dest[i] ^= src[i]; }
+      break;
+    case COMBINE_ANDNOT:
+      for (size_t i = 0; i != count; i++) { dest[i] &= ~src[i]; }
+      break;
+  }
+}
+
+#ifdef ROY_BITSET_X86
+
+// The same loops as the scalar ones, but '__builtin_popcountll' becomes one instruction.
+__attribute__((target("popcnt")))
+static size_t
+count_popcnt(const uint64_t * words,
+             size_t           count) {
+  size_t ret = 0;
+  for (size_t i = 0; i != count; i++) {
+    ret += __builtin_popcountll(words[i]);
+  }
+  return ret;
+}
+
+__attribute__((target("popcnt")))
+static size_t
+count_and_popcnt(const uint64_t * lhs,
+                 const uint64_t * rhs,
+                 size_t           count) {
+  size_t ret = 0;
+  for (size_t i = 0; i != count; i++) {
+    ret += __builtin_popcountll(lhs[i] & rhs[i]);
+  }
+  return ret;
+}
+
+// Counts the bits of every nibble by a table lookup in register, then sums the bytes up per 64-bit lane.
+__attribute__((target("avx2")))
+static __m256i
+count_block_avx2(__m256i block) {
+  const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i nibble = _mm256_set1_epi8(0x0F);
+  __m256i low  = _mm256_shuffle_epi8(table, _mm256_and_si256(block, nibble));
+  __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble));
+  return _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2")))
+static size_t
+count_avx2(const uint64_t * words,
+           size_t           count) {
+  __m256i sums = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    sums = _mm256_add_epi64(sums, count_block_avx2(_mm256_loadu_si256((const __m256i *)(words + i))));
+  }
+  uint64_t lanes[4];
+  _mm256_storeu_si256((__m256i *)lanes, sums);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3] + count_popcnt(words + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static size_t
+count_and_avx2(const uint64_t * lhs,
+               const uint64_t * rhs,
+               size_t           count) {
+  __m256i sums = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256i block = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(lhs + i)),
+                                     _mm256_loadu_si256((const __m256i *)(rhs + i)));
+    sums = _mm256_add_epi64(sums, count_block_avx2(block));
+  }
+  uint64_t lanes[4];
+  _mm256_storeu_si256((__m256i *)lanes, sums);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3] + count_and_popcnt(lhs + i, rhs + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void
+combine_avx2(uint64_t       * dest,
+             const uint64_t * src,
+             size_t           count,
+             Combination      combination) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256i lhs = _mm256_loadu_si256((const __m256i *)(dest + i));
+    __m256i rhs = _mm256_loadu_si256((const __m256i *)(src + i));
+    __m256i result;
+    switch (combination) {
+      case COMBINE_AND:    result = _mm256_and_si256(lhs, rhs);    break;
+      case COMBINE_OR:     result = _mm256_or_si256(lhs, rhs);     break;
+      case COMBINE_XOR:    result = _mm256_xor_si256(lhs, rhs);    break;
+      default:             result = _mm256_andnot_si256(rhs, lhs); break;
+    }
+    _mm256_storeu_si256((__m256i *)(dest + i), result);
+  }
+  combine_scalar(dest + i, src + i, count - i, combination);
+}
+
+#endif // ROY_BITSET_X86
@@ -0,0 +1,148 @@
+#ifndef ROYBITSET_H
+#define ROYBITSET_H
+
+#include "../util/rpre.h"
+
+/**
+ * @brief RoyBitset: a fixed-size sequence of bits stored in 64-bit words, whose bulk operations run
+ *        on whole words (or 256-bit vectors if the processor supports AVX2), with rank and select support.
+ * @note - Rank and select build an index of at most 3/16 the size of the bits on first use, which any modification invalidates.
+ */
+typedef struct RoyBitset_ RoyBitset;
+
+/* CONSTRUCTION AND DESTRUCTION */
+
+/// @brief Creates a RoyBitset of 'size' bits, all of them '0'.
+RoyBitset * roy_bitset_new(size_t size);
+
+/// @brief Creates a RoyBitset with the bits of another RoyBitset.
+RoyBitset * roy_bitset_copy(const RoyBitset * other);
+
+/**
+ * @brief Releases the words and destroys the RoyBitset - 'bitset' itself.
+ * @note - Always call this function after the work is done by the given 'bitset' to get rid of memory leaking.
+ */
+void roy_bitset_delete(RoyBitset * bitset, void * user_data);
+
+/* ELEMENT ACCESS */
+
+/**
+ * @brief Accesses the specified bit.
+ * @return the bit at 'position'.
+ * @return false - 'position' exceeds.
+ */
+bool roy_bitset_test(const RoyBitset * bitset, size_t position);
+
+/**
+ * @brief Accesses the underlying words, bit 'i' is bit 'i % 64' of word 'i / 64'.
+ * @note - The bits beyond 'roy_bitset_size' in the last word are always '0'.
+ */
+const uint64_t * roy_bitset_words(const RoyBitset * bitset);
+
+/* CAPACITY */
+
+/// @brief Returns the number of bits in 'bitset'.
+size_t roy_bitset_size(const RoyBitset * bitset);
+
+/// @brief Returns the number of '1' bits in 'bitset'.
+size_t roy_bitset_count(const RoyBitset * bitset);
+
+/* MODIFIERS */
+
+/**
+ * @brief Sets the bit at 'position' to '1'.
+ * @retval true - the operation is successful.
+ * @retval false - 'position' exceeds.
+ */
+bool roy_bitset_set(RoyBitset * bitset, size_t position);
+
+/**
+ * @brief Sets the bit at 'position' to '0'.
+ * @retval true - the operation is successful.
+ * @retval false - 'position' exceeds.
+ */
+bool roy_bitset_reset(RoyBitset * bitset, size_t position);
+
+/**
+ * @brief Inverts the bit at 'position'.
+ * @retval true - the operation is successful.
+ * @retval false - 'position' exceeds.
+ */
+bool roy_bitset_flip(RoyBitset * bitset, size_t position);
+
+/**
+ * @brief Sets the bits in [position, position + count) to 'value', a whole word at a time.
+ * @retval true - the operation is successful.
+ * @retval false - 'position' or 'position' + 'count' exceeds.
+ */
+bool roy_bitset_set_range(RoyBitset * bitset, size_t position, size_t count, bool value);
+
+/// @brief Sets all bits of 'bitset' to '1'.
+void roy_bitset_set_all(RoyBitset * bitset);
+
+/// @brief Sets all bits of 'bitset' to '0'.
+void roy_bitset_reset_all(RoyBitset * bitset);
+
+/// @brief Inverts all bits of 'bitset'.
+void roy_bitset_flip_all(RoyBitset * bitset);
+
+/* OPERATIONS */
+
+/**
+ * @brief Sets 'dest' to 'dest' AND 'other'.
+ * @retval true - the operation is successful.
+ * @retval false - the sizes of 'dest' and 'other' differ.
+ * @note 'dest' and 'other' can be identical.
+ */
+bool roy_bitset_and(RoyBitset * dest, const RoyBitset * other);
+
+/**
+ * @brief Sets 'dest' to 'dest' OR 'other'.
+ * @retval true - the operation is successful.
+ * @retval false - the sizes of 'dest' and 'other' differ.
+ * @note 'dest' and 'other' can be identical.
+ */
+bool roy_bitset_or(RoyBitset * dest, const RoyBitset * other);
+
+/**
+ * @brief Sets 'dest' to 'dest' XOR 'other'.
+ * @retval true - the operation is successful.
+ * @retval false - the sizes of 'dest' and 'other' differ.
+ * @note 'dest' and 'other' can be identical.
+ */
+bool roy_bitset_xor(RoyBitset * dest, const RoyBitset * other);
+
+/**
+ * @brief Sets 'dest' to 'dest' AND NOT 'other', which removes the '1' bits of 'other' from 'dest'.
+ * @retval true - the operation is successful.
+ * @retval false - the sizes of 'dest' and 'other' differ.
+ * @note 'dest' and 'other' can be identical.
+ */
+bool roy_bitset_andnot(RoyBitset * dest, const RoyBitset * other);
+
+/// @brief Counts the '1' bits of 'lhs' AND 'rhs' without building it, bits beyond the shorter one are ignored.
+size_t roy_bitset_count_and(const RoyBitset * lhs, const RoyBitset * rhs);
+
+/* LOOKUPS */
+
+/**
+ * @brief Finds the first '1' bit at or after 'position', skipping a whole word of '0's at a time.
+ * @return the position of the bit found.
+ * @return the size of 'bitset' - no such bit exists.
+ */
+size_t roy_bitset_find_next(const RoyBitset * bitset, size_t position);
+
+/**
+ * @brief Counts the '1' bits in [0, position) in constant time.
+ * @note - 'position' larger than the size of 'bitset' counts all bits.
+ */
+size_t roy_bitset_rank(RoyBitset * bitset, size_t position);
+
+/**
+ * @brief Finds the 'rank'-th '1' bit, counting from 0, by a binary search between sampled positions.
+ * @return the position of the bit found.
+ * @return the size of 'bitset' - 'bitset' has no more than 'rank' '1' bits.
+ */
+size_t roy_bitset_select(RoyBitset * bitset, size_t rank);
+
+#endif // ROYBITSET_H
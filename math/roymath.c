@@ -1,5 +1,5 @@
 #include "roymath.h"
-#include <time.h>
+#include "royrng.h"
 
 bool
 roy_uint_prime(uint64_t number) {
@@ -24,11 +24,11 @@ roy_uint_prime_next(uint64_t number) {
 
 void
 roy_random_new(void) {
-  srand((unsigned)time(NULL));
+  roy_rng_seed(roy_rng_thread(), roy_rng_entropy());
 }
 
 uint64_t
 roy_random_next(uint64_t min,
                 uint64_t max) {
-  return rand() % max + min;
+  return roy_rng_range(roy_rng_thread(), min, max);
 }
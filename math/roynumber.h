@@ -3,6 +3,10 @@
 
 #include "../util/rpre.h"
 
+enum {
+  ROY_DOUBLE_STR_CAPACITY = 0x20
+};
+
 /**
  * @brief Converts 'str' of binary digits into its equivalent unsigned value.
  * @note - The parsing phase ends immediately when 'str' turned to be ill-formed.
@@ -18,21 +22,42 @@ uint64_t roy_parse_oct(const char * str);
 /**
  * @brief Converts 'str' of hexadecimal digits into its equivalent unsigned value.
  * @note - The parsing phase ends immediately when 'str' turned to be ill-formed.
+ * @note - Digits are parsed 8 at a time.
  */ 
 uint64_t roy_parse_hex(const char * str);
 
 /**
  * @brief Converts 'str' of digits into its equivalent value.
  * @note - The parsing phase ends immediately when 'str' turned to be ill-formed.
+ * @note - Digits are parsed 8 at a time.
  */ 
 int64_t roy_parse_int(const char * str);
 
 /**
- * @brief Converts 'str' of floating point number into its equivalent value.
+ * @brief Converts 'str' of floating point number into its nearest double value, correctly rounded.
  * @note - The parsing phase ends immediately when 'str' turned to be ill-formed.
+ * @note - Numbers of more than 19 significant digits may be passed to 'strtod', which expects a '.' as the decimal point.
  */ 
 double roy_parse_double(const char * str);
 
+/**
+ * @brief Parses a column of integers from the first 'length' characters of 'str', one in each field split by 'separator'.
+ * @param dest - receives the numbers, each field is parsed like 'roy_parse_int', the rest of the field is ignored.
+ * @param capacity - the maximum number of fields to parse.
+ * @return the number of fields parsed, a trailing 'separator' does not start a new field.
+ * @note - 'str' needs no terminating '\0', which makes this much faster than 'roy_parse_int' on each field of a large buffer.
+ */
+size_t roy_parse_int_column(int64_t * dest, size_t capacity, const char * str, size_t length, char separator);
+
+/**
+ * @brief Parses a column of floating point numbers from the first 'length' characters of 'str', one in each field split by 'separator'.
+ * @param dest - receives the numbers, each field is parsed like 'roy_parse_double', the rest of the field is ignored.
+ * @param capacity - the maximum number of fields to parse.
+ * @return the number of fields parsed, a trailing 'separator' does not start a new field.
+ * @note - 'str' needs no terminating '\0', which makes this much faster than 'roy_parse_double' on each field of a large buffer.
+ */
+size_t roy_parse_double_column(double * dest, size_t capacity, const char * str, size_t length, char separator);
+
 /**
  * @brief Converts the integer 'number' into a 'width'-width, 'base' character representation in the string 'dest'.
  * @param dest - a pointer to the result string to write to.
@@ -40,6 +65,7 @@ double roy_parse_double(const char * str);
  * @param width - the minimal length of result string.
  * @param fill_zero - whether to fill blanks in 'dest' with '0' if the actual string is shorter than 'width'.
  * @note - The behavior is undefined if 'dest' or 'width' is insufficient, or 'base' is larger than 36 ([0-9a-z]).
+ * @note - A '-' goes before the filled '0's, and after the filled blanks.
  */
 char * roy_int_to_str(char * dest, int64_t number, size_t base, size_t width, bool fill_zero);
 
@@ -54,4 +80,12 @@ char * roy_int_to_str(char * dest, int64_t number, size_t base, size_t width, bo
  */
 char * roy_uint_to_str(char * dest, uint64_t number, size_t base, size_t width, bool fill_zero);
 
+/**
+ * @brief Converts 'number' into a short decimal string which reads back as the same double, in the string 'dest'.
+ * @param dest - a pointer to the result string to write to, holds at least ROY_DOUBLE_STR_CAPACITY characters.
+ * @note - The layout follows '%.17g', eg. "0.1", "1e+17", "-2.5e-05", "inf", "nan".
+ * @note - The digits are generated by Grisu2, which are the shortest for almost all doubles.
+ */
+char * roy_double_to_str(char * dest, double number);
+
 #endif // ROYNUMBER_H
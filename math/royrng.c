@@ -0,0 +1,281 @@
+#include "royrng.h"
+#include <time.h>
+
+typedef unsigned __int128 uint128_t;
+
+struct RoyRng_ {
+  RoyRngKind kind;
+  union {
+    uint64_t xoshiro[4];
+    struct {
+      uint128_t state;
+      uint128_t increment; // always odd, selects one of 2^127 streams.
+    } pcg;
+  };
+};
+
+static _Thread_local RoyRng thread_rng;
+static _Thread_local bool   thread_rng_seeded = false;
+
+static inline uint64_t next(RoyRng * rng);
+static inline uint64_t xoshiro_next(uint64_t * state);
+static inline uint64_t pcg_next(RoyRng * rng);
+static inline uint64_t rotl(uint64_t number, int steps);
+static inline uint64_t bounded(RoyRng * rng, uint64_t bound, uint64_t threshold);
+static inline uint128_t pcg_multiplier(void);
+static uint128_t lcg_advance(uint128_t state, uint128_t delta, uint128_t multiplier, uint128_t increment);
+
+RoyRng *
+roy_rng_new(RoyRngKind kind,
+            uint64_t   seed) {
+  RoyRng * ret = malloc(sizeof(RoyRng));
+  ret->kind = kind;
+  roy_rng_seed(ret, seed);
+  return ret;
+}
+
+RoyRng *
+roy_rng_copy(const RoyRng * other) {
+  return memcpy(malloc(sizeof(RoyRng)), other, sizeof(RoyRng));
+}
+
+RoyRng *
+roy_rng_split(RoyRng * rng) {
+  RoyRng * ret = roy_rng_copy(rng);
+  roy_rng_jump(rng);
+  return ret;
+}
+
+void
+roy_rng_delete(RoyRng                       * rng,
+               __attribute__((unused)) void * user_data) {
+  free(rng);
+}
+
+RoyRng *
+roy_rng_thread(void) {
+  if (!thread_rng_seeded) {
+    thread_rng.kind = ROY_RNG_XOSHIRO;
+    roy_rng_seed(&thread_rng, roy_rng_entropy());
+    thread_rng_seeded = true;
+  }
+  return &thread_rng;
+}
+
+uint64_t
+roy_rng_entropy(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  // The address of 'thread_rng' tells threads apart, the clock tells calls apart.
+  uint64_t state = (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+  state ^= roy_splitmix64(&state) ^ (uint64_t)(uintptr_t)&thread_rng;
+  return roy_splitmix64(&state);
+}
+
+uint64_t
+roy_splitmix64(uint64_t * state) {
+  uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+void
+roy_rng_seed(RoyRng * rng,
+             uint64_t seed) {
+  if (rng->kind == ROY_RNG_XOSHIRO) {
+    // splitmix64 never gives four zeros in a row, which would be the only invalid state.
+    for (size_t i = 0; i != 4; i++) {
+      rng->xoshiro[i] = roy_splitmix64(&seed);
+    }
+  } else {
+    uint128_t state     = (uint128_t)roy_splitmix64(&seed) << 64 | roy_splitmix64(&seed);
+    uint128_t increment = (uint128_t)roy_splitmix64(&seed) << 64 | roy_splitmix64(&seed);
+    // The initialization of the reference 'pcg_setseq_128_srandom_r'.
+    rng->pcg.state     = 0;
+    rng->pcg.increment = increment << 1 | 1;
+    pcg_next(rng);
+    rng->pcg.state    += state;
+    pcg_next(rng);
+  }
+}
+
+void
+roy_rng_jump(RoyRng * rng) {
+  if (rng->kind == ROY_RNG_XOSHIRO) {
+    // The characteristic polynomial of 2^128 steps, from the reference 'jump'.
+    static const uint64_t JUMP[] = { 0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+                                     0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL };
+    uint64_t state[4] = { 0, 0, 0, 0 };
+    for (size_t i = 0; i != 4; i++) {
+      for (int bit = 0; bit != 64; bit++) {
+        if (JUMP[i] >> bit & 1) {
+          for (size_t j = 0; j != 4; j++) {
+            state[j] ^= rng->xoshiro[j];
+          }
+        }
+        xoshiro_next(rng->xoshiro);
+      }
+    }
+    memcpy(rng->xoshiro, state, sizeof(state));
+  } else {
+    rng->pcg.state = lcg_advance(rng->pcg.state, (uint128_t)1 << 64, pcg_multiplier(), rng->pcg.increment);
+  }
+}
+
+uint64_t
+roy_rng_next(RoyRng * rng) {
+  return next(rng);
+}
+
+uint64_t
+roy_rng_bounded(RoyRng * rng,
+                uint64_t bound) {
+  if (bound == 0) {
+    return 0;
+  }
+  uint128_t product = (uint128_t)next(rng) * bound;
+  if ((uint64_t)product < bound) {
+    // Only now is the division worth it: 'threshold' = 2^64 % 'bound', the count of biased low products.
+    uint64_t threshold = -bound % bound;
+    while ((uint64_t)product < threshold) {
+      product = (uint128_t)next(rng) * bound;
+    }
+  }
+  return (uint64_t)(product >> 64);
+}
+
+uint64_t
+roy_rng_range(RoyRng * rng,
+              uint64_t min,
+              uint64_t max) {
+  return max > min ? min + roy_rng_bounded(rng, max - min) : min;
+}
+
+double
+roy_rng_double(RoyRng * rng) {
+  return (double)(next(rng) >> 11) * 0x1.0p-53;
+}
+
+void
+roy_rng_fill(RoyRng   * restrict rng,
+             uint64_t * restrict dest,
+             size_t              count) {
+  if (rng->kind == ROY_RNG_XOSHIRO) {
+    for (size_t i = 0; i != count; i++) {
+      dest[i] = xoshiro_next(rng->xoshiro);
+    }
+  } else {
+    for (size_t i = 0; i != count; i++) {
+      dest[i] = pcg_next(rng);
+    }
+  }
+}
+
+void
+roy_rng_fill_bytes(RoyRng * restrict rng,
+                   void   * restrict dest,
+                   size_t            size) {
+  unsigned char * bytes = dest;
+  for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), bytes += sizeof(uint64_t)) {
+    uint64_t number = next(rng);
+    memcpy(bytes, &number, sizeof(uint64_t));
+  }
+  if (size != 0) {
+    uint64_t number = next(rng);
+    memcpy(bytes, &number, size);
+  }
+}
+
+void
+roy_rng_fill_bounded(RoyRng   * restrict rng,
+                     uint64_t * restrict dest,
+                     size_t              count,
+                     uint64_t            bound) {
+  if (bound == 0) {
+    memset(dest, 0, count * sizeof(uint64_t));
+    return;
+  }
+  uint64_t threshold = -bound % bound;
+  for (size_t i = 0; i != count; i++) {
+    dest[i] = bounded(rng, bound, threshold);
+  }
+}
+
+void
+roy_rng_fill_double(RoyRng * restrict rng,
+                    double * restrict dest,
+                    size_t            count) {
+  for (size_t i = 0; i != count; i++) {
+    dest[i] = (double)(next(rng) >> 11) * 0x1.0p-53;
+  }
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+static inline uint64_t
+next(RoyRng * rng) {
+  return rng->kind == ROY_RNG_XOSHIRO ? xoshiro_next(rng->xoshiro) : pcg_next(rng);
+}
+
+static inline uint64_t
+xoshiro_next(uint64_t * state) {
+  uint64_t ret = rotl(state[1] * 5, 7) * 9;
+  uint64_t t   = state[1] << 17;
+  state[2] ^= state[0];
+  state[3] ^= state[1];
+  state[1] ^= state[2];
+  state[0] ^= state[3];
+  state[2] ^= t;
+  state[3]  = rotl(state[3], 45);
+  return ret;
+}
+
+static inline uint64_t
+pcg_next(RoyRng * rng) {
+  rng->pcg.state = rng->pcg.state * pcg_multiplier() + rng->pcg.increment;
+  uint64_t value = (uint64_t)(rng->pcg.state >> 64) ^ (uint64_t)rng->pcg.state;
+  int steps = (int)(rng->pcg.state >> 122);
+  return value >> steps | value << (-steps & 63);
+}
+
+static inline uint64_t
+rotl(uint64_t number,
+     int      steps) {
+  return number << steps | number >> (64 - steps);
+}
+
+// Lemire's method with the threshold computed in advance.
+static inline uint64_t
+bounded(RoyRng * rng,
+        uint64_t bound,
+        uint64_t threshold) {
+  uint128_t product;
+  do {
+    product = (uint128_t)next(rng) * bound;
+  } while ((uint64_t)product < threshold);
+  return (uint64_t)(product >> 64);
+}
+
+static inline uint128_t
+pcg_multiplier(void) {
+  return (uint128_t)0x2360ED051FC65DA4ULL << 64 | 0x4385DF649FCCF645ULL;
+}
+
+// Applies 'state' = 'state' * 'multiplier' + 'increment' 'delta' times, in O(log 'delta') steps (Brown, 1994).
+static uint128_t
+lcg_advance(uint128_t state,
+            uint128_t delta,
+            uint128_t multiplier,
+            uint128_t increment) {
+  uint128_t total_multiplier = 1, total_increment = 0;
+  for (; delta != 0; delta >>= 1) {
+    if (delta & 1) {
+      total_multiplier *= multiplier;
+      total_increment   = total_increment * multiplier + increment;
+    }
+    increment   = (multiplier + 1) * increment;
+    multiplier *= multiplier;
+  }
+  return total_multiplier * state + total_increment;
+}
@@ -0,0 +1,100 @@
+#ifndef ROYRNG_H
+#define ROYRNG_H
+
+#include "../util/rpre.h"
+
+typedef enum RoyRngKind_ {
+  ROY_RNG_XOSHIRO, // xoshiro256**, period 2^256 - 1, the fastest.
+  ROY_RNG_PCG      // PCG64 (XSL-RR on a 128-bit LCG), period 2^128.
+} RoyRngKind;
+
+/**
+ * @brief RoyRng: a pseudo-random number generator owning its state, so that generators of different threads never interfere.
+ * @note - Equal kinds and seeds give equal sequences on every platform.
+ * @note - Not suitable for cryptography.
+ */
+typedef struct RoyRng_ RoyRng;
+
+/* CONSTRUCTION AND DESTRUCTION */
+
+/// @brief Creates a RoyRng of 'kind', whose state is expanded from 'seed' by splitmix64.
+RoyRng * roy_rng_new(RoyRngKind kind, uint64_t seed);
+
+/// @brief Creates a RoyRng with the state of another RoyRng, which produces the same sequence.
+RoyRng * roy_rng_copy(const RoyRng * other);
+
+/**
+ * @brief Creates a RoyRng for an independent stream: the new RoyRng continues the sequence of 'rng',
+ *        while 'rng' jumps ahead past all the numbers the new one will ever need.
+ * @note - Split one RoyRng into one RoyRng per thread for parallel work that is reproducible.
+ */
+RoyRng * roy_rng_split(RoyRng * rng);
+
+/**
+ * @brief Destroys the RoyRng - 'rng' itself.
+ * @note - Always call this function after the work is done by the given 'rng' to get rid of memory leaking.
+ */
+void roy_rng_delete(RoyRng * rng, void * user_data);
+
+/**
+ * @brief Returns the RoyRng of the calling thread, seeded by 'roy_rng_entropy' on first use.
+ * @note - Do not delete it.
+ */
+RoyRng * roy_rng_thread(void);
+
+/**
+ * @brief Returns a seed mixed from the clock and the calling thread, which differs from call to call.
+ * @note - Not suitable for cryptography.
+ */
+uint64_t roy_rng_entropy(void);
+
+/// @brief Advances 'state' and returns the next number of the splitmix64 sequence, the usual way to derive seeds from one integer.
+uint64_t roy_splitmix64(uint64_t * state);
+
+/* MODIFIERS */
+
+/// @brief Resets the state of 'rng' from 'seed', as 'roy_rng_new' does.
+void roy_rng_seed(RoyRng * rng, uint64_t seed);
+
+/**
+ * @brief Advances 'rng' as if 2^128 (xoshiro256**) or 2^64 (PCG64) numbers were generated, in a few hundred steps.
+ * @note - Generators jumped 0, 1, 2... times from the same state produce non-overlapping streams.
+ */
+void roy_rng_jump(RoyRng * rng);
+
+/* OPERATIONS */
+
+/// @brief Generates a uniformly distributed 64-bit integer.
+uint64_t roy_rng_next(RoyRng * rng);
+
+/**
+ * @brief Generates an integer N ∈ [0, bound) without bias, mostly by one multiplication instead of a division (Lemire's method).
+ * @return 0 - 'bound' is 0.
+ */
+uint64_t roy_rng_bounded(RoyRng * rng, uint64_t bound);
+
+/**
+ * @brief Generates an integer N ∈ [min, max) without bias.
+ * @return 'min' - the range is empty.
+ */
+uint64_t roy_rng_range(RoyRng * rng, uint64_t min, uint64_t max);
+
+/// @brief Generates a double N ∈ [0, 1) from the upper 53 bits of a 64-bit integer.
+double roy_rng_double(RoyRng * rng);
+
+/// @brief Fills 'dest' with 'count' 64-bit integers.
+void roy_rng_fill(RoyRng * restrict rng, uint64_t * restrict dest, size_t count);
+
+/// @brief Fills 'dest' with 'size' random bytes.
+void roy_rng_fill_bytes(RoyRng * restrict rng, void * restrict dest, size_t size);
+
+/**
+ * @brief Fills 'dest' with 'count' integers N ∈ [0, bound), computing the rejection threshold once for all.
+ * @note - 'dest' is filled with 0 if 'bound' is 0.
+ */
+void roy_rng_fill_bounded(RoyRng * restrict rng, uint64_t * restrict dest, size_t count, uint64_t bound);
+
+/// @brief Fills 'dest' with 'count' doubles N ∈ [0, 1).
+void roy_rng_fill_double(RoyRng * restrict rng, double * restrict dest, size_t count);
+
+#endif // ROYRNG_H
@@ -0,0 +1,132 @@
+#include "royblockedbloom.h"
+#include "../util/rhash.h"
+#include <math.h>
+
+enum {
+  BLOCK_SIZE     = 0x40,
+  BLOCK_WORDS    = BLOCK_SIZE / sizeof(uint64_t),
+  BLOCK_SHIFT    = 64 - 9, // the upper 9 bits of a hash pick one of the 512 bits in a block.
+  HASH_COUNT_MAX = 0x10
+};
+
+struct RoyBlockedBloom_ {
+  uint64_t * blocks;       // aligned to BLOCK_SIZE, BLOCK_WORDS words per block.
+  size_t     block_count;
+  size_t     hash_count;
+  uint64_t   seed;
+  RHash      hash;
+};
+
+static inline uint64_t * block_of(const RoyBlockedBloom * bloom, uint64_t hash);
+static inline void mask_of(uint64_t * mask, uint64_t hash, size_t hash_count);
+
+RoyBlockedBloom *
+roy_blocked_bloom_new(size_t   capacity,
+                      double   error_rate,
+                      uint64_t seed,
+                      RHash    hash) {
+  capacity   = capacity != 0 ? capacity : 1;
+  error_rate = error_rate > 0 && error_rate < 1 ? error_rate : 0.01;
+  // Sized as a RoyBloom, then rounded up to whole blocks.
+  double bit_count  = ceil(-(double)capacity * log(error_rate) / (M_LN2 * M_LN2));
+  double hash_count = round(bit_count / capacity * M_LN2);
+  RoyBlockedBloom * ret = malloc(sizeof(RoyBlockedBloom));
+  ret->block_count = (size_t)(bit_count / (BLOCK_SIZE * 8)) + 1;
+  ret->hash_count  = hash_count < 1 ? 1 : hash_count > HASH_COUNT_MAX ? HASH_COUNT_MAX : (size_t)hash_count;
+  ret->seed        = seed;
+  ret->hash        = hash ? hash : MurmurHash2;
+  ret->blocks      = aligned_alloc(BLOCK_SIZE, ret->block_count * BLOCK_SIZE);
+  roy_blocked_bloom_clear(ret);
+  return ret;
+}
+
+void
+roy_blocked_bloom_delete(RoyBlockedBloom              * bloom,
+                         __attribute__((unused)) void * user_data) {
+  free(bloom->blocks);
+  free(bloom);
+}
+
+size_t
+roy_blocked_bloom_memory(const RoyBlockedBloom * bloom) {
+  return sizeof(RoyBlockedBloom) + bloom->block_count * BLOCK_SIZE;
+}
+
+size_t
+roy_blocked_bloom_hash_count(const RoyBlockedBloom * bloom) {
+  return bloom->hash_count;
+}
+
+bool
+roy_blocked_bloom_insert(RoyBlockedBloom * restrict bloom,
+                         const void      * restrict key,
+                         size_t                     key_size) {
+  uint64_t hash = bloom->hash(key, key_size, bloom->seed);
+  uint64_t * block = block_of(bloom, hash);
+  uint64_t mask[BLOCK_WORDS];
+  mask_of(mask, hash, bloom->hash_count);
+  uint64_t missing = 0;
+  for (size_t i = 0; i != BLOCK_WORDS; i++) {
+    missing  |= mask[i] & ~block[i];
+    block[i] |= mask[i];
+  }
+  return missing != 0;
+}
+
+void
+roy_blocked_bloom_clear(RoyBlockedBloom * bloom) {
+  memset(bloom->blocks, 0, bloom->block_count * BLOCK_SIZE);
+}
+
+bool
+roy_blocked_bloom_union(RoyBlockedBloom       * dest,
+                        const RoyBlockedBloom * other) {
+  if (dest->block_count != other->block_count || dest->hash_count != other->hash_count ||
+      dest->seed != other->seed || dest->hash != other->hash) {
+    return false;
+  }
+  for (size_t i = 0; i != dest->block_count * BLOCK_WORDS; i++) {
+    dest->blocks[i] |= other->blocks[i];
+  }
+  return true;
+}
+
+bool
+roy_blocked_bloom_contains(const RoyBlockedBloom * restrict bloom,
+                           const void            * restrict key,
+                           size_t                           key_size) {
+  uint64_t hash = bloom->hash(key, key_size, bloom->seed);
+  const uint64_t * block = block_of(bloom, hash);
+  uint64_t mask[BLOCK_WORDS];
+  mask_of(mask, hash, bloom->hash_count);
+  // No early exit: the whole block is in one cache line, and the loop is branch free.
+  uint64_t missing = 0;
+  for (size_t i = 0; i != BLOCK_WORDS; i++) {
+    missing |= mask[i] & ~block[i];
+  }
+  return missing == 0;
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+// Picks a block by the upper bits of 'hash', with a multiplication instead of a modulo.
+static inline uint64_t *
+block_of(const RoyBlockedBloom * bloom,
+         uint64_t                hash) {
+  size_t index = (size_t)(((unsigned __int128)hash * bloom->block_count) >> 64);
+  return bloom->blocks + index * BLOCK_WORDS;
+}
+
+// Builds the bits of a key in a block, from hashes independent of the one picking the block.
+static inline void
+mask_of(uint64_t * mask,
+        uint64_t   hash,
+        size_t     hash_count) {
+  memset(mask, 0, BLOCK_SIZE);
+  uint64_t current = (hash ^ hash >> 31) * 0x9E3779B97F4A7C15ULL;
+  uint64_t step    = ((hash ^ hash >> 29) * 0xBF58476D1CE4E5B9ULL) | 1;
+  for (size_t i = 0; i != hash_count; i++, current += step) {
+    uint64_t bit = current >> BLOCK_SHIFT;
+    mask[bit / 64] |= 1ULL << (bit % 64);
+  }
+}
@@ -0,0 +1,69 @@
+#ifndef ROYBLOCKEDBLOOM_H
+#define ROYBLOCKEDBLOOM_H
+
+#include "../util/rpre.h"
+
+/**
+ * @brief RoyBlockedBloom (aka 'Blocked Bloom Filter'): a RoyBloom whose bits of a key all fall in one 64-byte block,
+ * so that an insertion or a lookup touches a single cache line instead of one per hash.
+ * @note - The false positive rate is a little higher than a RoyBloom of the same size, since blocks fill unevenly.
+ */
+typedef struct RoyBlockedBloom_ RoyBlockedBloom;
+
+/* CONSTRUCTION AND DESTRUCTION */
+
+/**
+ * @brief Creates a RoyBlockedBloom for 'capacity' keys at 'error_rate'.
+ * @param capacity - the expected number of keys, the error rate rises beyond it.
+ * @param error_rate - the acceptable false positive rate in (0, 1).
+ * @param seed - a hash seed.
+ * @param hash - a hash function, NULL to use the default MurmurHash.
+ * @return a pointer to a newly build RoyBlockedBloom.
+ */
+RoyBlockedBloom * roy_blocked_bloom_new(size_t capacity, double error_rate, uint64_t seed, RHash hash);
+
+/**
+ * @brief Destroys the RoyBlockedBloom - 'bloom' itself.
+ * @note - Always call this function after the work is done by the given 'bloom' to get rid of memory leaking.
+ */
+void roy_blocked_bloom_delete(RoyBlockedBloom * bloom, void * user_data);
+
+/* CAPACITY */
+
+/// @brief Returns the number of bytes taken by 'bloom', including itself.
+size_t roy_blocked_bloom_memory(const RoyBlockedBloom * bloom);
+
+/// @brief Returns the number of bits set for every key.
+size_t roy_blocked_bloom_hash_count(const RoyBlockedBloom * bloom);
+
+/* MODIFIERS */
+
+/**
+ * @brief Inserts 'key' into 'bloom'.
+ * @param key - a pointer to the key.
+ * @param key_size - total memory the key takes.
+ * @retval true - 'key' was definitely not inserted before.
+ * @retval false - 'key' was probably inserted before.
+ */
+bool roy_blocked_bloom_insert(RoyBlockedBloom * restrict bloom, const void * restrict key, size_t key_size);
+
+/// @brief Removes all the keys from 'bloom'.
+void roy_blocked_bloom_clear(RoyBlockedBloom * bloom);
+
+/**
+ * @brief Inserts all keys of 'other' into 'dest'.
+ * @retval true - the operation is successful.
+ * @retval false - 'dest' and 'other' differ in size, hash count, seed or hash function.
+ */
+bool roy_blocked_bloom_union(RoyBlockedBloom * dest, const RoyBlockedBloom * other);
+
+/* LOOKUPS */
+
+/**
+ * @brief Checks whether 'key' has been inserted into 'bloom'.
+ * @retval true - 'key' was probably inserted.
+ * @retval false - 'key' was definitely not inserted.
+ */
+bool roy_blocked_bloom_contains(const RoyBlockedBloom * restrict bloom, const void * restrict key, size_t key_size);
+
+#endif // ROYBLOCKEDBLOOM_H
@@ -0,0 +1,128 @@
+#include "roybloom.h"
+#include "../util/rhash.h"
+#include <math.h>
+
+enum {
+  BIT_COUNT_MIN  = 0x40,
+  HASH_COUNT_MAX = 0x20
+};
+
+struct RoyBloom_ {
+  uint64_t * words;
+  size_t     bit_count;
+  size_t     hash_count;
+  uint64_t   seed;
+  RHash      hash;
+};
+
+static inline uint64_t step_of(uint64_t hash);
+static inline size_t position_of(uint64_t hash, size_t bit_count);
+
+RoyBloom *
+roy_bloom_new(size_t   capacity,
+              double   error_rate,
+              uint64_t seed,
+              RHash    hash) {
+  capacity   = capacity != 0 ? capacity : 1;
+  error_rate = error_rate > 0 && error_rate < 1 ? error_rate : 0.01;
+  // m = -n * ln(p) / ln(2)^2 bits, k = m / n * ln(2) hashes.
+  double bit_count  = ceil(-(double)capacity * log(error_rate) / (M_LN2 * M_LN2));
+  double hash_count = round(bit_count / capacity * M_LN2);
+  RoyBloom * ret   = malloc(sizeof(RoyBloom));
+  ret->bit_count   = bit_count > BIT_COUNT_MIN ? (size_t)bit_count : BIT_COUNT_MIN;
+  ret->hash_count  = hash_count < 1 ? 1 : hash_count > HASH_COUNT_MAX ? HASH_COUNT_MAX : (size_t)hash_count;
+  ret->seed        = seed;
+  ret->hash        = hash ? hash : MurmurHash2;
+  ret->words       = calloc((ret->bit_count + 63) / 64, sizeof(uint64_t));
+  return ret;
+}
+
+void
+roy_bloom_delete(RoyBloom                     * bloom,
+                 __attribute__((unused)) void * user_data) {
+  free(bloom->words);
+  free(bloom);
+}
+
+size_t
+roy_bloom_memory(const RoyBloom * bloom) {
+  return sizeof(RoyBloom) + (bloom->bit_count + 63) / 64 * sizeof(uint64_t);
+}
+
+size_t
+roy_bloom_hash_count(const RoyBloom * bloom) {
+  return bloom->hash_count;
+}
+
+double
+roy_bloom_error_rate(const RoyBloom * bloom) {
+  size_t count = 0;
+  for (size_t i = 0; i != (bloom->bit_count + 63) / 64; i++) {
+    count += __builtin_popcountll(bloom->words[i]);
+  }
+  return pow((double)count / bloom->bit_count, (double)bloom->hash_count);
+}
+
+bool
+roy_bloom_insert(RoyBloom   * restrict bloom,
+                 const void * restrict key,
+                 size_t                key_size) {
+  uint64_t hash = bloom->hash(key, key_size, bloom->seed);
+  uint64_t step = step_of(hash);
+  uint64_t missing = 0;
+  for (size_t i = 0; i != bloom->hash_count; i++, hash += step) {
+    size_t position = position_of(hash, bloom->bit_count);
+    uint64_t bit = 1ULL << (position % 64);
+    missing |= ~bloom->words[position / 64] & bit;
+    bloom->words[position / 64] |= bit;
+  }
+  return missing != 0;
+}
+
+void
+roy_bloom_clear(RoyBloom * bloom) {
+  memset(bloom->words, 0, (bloom->bit_count + 63) / 64 * sizeof(uint64_t));
+}
+
+bool
+roy_bloom_union(RoyBloom       * dest,
+                const RoyBloom * other) {
+  if (dest->bit_count != other->bit_count || dest->hash_count != other->hash_count ||
+      dest->seed != other->seed || dest->hash != other->hash) {
+    return false;
+  }
+  for (size_t i = 0; i != (dest->bit_count + 63) / 64; i++) {
+    dest->words[i] |= other->words[i];
+  }
+  return true;
+}
+
+bool
+roy_bloom_contains(const RoyBloom * restrict bloom,
+                   const void     * restrict key,
+                   size_t                    key_size) {
+  uint64_t hash = bloom->hash(key, key_size, bloom->seed);
+  uint64_t step = step_of(hash);
+  for (size_t i = 0; i != bloom->hash_count; i++, hash += step) {
+    size_t position = position_of(hash, bloom->bit_count);
+    if (!(bloom->words[position / 64] >> (position % 64) & 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+// The k hashes are 'hash' + i * 'step' (Kirsch and Mitzenmacher), 'step' being a remix of 'hash'.
+static inline uint64_t
+step_of(uint64_t hash) {
+  return ((hash ^ hash >> 29) * 0xBF58476D1CE4E5B9ULL) | 1;
+}
+
+// Maps 'hash' onto [0, bit_count) by its upper bits, with a multiplication instead of a modulo.
+static inline size_t
+position_of(uint64_t hash,
+            size_t   bit_count) {
+  return (size_t)(((unsigned __int128)hash * bit_count) >> 64);
+}
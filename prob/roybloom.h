@@ -0,0 +1,73 @@
+#ifndef ROYBLOOM_H
+#define ROYBLOOM_H
+
+#include "../util/rpre.h"
+
+/**
+ * @brief RoyBloom (aka 'Bloom Filter'): an approximate set which answers whether a key has been inserted,
+ * in a few bits per key and no matter how large the keys are.
+ * There are no false negatives, while false positives happen at about the error rate it is built for.
+ * @note - Keys can not be removed or enumerated.
+ */
+typedef struct RoyBloom_ RoyBloom;
+
+/* CONSTRUCTION AND DESTRUCTION */
+
+/**
+ * @brief Creates a RoyBloom of the optimal size for 'capacity' keys at 'error_rate'.
+ * @param capacity - the expected number of keys, the error rate rises beyond it.
+ * @param error_rate - the acceptable false positive rate in (0, 1), e.g. 0.01 takes 9.6 bits per key.
+ * @param seed - a hash seed.
+ * @param hash - a hash function, NULL to use the default MurmurHash.
+ * @return a pointer to a newly build RoyBloom.
+ */
+RoyBloom * roy_bloom_new(size_t capacity, double error_rate, uint64_t seed, RHash hash);
+
+/**
+ * @brief Destroys the RoyBloom - 'bloom' itself.
+ * @note - Always call this function after the work is done by the given 'bloom' to get rid of memory leaking.
+ */
+void roy_bloom_delete(RoyBloom * bloom, void * user_data);
+
+/* CAPACITY */
+
+/// @brief Returns the number of bytes taken by 'bloom', including itself.
+size_t roy_bloom_memory(const RoyBloom * bloom);
+
+/// @brief Returns the number of bits set for every key.
+size_t roy_bloom_hash_count(const RoyBloom * bloom);
+
+/// @brief Estimates the current false positive rate of 'bloom' from the fraction of '1' bits.
+double roy_bloom_error_rate(const RoyBloom * bloom);
+
+/* MODIFIERS */
+
+/**
+ * @brief Inserts 'key' into 'bloom'.
+ * @param key - a pointer to the key.
+ * @param key_size - total memory the key takes.
+ * @retval true - 'key' was definitely not inserted before.
+ * @retval false - 'key' was probably inserted before.
+ */
+bool roy_bloom_insert(RoyBloom * restrict bloom, const void * restrict key, size_t key_size);
+
+/// @brief Removes all the keys from 'bloom'.
+void roy_bloom_clear(RoyBloom * bloom);
+
+/**
+ * @brief Inserts all keys of 'other' into 'dest'.
+ * @retval true - the operation is successful.
+ * @retval false - 'dest' and 'other' differ in size, hash count, seed or hash function.
+ */
+bool roy_bloom_union(RoyBloom * dest, const RoyBloom * other);
+
+/* LOOKUPS */
+
+/**
+ * @brief Checks whether 'key' has been inserted into 'bloom'.
+ * @retval true - 'key' was probably inserted.
+ * @retval false - 'key' was definitely not inserted.
+ */
+bool roy_bloom_contains(const RoyBloom * restrict bloom, const void * restrict key, size_t key_size);
+
+#endif // ROYBLOOM_H
@@ -0,0 +1,113 @@
+#include "roycountmin.h"
+#include "../util/rhash.h"
+#include <math.h>
+
+struct RoyCountMin_ {
+  uint64_t * counters;    // row 'i' takes counters [i * width, (i + 1) * width).
+  size_t     width;
+  size_t     depth;
+  uint64_t   total;
+  uint64_t   seed;
+  RHash      hash;
+};
+
+static inline uint64_t step_of(uint64_t hash);
+static inline size_t column_of(uint64_t hash, size_t width);
+
+RoyCountMin *
+roy_count_min_new(double   epsilon,
+                  double   delta,
+                  uint64_t seed,
+                  RHash    hash) {
+  epsilon = epsilon > 0 && epsilon < 1 ? epsilon : 0.001;
+  delta   = delta   > 0 && delta   < 1 ? delta   : 0.01;
+  RoyCountMin * ret = malloc(sizeof(RoyCountMin));
+  ret->width    = (size_t)ceil(M_E / epsilon);
+  ret->depth    = (size_t)ceil(log(1 / delta));
+  ret->total    = 0;
+  ret->seed     = seed;
+  ret->hash     = hash ? hash : MurmurHash2;
+  ret->counters = calloc(ret->width * ret->depth, sizeof(uint64_t));
+  return ret;
+}
+
+void
+roy_count_min_delete(RoyCountMin                  * sketch,
+                     __attribute__((unused)) void * user_data) {
+  free(sketch->counters);
+  free(sketch);
+}
+
+size_t
+roy_count_min_memory(const RoyCountMin * sketch) {
+  return sizeof(RoyCountMin) + sketch->width * sketch->depth * sizeof(uint64_t);
+}
+
+uint64_t
+roy_count_min_total(const RoyCountMin * sketch) {
+  return sketch->total;
+}
+
+void
+roy_count_min_add(RoyCountMin * restrict sketch,
+                  const void  * restrict key,
+                  size_t                 key_size,
+                  uint64_t               count) {
+  uint64_t hash = sketch->hash(key, key_size, sketch->seed);
+  uint64_t step = step_of(hash);
+  uint64_t * row = sketch->counters;
+  for (size_t i = 0; i != sketch->depth; i++, hash += step, row += sketch->width) {
+    row[column_of(hash, sketch->width)] += count;
+  }
+  sketch->total += count;
+}
+
+void
+roy_count_min_clear(RoyCountMin * sketch) {
+  memset(sketch->counters, 0, sketch->width * sketch->depth * sizeof(uint64_t));
+  sketch->total = 0;
+}
+
+bool
+roy_count_min_merge(RoyCountMin       * dest,
+                    const RoyCountMin * other) {
+  if (dest->width != other->width || dest->depth != other->depth ||
+      dest->seed != other->seed || dest->hash != other->hash) {
+    return false;
+  }
+  for (size_t i = 0; i != dest->width * dest->depth; i++) {
+    dest->counters[i] += other->counters[i];
+  }
+  dest->total += other->total;
+  return true;
+}
+
+uint64_t
+roy_count_min_estimate(const RoyCountMin * restrict sketch,
+                       const void        * restrict key,
+                       size_t                       key_size) {
+  uint64_t hash = sketch->hash(key, key_size, sketch->seed);
+  uint64_t step = step_of(hash);
+  const uint64_t * row = sketch->counters;
+  uint64_t ret = UINT64_MAX;
+  for (size_t i = 0; i != sketch->depth; i++, hash += step, row += sketch->width) {
+    uint64_t count = row[column_of(hash, sketch->width)];
+    ret = count < ret ? count : ret;
+  }
+  return ret;
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+// Row 'i' is indexed by 'hash' + i * 'step' (Kirsch and Mitzenmacher), 'step' being a remix of 'hash'.
+static inline uint64_t
+step_of(uint64_t hash) {
+  return ((hash ^ hash >> 29) * 0xBF58476D1CE4E5B9ULL) | 1;
+}
+
+// Maps 'hash' onto [0, width) by its upper bits, with a multiplication instead of a modulo.
+static inline size_t
+column_of(uint64_t hash,
+          size_t   width) {
+  return (size_t)(((unsigned __int128)hash * width) >> 64);
+}
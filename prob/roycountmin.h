@@ -0,0 +1,63 @@
+#ifndef ROYCOUNTMIN_H
+#define ROYCOUNTMIN_H
+
+#include "../util/rpre.h"
+
+/**
+ * @brief RoyCountMin (aka 'Count-Min Sketch'): approximate counts of keys in a fixed table of counters,
+ * 'depth' rows of 'width' counters, each row indexed by its own hash.
+ * An estimate is never below the true count, and exceeds it by at most epsilon * total with probability 1 - delta.
+ */
+typedef struct RoyCountMin_ RoyCountMin;
+
+/* CONSTRUCTION AND DESTRUCTION */
+
+/**
+ * @brief Creates a RoyCountMin of ceil(e / 'epsilon') columns and ceil(ln(1 / 'delta')) rows.
+ * @param epsilon - the error relative to the total count in (0, 1), e.g. 0.001.
+ * @param delta - the probability to exceed the error in (0, 1), e.g. 0.01.
+ * @param seed - a hash seed.
+ * @param hash - a hash function, NULL to use the default MurmurHash.
+ * @return a pointer to a newly build RoyCountMin.
+ */
+RoyCountMin * roy_count_min_new(double epsilon, double delta, uint64_t seed, RHash hash);
+
+/**
+ * @brief Destroys the RoyCountMin - 'sketch' itself.
+ * @note - Always call this function after the work is done by the given 'sketch' to get rid of memory leaking.
+ */
+void roy_count_min_delete(RoyCountMin * sketch, void * user_data);
+
+/* CAPACITY */
+
+/// @brief Returns the number of bytes taken by 'sketch', including itself.
+size_t roy_count_min_memory(const RoyCountMin * sketch);
+
+/// @brief Returns the sum of all counts added to 'sketch'.
+uint64_t roy_count_min_total(const RoyCountMin * sketch);
+
+/* MODIFIERS */
+
+/**
+ * @brief Adds 'count' occurrences of 'key'.
+ * @param key - a pointer to the key.
+ * @param key_size - total memory the key takes.
+ */
+void roy_count_min_add(RoyCountMin * restrict sketch, const void * restrict key, size_t key_size, uint64_t count);
+
+/// @brief Resets all counts of 'sketch' to 0.
+void roy_count_min_clear(RoyCountMin * sketch);
+
+/**
+ * @brief Adds all counts of 'other' to 'dest'.
+ * @retval true - the operation is successful.
+ * @retval false - 'dest' and 'other' differ in shape, seed or hash function.
+ */
+bool roy_count_min_merge(RoyCountMin * dest, const RoyCountMin * other);
+
+/* LOOKUPS */
+
+/// @brief Estimates the count of 'key', the least of its counters.
+uint64_t roy_count_min_estimate(const RoyCountMin * restrict sketch, const void * restrict key, size_t key_size);
+
+#endif // ROYCOUNTMIN_H
@@ -0,0 +1,99 @@
+#include "royhyperloglog.h"
+#include "../util/rhash.h"
+#include <math.h>
+
+struct RoyHyperLogLog_ {
+  uint8_t  * registers;   // the most leading zeros plus one of the hashes falling in each register.
+  size_t     precision;
+  uint64_t   seed;
+  RHash      hash;
+};
+
+static double alpha(size_t register_count);
+
+RoyHyperLogLog *
+roy_hyper_log_log_new(size_t   precision,
+                      uint64_t seed,
+                      RHash    hash) {
+  RoyHyperLogLog * ret = malloc(sizeof(RoyHyperLogLog));
+  ret->precision = precision < ROY_HYPER_LOG_LOG_PRECISION_MIN ? ROY_HYPER_LOG_LOG_PRECISION_MIN :
+                   precision > ROY_HYPER_LOG_LOG_PRECISION_MAX ? ROY_HYPER_LOG_LOG_PRECISION_MAX : precision;
+  ret->seed      = seed;
+  ret->hash      = hash ? hash : MurmurHash2;
+  ret->registers = calloc((size_t)1 << ret->precision, sizeof(uint8_t));
+  return ret;
+}
+
+void
+roy_hyper_log_log_delete(RoyHyperLogLog               * hll,
+                         __attribute__((unused)) void * user_data) {
+  free(hll->registers);
+  free(hll);
+}
+
+size_t
+roy_hyper_log_log_memory(const RoyHyperLogLog * hll) {
+  return sizeof(RoyHyperLogLog) + ((size_t)1 << hll->precision);
+}
+
+size_t
+roy_hyper_log_log_count(const RoyHyperLogLog * hll) {
+  size_t register_count = (size_t)1 << hll->precision;
+  size_t zero_count = 0;
+  double sum = 0;
+  for (size_t i = 0; i != register_count; i++) {
+    sum        += 1.0 / ((uint64_t)1 << hll->registers[i]);
+    zero_count += hll->registers[i] == 0;
+  }
+  double estimate = alpha(register_count) * register_count * register_count / sum;
+  // Small cardinalities are estimated better by linear counting. 64-bit hashes need no large range correction.
+  if (estimate <= 2.5 * register_count && zero_count != 0) {
+    estimate = register_count * log((double)register_count / zero_count);
+  }
+  return (size_t)(estimate + 0.5);
+}
+
+bool
+roy_hyper_log_log_insert(RoyHyperLogLog * restrict hll,
+                         const void     * restrict key,
+                         size_t                    key_size) {
+  uint64_t hash = hll->hash(key, key_size, hll->seed);
+  // The upper bits pick a register, the rest ranks by leading zeros, with a sentinel bit to bound the rank.
+  size_t index = hash >> (64 - hll->precision);
+  uint8_t rank = (uint8_t)(__builtin_clzll(hash << hll->precision | (uint64_t)1 << (hll->precision - 1)) + 1);
+  if (rank <= hll->registers[index]) {
+    return false;
+  }
+  hll->registers[index] = rank;
+  return true;
+}
+
+void
+roy_hyper_log_log_clear(RoyHyperLogLog * hll) {
+  memset(hll->registers, 0, (size_t)1 << hll->precision);
+}
+
+bool
+roy_hyper_log_log_merge(RoyHyperLogLog       * dest,
+                        const RoyHyperLogLog * other) {
+  if (dest->precision != other->precision || dest->seed != other->seed || dest->hash != other->hash) {
+    return false;
+  }
+  for (size_t i = 0; i != (size_t)1 << dest->precision; i++) {
+    dest->registers[i] = other->registers[i] > dest->registers[i] ? other->registers[i] : dest->registers[i];
+  }
+  return true;
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+// The bias correction constant of Flajolet et al.
+static double
+alpha(size_t register_count) {
+  switch (register_count) {
+    case 0x10: return 0.673;
+    case 0x20: return 0.697;
+    case 0x40: return 0.709;
+    default:   return 0.7213 / (1 + 1.079 / register_count);
+  }
+}
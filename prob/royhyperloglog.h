@@ -0,0 +1,64 @@
+#ifndef ROYHYPERLOGLOG_H
+#define ROYHYPERLOGLOG_H
+
+#include "../util/rpre.h"
+
+enum {
+  ROY_HYPER_LOG_LOG_PRECISION_MIN = 4,
+  ROY_HYPER_LOG_LOG_PRECISION_MAX = 18
+};
+
+/**
+ * @brief RoyHyperLogLog: estimates the number of distinct keys in 2^precision one-byte registers,
+ * with a standard error of about 1.04 / sqrt(2^precision), e.g. 0.8% in 16 KB at precision 14.
+ * @note - Keys can not be removed or enumerated.
+ */
+typedef struct RoyHyperLogLog_ RoyHyperLogLog;
+
+/* CONSTRUCTION AND DESTRUCTION */
+
+/**
+ * @brief Creates a RoyHyperLogLog of 2^'precision' registers.
+ * @param precision - clamped into [ROY_HYPER_LOG_LOG_PRECISION_MIN, ROY_HYPER_LOG_LOG_PRECISION_MAX].
+ * @param seed - a hash seed.
+ * @param hash - a hash function, NULL to use the default MurmurHash.
+ * @return a pointer to a newly build RoyHyperLogLog.
+ */
+RoyHyperLogLog * roy_hyper_log_log_new(size_t precision, uint64_t seed, RHash hash);
+
+/**
+ * @brief Destroys the RoyHyperLogLog - 'hll' itself.
+ * @note - Always call this function after the work is done by the given 'hll' to get rid of memory leaking.
+ */
+void roy_hyper_log_log_delete(RoyHyperLogLog * hll, void * user_data);
+
+/* CAPACITY */
+
+/// @brief Returns the number of bytes taken by 'hll', including itself.
+size_t roy_hyper_log_log_memory(const RoyHyperLogLog * hll);
+
+/// @brief Estimates the number of distinct keys inserted into 'hll'.
+size_t roy_hyper_log_log_count(const RoyHyperLogLog * hll);
+
+/* MODIFIERS */
+
+/**
+ * @brief Inserts 'key' into 'hll'.
+ * @param key - a pointer to the key.
+ * @param key_size - total memory the key takes.
+ * @retval true - the estimate may have changed.
+ * @retval false - the estimate stays the same.
+ */
+bool roy_hyper_log_log_insert(RoyHyperLogLog * restrict hll, const void * restrict key, size_t key_size);
+
+/// @brief Removes all the keys from 'hll'.
+void roy_hyper_log_log_clear(RoyHyperLogLog * hll);
+
+/**
+ * @brief Inserts all keys of 'other' into 'dest', so that 'dest' estimates the distinct keys of both.
+ * @retval true - the operation is successful.
+ * @retval false - 'dest' and 'other' differ in precision, seed or hash function.
+ */
+bool roy_hyper_log_log_merge(RoyHyperLogLog * dest, const RoyHyperLogLog * other);
+
+#endif // ROYHYPERLOGLOG_H
@@ -0,0 +1,102 @@
+#include "royreservoir.h"
+#include <math.h>
+
+struct RoyReservoir_ {
+  void    ** samples;
+  size_t     capacity;
+  size_t     size;
+  uint64_t   seen;
+  uint64_t   next;     // the number of elements seen when the next one is kept.
+  double     weight;   // the largest of 'capacity' uniform keys, as in Algorithm L.
+  RoyRng   * rng;
+};
+
+static RoyRng * rng_of(const RoyReservoir * reservoir);
+static double uniform(RoyRng * rng);
+static void skip(RoyReservoir * reservoir);
+
+RoyReservoir *
+roy_reservoir_new(size_t   capacity,
+                  RoyRng * rng) {
+  RoyReservoir * ret = malloc(sizeof(RoyReservoir));
+  ret->samples  = malloc((capacity != 0 ? capacity : 1) * R_PTR_SIZE);
+  ret->capacity = capacity;
+  ret->rng      = rng;
+  roy_reservoir_clear(ret);
+  return ret;
+}
+
+void
+roy_reservoir_delete(RoyReservoir                 * reservoir,
+                     __attribute__((unused)) void * user_data) {
+  free(reservoir->samples);
+  free(reservoir);
+}
+
+void *
+roy_reservoir_pointer(const RoyReservoir * reservoir,
+                      size_t               position) {
+  return position < reservoir->size ? reservoir->samples[position] : NULL;
+}
+
+size_t
+roy_reservoir_size(const RoyReservoir * reservoir) {
+  return reservoir->size;
+}
+
+uint64_t
+roy_reservoir_seen(const RoyReservoir * reservoir) {
+  return reservoir->seen;
+}
+
+void
+roy_reservoir_offer(RoyReservoir * reservoir,
+                    void         * element) {
+  reservoir->seen++;
+  if (reservoir->size < reservoir->capacity) {
+    reservoir->samples[reservoir->size++] = element;
+    if (reservoir->size == reservoir->capacity) {
+      reservoir->weight = exp(log(uniform(rng_of(reservoir))) / reservoir->capacity);
+      skip(reservoir);
+    }
+  } else if (reservoir->seen == reservoir->next) {
+    RoyRng * rng = rng_of(reservoir);
+    reservoir->samples[roy_rng_bounded(rng, reservoir->capacity)] = element;
+    reservoir->weight *= exp(log(uniform(rng)) / reservoir->capacity);
+    skip(reservoir);
+  }
+}
+
+void
+roy_reservoir_doer(void * element,
+                   void * reservoir) {
+  roy_reservoir_offer(reservoir, element);
+}
+
+void
+roy_reservoir_clear(RoyReservoir * reservoir) {
+  reservoir->size   = 0;
+  reservoir->seen   = 0;
+  reservoir->next   = UINT64_MAX;
+  reservoir->weight = 1;
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+static RoyRng *
+rng_of(const RoyReservoir * reservoir) {
+  return reservoir->rng ? reservoir->rng : roy_rng_thread();
+}
+
+// Returns a double in (0, 1], whose logarithm is finite.
+static double
+uniform(RoyRng * rng) {
+  return 1 - roy_rng_double(rng);
+}
+
+// Draws the number of elements to pass over before the next one kept, from a geometric distribution.
+static void
+skip(RoyReservoir * reservoir) {
+  double gap = floor(log(uniform(rng_of(reservoir))) / log1p(-reservoir->weight)) + 1;
+  reservoir->next = gap < (double)(UINT64_MAX - reservoir->seen) ? reservoir->seen + (uint64_t)gap : UINT64_MAX;
+}
@@ -0,0 +1,70 @@
+#ifndef ROYRESERVOIR_H
+#define ROYRESERVOIR_H
+
+#include "../util/rpre.h"
+#include "../math/royrng.h"
+
+/**
+ * @brief RoyReservoir (aka 'Reservoir Sampling'): keeps a uniform random sample of at most 'capacity' elements
+ * out of a stream of unknown length, e.g. elements passed by the 'for_each' of any container.
+ * It draws random numbers only for the elements it keeps (Li's Algorithm L), not for every element offered.
+ * @note - Elements are shared with their source, not copied, make sure they live as long as the sample is in use.
+ */
+typedef struct RoyReservoir_ RoyReservoir;
+
+/* CONSTRUCTION AND DESTRUCTION */
+
+/**
+ * @brief Creates an empty RoyReservoir.
+ * @param capacity - the size of the sample.
+ * @param rng - the RoyRng to draw from, NULL to use the RoyRng of the thread offering elements.
+ * @return a pointer to a newly build RoyReservoir.
+ */
+RoyReservoir * roy_reservoir_new(size_t capacity, RoyRng * rng);
+
+/**
+ * @brief Destroys the RoyReservoir - 'reservoir' itself, the sampled elements are left intact.
+ * @note - Always call this function after the work is done by the given 'reservoir' to get rid of memory leaking.
+ */
+void roy_reservoir_delete(RoyReservoir * reservoir, void * user_data);
+
+/* ELEMENT ACCESS */
+
+/**
+ * @brief Accesses the specified element of the sample.
+ * @return a pointer to the element at 'position', in no particular order.
+ * @return NULL - 'position' exceeds.
+ */
+void * roy_reservoir_pointer(const RoyReservoir * reservoir, size_t position);
+
+/**
+ * @brief Accesses the specified element of the sample.
+ * @return a typed pointer to the element at 'position'.
+ * @return NULL - 'position' exceeds.
+ */
+#define roy_reservoir_at(reservoir, position, element_type) \
+        ((element_type *)roy_reservoir_pointer((reservoir), (position)))
+
+/* CAPACITY */
+
+/// @brief Returns the number of elements in the sample, which is the capacity once enough elements are offered.
+size_t roy_reservoir_size(const RoyReservoir * reservoir);
+
+/// @brief Returns the number of elements offered to 'reservoir' so far.
+uint64_t roy_reservoir_seen(const RoyReservoir * reservoir);
+
+/* MODIFIERS */
+
+/// @brief Offers 'element' to the sample, which keeps it with probability capacity / seen.
+void roy_reservoir_offer(RoyReservoir * reservoir, void * element);
+
+/**
+ * @brief Offers 'element' to the RoyReservoir 'reservoir', as an RDoer.
+ * @note - Pass it to any 'for_each' to sample a container, e.g. 'roy_vector_for_each(vector, roy_reservoir_doer, reservoir)'.
+ */
+void roy_reservoir_doer(void * element, void * reservoir);
+
+/// @brief Drops the sample and starts over, the elements are left intact.
+void roy_reservoir_clear(RoyReservoir * reservoir);
+
+#endif // ROYRESERVOIR_H
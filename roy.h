@@ -8,6 +8,7 @@
 #include "list/royslist.h"
 #include "list/roylist.h"
 #include "list/roydeque.h"
+#include "list/royunrolledlist.h"
 #include "tree/royset.h"
 #include "tree/roymset.h"
 #include "tree/roymap.h"
@@ -16,9 +17,26 @@
 #include "hash/royumset.h"
 #include "hash/royumap.h"
 #include "hash/royummap.h"
+#include "hash/royroaring.h"
 #include "string/roystring.h"
+#include "string/roystringview.h"
+#include "string/royregex.h"
+#include "string/roytokenizer.h"
+#include "string/royrope.h"
+#include "string/royinternpool.h"
+#include "string/roylinereader.h"
+#include "string/roywriter.h"
 #include "string/royshell.h"
 #include "math/roynumber.h"
 #include "math/roymath.h"
+#include "math/roybitset.h"
+#include "math/royrng.h"
+#include "prob/roybloom.h"
+#include "prob/royblockedbloom.h"
+#include "prob/roycountmin.h"
+#include "prob/royhyperloglog.h"
+#include "prob/royreservoir.h"
+#include "util/rstats.h"
+#include "thread/roythreadpool.h"
 
 #endif // ROY_H
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "royinternpool.h"
+#include "../hash/royuset.h"
+#include "../util/rhash.h"
+
+// An interned string lives in 'data', a probe for searching only refers to the characters by 'str'.
+typedef struct Entry_ {
+  uint64_t     hash;
+  size_t       length;
+  const char * str;
+  char         data[];
+} Entry;
+
+struct RoyInternPool_ {
+  RoyUSet * uset;
+};
+
+static const Entry * entry_of(const char * interned);
+static uint64_t entry_hash(const Entry * entry, size_t entry_size, uint64_t seed);
+static int entry_compare(const Entry * lhs, const Entry * rhs);
+static void entry_delete(Entry * entry, void * user_data);
+static void probe_set(Entry * probe, const char * str, size_t length);
+
+RoyInternPool *
+roy_intern_pool_new(size_t bucket_count) {
+  RoyInternPool * ret = malloc(sizeof(RoyInternPool));
+  ret->uset = roy_uset_new(bucket_count,
+                           0,
+                           (RHash)entry_hash,
+                           (RComparer)entry_compare,
+                           (RDoer)entry_delete);
+  return ret;
+}
+
+void
+roy_intern_pool_delete(RoyInternPool * pool,
+                       void          * user_data) {
+  roy_uset_delete(pool->uset, user_data);
+  free(pool);
+}
+
+size_t
+roy_intern_pool_size(const RoyInternPool * pool) {
+  return roy_uset_size(pool->uset);
+}
+
+const char *
+roy_intern_pool_intern(RoyInternPool * pool,
+                       const char    * str) {
+  return roy_intern_pool_intern_n(pool, str, strlen(str));
+}
+
+const char *
+roy_intern_pool_intern_n(RoyInternPool * pool,
+                         const char    * str,
+                         size_t          length) {
+  Entry probe;
+  probe_set(&probe, str, length);
+  const Entry * found = roy_uset_find(pool->uset, &probe, sizeof(Entry));
+  if (found) {
+    return found->data;
+  }
+  Entry * entry = malloc(sizeof(Entry) + length + 1);
+  entry->hash   = probe.hash;
+  entry->length = length;
+  memcpy(entry->data, str, length);
+  entry->data[length] = '\0';
+  entry->str = entry->data;
+  roy_uset_insert(pool->uset, entry, sizeof(Entry));
+  return entry->data;
+}
+
+const char *
+roy_intern_pool_intern_string(RoyInternPool   * pool,
+                              const RoyString * string) {
+  return roy_intern_pool_intern_n(pool, roy_string_cstr(string, 0), roy_string_length(string));
+}
+
+const char *
+roy_intern_pool_find(const RoyInternPool * pool,
+                     const char          * str) {
+  Entry probe;
+  probe_set(&probe, str, strlen(str));
+  const Entry * found = roy_uset_find(pool->uset, &probe, sizeof(Entry));
+  return found ? found->data : NULL;
+}
+
+uint64_t
+roy_interned_hash(const char * interned) {
+  return entry_of(interned)->hash;
+}
+
+size_t
+roy_interned_length(const char * interned) {
+  return entry_of(interned)->length;
+}
+
+uint64_t
+roy_interned_key_hash(const void                       * key,
+                      __attribute__((unused)) size_t     key_size,
+                      __attribute__((unused)) uint64_t   seed) {
+  return roy_interned_hash(key);
+}
+
+int
+roy_interned_compare(const void * lhs,
+                     const void * rhs) {
+  return (lhs > rhs) - (lhs < rhs);
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+static const Entry *
+entry_of(const char * interned) {
+  return (const Entry *)(interned - offsetof(Entry, data));
+}
+
+// The hash is computed once by 'probe_set', the RoyUSet only reads it.
+static uint64_t
+entry_hash(const Entry                      * entry,
+           __attribute__((unused)) size_t     entry_size,
+           __attribute__((unused)) uint64_t   seed) {
+  return entry->hash;
+}
+
+static int
+entry_compare(const Entry * lhs,
+              const Entry * rhs) {
+  if (lhs->hash != rhs->hash) {
+    return (lhs->hash > rhs->hash) - (lhs->hash < rhs->hash);
+  }
+  if (lhs->length != rhs->length) {
+    return (lhs->length > rhs->length) - (lhs->length < rhs->length);
+  }
+  return memcmp(lhs->str, rhs->str, lhs->length);
+}
+
+static void
+entry_delete(Entry                        * entry,
+             __attribute__((unused)) void * user_data) {
+  free(entry);
+}
+
+static void
+probe_set(Entry      * probe,
+          const char * str,
+          size_t       length) {
+  probe->hash   = MurmurHash2(str, length, 0);
+  probe->length = length;
+  probe->str    = str;
+}
@@ -0,0 +1,82 @@
+#ifndef ROYINTERNPOOL_H
+#define ROYINTERNPOOL_H
+
+#include "../util/rpre.h"
+#include "roystring.h"
+
+/**
+ * @brief RoyInternPool: keeps one canonical copy of every distinct string interned into it.
+ *        Two interned strings are equal if and only if they are the same pointer,
+ *        and every interned string carries its hash, so string keys can be compared and hashed like integers.
+ * @note - Interned strings are read-only, and stay valid until the RoyInternPool is deleted.
+ * @note - A RoyInternPool must not be used by several threads at the same time.
+ */
+typedef struct RoyInternPool_ RoyInternPool;
+
+/* CONSTRUCTION AND DESTRUCTION */
+
+/**
+ * @brief Creates an empty RoyInternPool on a RoyUSet.
+ * @param bucket_count - number of buckets of the underlying RoyUSet, about the number of distinct strings expected.
+ * @return The newly build RoyInternPool.
+ */
+RoyInternPool * roy_intern_pool_new(size_t bucket_count);
+
+/**
+ * @brief Releases all the interned strings and destroys the RoyInternPool - 'pool' itself.
+ * @note - Always call this function after the work is done by the given 'pool' to get rid of memory leaking.
+ */
+void roy_intern_pool_delete(RoyInternPool * pool, void * user_data);
+
+/* CAPACITY */
+
+/// @brief Returns the number of distinct strings in 'pool'.
+size_t roy_intern_pool_size(const RoyInternPool * pool);
+
+/* MODIFIERS */
+
+/**
+ * @brief Interns 'str' into 'pool'.
+ * @return the canonical copy of 'str', which is terminated by '\0'.
+ */
+const char * roy_intern_pool_intern(RoyInternPool * pool, const char * str);
+
+/**
+ * @brief Interns the first 'length' characters of 'str' into 'pool', 'str' needs not be terminated by '\0'.
+ * @return the canonical copy of the characters, which is terminated by '\0'.
+ */
+const char * roy_intern_pool_intern_n(RoyInternPool * pool, const char * str, size_t length);
+
+/// @brief Interns the content of 'string' into 'pool', see 'roy_intern_pool_intern_n'.
+const char * roy_intern_pool_intern_string(RoyInternPool * pool, const RoyString * string);
+
+/* LOOKUPS */
+
+/**
+ * @brief Finds the canonical copy of 'str' without interning it.
+ * @return the canonical copy of 'str'.
+ * @return NULL - 'str' has never been interned into 'pool'.
+ */
+const char * roy_intern_pool_find(const RoyInternPool * pool, const char * str);
+
+/* INTERNED STRINGS */
+
+/// @brief Returns the hash of an 'interned' string in constant time.
+uint64_t roy_interned_hash(const char * interned);
+
+/// @brief Returns the length of an 'interned' string in constant time.
+size_t roy_interned_length(const char * interned);
+
+/**
+ * @brief An RHash for containers whose keys are interned strings, returns the stored hash of 'key'.
+ * @note - 'key_size' and 'seed' are ignored.
+ */
+uint64_t roy_interned_key_hash(const void * key, size_t key_size, uint64_t seed);
+
+/**
+ * @brief An RComparer for interned strings, compares the pointers only.
+ * @note - The order is consistent but arbitrary, it is not the lexicographical order.
+ */
+int roy_interned_compare(const void * lhs, const void * rhs);
+
+#endif // ROYINTERNPOOL_H
@@ -0,0 +1,112 @@
+#include "roylinereader.h"
+#include <errno.h>
+#include <unistd.h>
+
+struct RoyLineReader_ {
+  char   * buffer;
+  size_t   capacity;
+  size_t   begin;      // the first character not handed out yet
+  size_t   scanned;    // [begin, scanned) is known to hold no '\n'
+  size_t   end;
+  size_t   line_count;
+  int      fd;
+  bool     eof;
+  bool     error;      // a read failed, the input is not known to be complete
+};
+
+static void refill(RoyLineReader * reader);
+
+RoyLineReader *
+roy_line_reader_new(int fd) {
+  RoyLineReader * ret = malloc(sizeof(RoyLineReader));
+  ret->buffer     = malloc(ROY_LINE_READER_CHUNK_SIZE);
+  ret->capacity   = ROY_LINE_READER_CHUNK_SIZE;
+  ret->begin      = 0;
+  ret->scanned    = 0;
+  ret->end        = 0;
+  ret->line_count = 0;
+  ret->fd         = fd;
+  ret->eof        = false;
+  ret->error      = false;
+  return ret;
+}
+
+RoyLineReader *
+roy_line_reader_new_file(FILE * fp) {
+  return roy_line_reader_new(fileno(fp));
+}
+
+void
+roy_line_reader_delete(RoyLineReader                * reader,
+                       __attribute__((unused)) void * user_data) {
+  free(reader->buffer);
+  free(reader);
+}
+
+bool
+roy_line_reader_next(RoyLineReader * reader,
+                     RoyStringView * line) {
+  while (true) {
+    const char * newline = memchr(reader->buffer + reader->scanned,
+                                  '\n',
+                                  reader->end - reader->scanned);
+    if (newline) {
+      *line = roy_string_view_make(reader->buffer + reader->begin,
+                                   newline - (reader->buffer + reader->begin));
+      reader->begin = reader->scanned = newline - reader->buffer + 1;
+      break;
+    }
+    reader->scanned = reader->end;
+    if (reader->error) {
+      return false;
+    }
+    if (reader->eof) {
+      if (reader->begin == reader->end) {
+        return false;
+      }
+      *line = roy_string_view_make(reader->buffer + reader->begin, reader->end - reader->begin);
+      reader->begin = reader->scanned = reader->end;
+      break;
+    }
+    refill(reader);
+  }
+  reader->line_count++;
+  return true;
+}
+
+size_t
+roy_line_reader_line_count(const RoyLineReader * reader) {
+  return reader->line_count;
+}
+
+bool
+roy_line_reader_error(const RoyLineReader * reader) {
+  return reader->error;
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+/* Moves the unfinished line to the front of the buffer, doubles the buffer if the line fills it up,
+   then reads as much as the rest of the buffer holds. */
+static void
+refill(RoyLineReader * reader) {
+  size_t pending = reader->end - reader->begin;
+  memmove(reader->buffer, reader->buffer + reader->begin, pending);
+  reader->begin   = 0;
+  reader->scanned = reader->end = pending;
+  if (pending == reader->capacity) {
+    reader->capacity *= 2;
+    reader->buffer    = realloc(reader->buffer, reader->capacity);
+  }
+  ssize_t count;
+  do {
+    count = read(reader->fd, reader->buffer + reader->end, reader->capacity - reader->end);
+  } while (count == -1 && errno == EINTR);
+  if (count > 0) {
+    reader->end += count;
+  } else if (count == 0) {
+    reader->eof = true;
+  } else {
+    reader->error = true;
+  }
+}
@@ -0,0 +1,56 @@
+#ifndef ROYLINEREADER_H
+#define ROYLINEREADER_H
+
+#include "../util/rpre.h"
+#include "roystringview.h"
+
+enum {
+  ROY_LINE_READER_CHUNK_SIZE = 0x40000
+};
+
+/**
+ * @brief RoyLineReader: reads a file descriptor in large chunks, and hands out its lines one by one without copying.
+ * @note - Lines of any length are supported, the buffer grows to hold the longest line.
+ */
+typedef struct RoyLineReader_ RoyLineReader;
+
+/* CONSTRUCTION AND DESTRUCTION */
+
+/**
+ * @brief Creates a RoyLineReader on file descriptor 'fd'.
+ * @note - 'fd' is not owned by the reader, close it after the reader is deleted.
+ */
+RoyLineReader * roy_line_reader_new(int fd);
+
+/**
+ * @brief Creates a RoyLineReader on the file descriptor of 'fp'.
+ * @note - The reader bypasses the buffer of 'fp', so 'fp' should not be read through stdio at the same time.
+ */
+RoyLineReader * roy_line_reader_new_file(FILE * fp);
+
+/// @brief Releases the buffer and destroys the RoyLineReader - 'reader' itself.
+void roy_line_reader_delete(RoyLineReader * reader, void * user_data);
+
+/* OPERATIONS */
+
+/**
+ * @brief Reads the next line.
+ * @param line - receives the line without its terminating '\n'.
+ * @retval true - a line is read.
+ * @retval false - the end of input is reached, or a read error occurs, see 'roy_line_reader_error' to tell them apart.
+ * @note - 'line' refers to the buffer of 'reader', which stays valid until the next call of this function.
+ * @note - The last line is returned even if it has no terminating '\n'.
+ */
+bool roy_line_reader_next(RoyLineReader * reader, RoyStringView * line);
+
+/// @brief Returns the number of lines read by 'reader' so far.
+size_t roy_line_reader_line_count(const RoyLineReader * reader);
+
+/**
+ * @brief Checks whether reading the input of 'reader' has failed.
+ * @retval true - a read error has occurred, the lines already returned may not be the whole input.
+ * @retval false - otherwise, i.e. 'roy_line_reader_next' returned false at the end of input.
+ */
+bool roy_line_reader_error(const RoyLineReader * reader);
+
+#endif // ROYLINEREADER_H
@@ -0,0 +1,221 @@
+#define PCRE2_CODE_UNIT_WIDTH 8
+
+#include "royregex.h"
+#include "../util/rhash.h"
+#include "../util/rstats.h"
+#include <pcre2.h>
+#include <pthread.h>
+
+struct RoyRegex_ {
+  pcre2_code * code;
+  size_t       capture_count;
+};
+
+typedef struct Entry_ {
+  uint64_t   hash;
+  char     * pattern;
+  RoyRegex * regex;
+} Entry;
+
+// The compiled-pattern cache of one thread, 'entries' are ordered from the most recently used.
+typedef struct Cache_ {
+  Entry              entries[ROY_REGEX_CACHE_CAPACITY];
+  size_t             size;
+  pcre2_match_data * data;
+  size_t             data_pairs;
+} Cache;
+
+static pthread_key_t    cache_key;
+static pthread_once_t   cache_key_once = PTHREAD_ONCE_INIT;
+static _Thread_local Cache * current_cache = NULL;
+
+static void make_cache_key(void);
+static Cache * local_cache(void);
+static void cache_delete(void * cache);
+static void cache_clear(Cache * cache);
+static void entry_clear(Entry * entry);
+static pcre2_match_data * local_match_data(const RoyRegex * regex);
+
+RoyRegex *
+roy_regex_new(const char * pattern) {
+  int err_code;
+  PCRE2_SIZE err_offset;
+  pcre2_code * code = pcre2_compile((PCRE2_SPTR)pattern,
+                                    PCRE2_ZERO_TERMINATED,
+                                    0U,
+                                    &err_code,
+                                    &err_offset,
+                                    NULL);
+  R_STATS_ADD(R_STATS_REGEX_COMPILES, 1);
+  if (code == NULL) {
+    return NULL;
+  }
+  // Falls back to the interpreter silently if pcre2 is built without JIT.
+  pcre2_jit_compile(code, PCRE2_JIT_COMPLETE);
+  uint32_t capture_count = 0;
+  pcre2_pattern_info(code, PCRE2_INFO_CAPTURECOUNT, &capture_count);
+  RoyRegex * ret = malloc(sizeof(RoyRegex));
+  ret->code          = code;
+  ret->capture_count = capture_count;
+  return ret;
+}
+
+void
+roy_regex_delete(RoyRegex * regex) {
+  if (regex) {
+    pcre2_code_free(regex->code);
+    free(regex);
+  }
+}
+
+const RoyRegex *
+roy_regex_cached(const char * pattern) {
+  Cache * cache = local_cache();
+  size_t length = strlen(pattern);
+  uint64_t hash = MurmurHash2(pattern, length, 0);
+  size_t i = 0;
+  while (i != cache->size &&
+         (cache->entries[i].hash != hash || strcmp(cache->entries[i].pattern, pattern) != 0)) {
+    i++;
+  }
+  Entry found;
+  if (i != cache->size) {
+    found = cache->entries[i];
+    R_STATS_ADD(R_STATS_REGEX_CACHE_HITS, 1);
+  } else {
+    RoyRegex * regex = roy_regex_new(pattern);
+    if (regex == NULL) {
+      return NULL;
+    }
+    if (cache->size == ROY_REGEX_CACHE_CAPACITY) {
+      entry_clear(&cache->entries[--cache->size]);
+    }
+    found.hash    = hash;
+    found.pattern = memcpy(malloc(length + 1), pattern, length + 1);
+    found.regex   = regex;
+    i = cache->size++;
+  }
+  memmove(cache->entries + 1, cache->entries, i * sizeof(Entry));
+  cache->entries[0] = found;
+  return found.regex;
+}
+
+void
+roy_regex_cache_clear(void) {
+  if (current_cache) {
+    cache_clear(current_cache);
+  }
+}
+
+size_t
+roy_regex_capture_count(const RoyRegex * regex) {
+  return regex->capture_count;
+}
+
+RoyMatch
+roy_regex_find(const RoyRegex * regex,
+               const char     * str,
+               size_t           length,
+               size_t           position) {
+  RoyMatch ret = roy_match_make_default();
+  if (position > length) {
+    return ret;
+  }
+  pcre2_match_data * data = local_match_data(regex);
+  if (pcre2_match(regex->code,
+                  (PCRE2_SPTR)str + position,
+                  length - position,
+                  0ULL,
+                  PCRE2_NOTEMPTY,
+                  data,
+                  NULL) >= 0) {
+    PCRE2_SIZE * ovector = pcre2_get_ovector_pointer(data);
+    ret.begin = ovector[0];
+    ret.end   = ovector[1];
+  }
+  return ret;
+}
+
+bool
+roy_regex_match(const RoyRegex * regex,
+                const char     * str,
+                size_t           length) {
+  RoyMatch match = roy_regex_find(regex, str, length, 0);
+  return match.begin == 0 && match.end == (int)length;
+}
+
+int
+roy_regex_literal(char       * dest,
+                  const char * pattern) {
+  int length = 0;
+  for (const char * cur = pattern; *cur != '\0'; cur++) {
+    if (length == ROY_REGEX_LITERAL_CAPACITY || strchr("^$.[|()?*+{", *cur)) {
+      return -1;
+    }
+    if (*cur == '\\') {
+      cur++;
+      if      (*cur == 't')                   { dest[length++] = '\t'; }
+      else if (*cur == 'n')                   { dest[length++] = '\n'; }
+      else if (*cur == 'r')                   { dest[length++] = '\r'; }
+      else if (ispunct((unsigned char)*cur)) { dest[length++] = *cur; }
+      else                                    { return -1; }
+    } else {
+      dest[length++] = *cur;
+    }
+  }
+  return length;
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+static void
+make_cache_key(void) {
+  pthread_key_create(&cache_key, cache_delete);
+}
+
+// The key is only used to release the cache when its thread exits.
+static Cache *
+local_cache(void) {
+  if (current_cache == NULL) {
+    pthread_once(&cache_key_once, make_cache_key);
+    current_cache = calloc(1, sizeof(Cache));
+    pthread_setspecific(cache_key, current_cache);
+  }
+  return current_cache;
+}
+
+static void
+cache_delete(void * cache) {
+  cache_clear(cache);
+  free(cache);
+  current_cache = NULL;
+}
+
+static void
+cache_clear(Cache * cache) {
+  for (size_t i = 0; i != cache->size; i++) {
+    entry_clear(&cache->entries[i]);
+  }
+  cache->size = 0;
+  pcre2_match_data_free(cache->data);
+  cache->data       = NULL;
+  cache->data_pairs = 0;
+}
+
+static void
+entry_clear(Entry * entry) {
+  free(entry->pattern);
+  roy_regex_delete(entry->regex);
+}
+
+// Every thread reuses one match data block, which is enlarged to hold all groups of 'regex'.
+static pcre2_match_data *
+local_match_data(const RoyRegex * regex) {
+  Cache * cache = local_cache();
+  if (cache->data_pairs <= regex->capture_count) {
+    pcre2_match_data_free(cache->data);
+    cache->data_pairs = regex->capture_count + 1;
+    cache->data       = pcre2_match_data_create(cache->data_pairs, NULL);
+  }
+  return cache->data;
+}
@@ -0,0 +1,81 @@
+#ifndef ROYREGEX_H
+#define ROYREGEX_H
+
+#include "../util/rpre.h"
+#include "../util/rmatch.h"
+
+enum {
+  ROY_REGEX_CACHE_CAPACITY   = 0x20,
+  ROY_REGEX_LITERAL_CAPACITY = 0x40
+};
+
+/**
+ * @brief RoyRegex: a regular expression compiled once by pcre2 (with JIT when available),
+ *        which can be matched any number of times, and by several threads at the same time.
+ */
+typedef struct RoyRegex_ RoyRegex;
+
+/* CONSTRUCTION AND DESTRUCTION */
+
+/**
+ * @brief Compiles 'pattern' into a RoyRegex.
+ * @return The newly build RoyRegex.
+ * @return NULL - 'pattern' is a ill-formed regex.
+ */
+RoyRegex * roy_regex_new(const char * pattern);
+
+/**
+ * @brief Releases the compiled code and destroys the RoyRegex - 'regex' itself.
+ * @note - Never delete a RoyRegex returned by 'roy_regex_cached'.
+ */
+void roy_regex_delete(RoyRegex * regex);
+
+/**
+ * @brief Looks 'pattern' up in the compiled-pattern cache of the calling thread, compiles it on a miss.
+ * @return the cached RoyRegex of 'pattern'.
+ * @return NULL - 'pattern' is a ill-formed regex.
+ * @note - Every thread keeps the ROY_REGEX_CACHE_CAPACITY most recently used patterns,
+ *         the least recently used one is deleted when a new pattern comes into a full cache.
+ * @note - The returned RoyRegex is owned by the cache, it stays valid until the calling thread
+ *         looks up ROY_REGEX_CACHE_CAPACITY other patterns or clears its cache.
+ */
+const RoyRegex * roy_regex_cached(const char * pattern);
+
+/**
+ * @brief Deletes all the cached patterns of the calling thread.
+ * @note - A cache is released automatically when its thread exits, call this function to release
+ *         the cache of the main thread, or to drop the patterns which are no longer needed.
+ */
+void roy_regex_cache_clear(void);
+
+/* ELEMENT ACCESS */
+
+/// @brief Returns the number of capturing groups in 'regex'.
+size_t roy_regex_capture_count(const RoyRegex * regex);
+
+/* OPERATIONS */
+
+/**
+ * @brief Finds the first non-empty match of 'regex' in 'str' after 'position'.
+ * @param length - number of characters in 'str', it needs no terminating '\0'.
+ * @param position - position at which to start the search from 'str'.
+ * @return the first match found relative to 'position', can be accessed by '.begin' '.end',
+ *         -1 if not found.
+ */
+RoyMatch roy_regex_find(const RoyRegex * regex, const char * str, size_t length, size_t position);
+
+/**
+ * @brief Tests whether the first 'length' characters of 'str' exactly match 'regex'.
+ */
+bool roy_regex_match(const RoyRegex * regex, const char * str, size_t length);
+
+/**
+ * @brief Checks whether 'pattern' only matches one fixed string, which can be searched without pcre2.
+ * @param dest - receives the fixed string without a terminating '\0', holds at least ROY_REGEX_LITERAL_CAPACITY characters.
+ * @return the length of the fixed string.
+ * @return -1 - 'pattern' has a metacharacter, or its fixed string is longer than ROY_REGEX_LITERAL_CAPACITY.
+ * @note - Besides plain characters, escaped punctuations like '\.' and the escapes '\t' '\n' '\r' are allowed.
+ */
+int roy_regex_literal(char * dest, const char * pattern);
+
+#endif // ROYREGEX_H
@@ -0,0 +1,480 @@
+#include "royrope.h"
+
+enum {
+  LEAF_CAPACITY = 0x200,
+  HEIGHT_MAX    = 0x80
+};
+
+// A leaf holds 'length' characters in 'data', an inner node holds no character but always has both children.
+typedef struct Node_ {
+  struct Node_ * left;
+  struct Node_ * right;
+  size_t         length;
+  size_t         refs;
+  int            height;
+  char           data[];
+} Node;
+
+struct RoyRope_ {
+  Node * root;
+};
+
+/* Unless a Node is passed as const, a function consumes the reference passed in,
+   and every Node returned is a reference owned by the caller. */
+static Node * leaf_new(const char * str, size_t length);
+static Node * leaf_merge(Node * left, Node * right);
+static Node * inner_new(Node * left, Node * right);
+static Node * build(const char * str, size_t length);
+static Node * retain(Node * node);
+static void release(Node * node);
+static int height(const Node * node);
+static size_t length_of(const Node * node);
+static void unpack(Node * node, Node ** left, Node ** right);
+static Node * rebalance(Node * left, Node * right);
+static Node * join(Node * left, Node * right);
+static void split(Node * node, size_t position, Node ** left, Node ** right);
+static void splice(RoyRope * rope, size_t position, size_t count, Node * piece);
+static bool edit_leaf(RoyRope * rope, const char * substr, size_t length, size_t position, size_t count);
+static void extract(const Node * node, char * dest, size_t position, size_t count);
+static void append_leaves(const Node * node, RoyString * string);
+static bool valid_pos_cnt(const RoyRope * rope, size_t position, size_t count);
+
+RoyRope *
+roy_rope_new(const char * str) {
+  RoyRope * ret = roy_rope_new_empty();
+  ret->root = build(str, strlen(str));
+  return ret;
+}
+
+RoyRope *
+roy_rope_new_empty(void) {
+  RoyRope * ret = malloc(sizeof(RoyRope));
+  ret->root = NULL;
+  return ret;
+}
+
+RoyRope *
+roy_rope_new_string(const RoyString * string) {
+  RoyRope * ret = roy_rope_new_empty();
+  ret->root = build(roy_string_cstr(string, 0), roy_string_length(string));
+  return ret;
+}
+
+RoyRope *
+roy_rope_copy(const RoyRope * other) {
+  RoyRope * ret = roy_rope_new_empty();
+  ret->root = retain(other->root);
+  return ret;
+}
+
+void
+roy_rope_delete(RoyRope                      * rope,
+                __attribute__((unused)) void * user_data) {
+  release(rope->root);
+  free(rope);
+}
+
+int
+roy_rope_at(const RoyRope * rope,
+            size_t          position) {
+  if (position >= roy_rope_length(rope)) {
+    return '\0';
+  }
+  const Node * node = rope->root;
+  while (node->left) {
+    if (position < node->left->length) {
+      node = node->left;
+    } else {
+      position -= node->left->length;
+      node = node->right;
+    }
+  }
+  return node->data[position];
+}
+
+size_t
+roy_rope_length(const RoyRope * rope) {
+  return length_of(rope->root);
+}
+
+bool
+roy_rope_empty(const RoyRope * rope) {
+  return roy_rope_length(rope) == 0;
+}
+
+bool
+roy_rope_insert(RoyRope    * restrict rope,
+                const char * restrict substr,
+                size_t                position) {
+  return roy_rope_replace(rope, substr, position, 0);
+}
+
+bool
+roy_rope_insert_rope(RoyRope       * rope,
+                     const RoyRope * other,
+                     size_t          position) {
+  if (valid_pos_cnt(rope, position, 0)) {
+    // Takes the reference first, since splicing 'rope' may release the root of 'other'.
+    splice(rope, position, 0, retain(other->root));
+    return true;
+  }
+  return false;
+}
+
+void
+roy_rope_prepend(RoyRope    * restrict rope,
+                 const char * restrict substr) {
+  roy_rope_insert(rope, substr, 0);
+}
+
+void
+roy_rope_append(RoyRope    * restrict rope,
+                const char * restrict substr) {
+  roy_rope_insert(rope, substr, roy_rope_length(rope));
+}
+
+bool
+roy_rope_erase(RoyRope * rope,
+               size_t    position,
+               size_t    count) {
+  return roy_rope_replace(rope, "", position, count);
+}
+
+bool
+roy_rope_replace(RoyRope    * restrict rope,
+                 const char * restrict substr,
+                 size_t                position,
+                 size_t                count) {
+  if (valid_pos_cnt(rope, position, count)) {
+    size_t length = strlen(substr);
+    if (!edit_leaf(rope, substr, length, position, count)) {
+      splice(rope, position, count, build(substr, length));
+    }
+    return true;
+  }
+  return false;
+}
+
+void
+roy_rope_clear(RoyRope * rope) {
+  release(rope->root);
+  rope->root = NULL;
+}
+
+bool
+roy_rope_substring(RoyRope       * dest,
+                   const RoyRope * src,
+                   size_t          position,
+                   size_t          count) {
+  if (valid_pos_cnt(src, position, count)) {
+    Node * left, * middle, * right;
+    split(retain(src->root), position, &left, &right);
+    release(left);
+    split(right, count, &middle, &right);
+    release(right);
+    release(dest->root);
+    dest->root = middle;
+    return true;
+  }
+  return false;
+}
+
+bool
+roy_rope_extract(char          * restrict dest,
+                 const RoyRope * restrict rope,
+                 size_t                   position,
+                 size_t                   count) {
+  if (valid_pos_cnt(rope, position, count)) {
+    extract(rope->root, dest, position, count);
+    return true;
+  }
+  return false;
+}
+
+RoyString *
+roy_rope_to_string(const RoyRope * rope) {
+  RoyString * ret = roy_string_new_empty();
+  roy_string_reserve(ret, roy_rope_length(rope));
+  append_leaves(rope->root, ret);
+  return ret;
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+static Node *
+leaf_new(const char * str,
+         size_t       length) {
+  Node * ret = malloc(sizeof(Node) + length);
+  ret->left   = NULL;
+  ret->right  = NULL;
+  ret->length = length;
+  ret->refs   = 1;
+  ret->height = 0;
+  memcpy(ret->data, str, length);
+  return ret;
+}
+
+static Node *
+leaf_merge(Node * left,
+           Node * right) {
+  Node * ret = malloc(sizeof(Node) + left->length + right->length);
+  ret->left   = NULL;
+  ret->right  = NULL;
+  ret->length = left->length + right->length;
+  ret->refs   = 1;
+  ret->height = 0;
+  memcpy(ret->data, left->data, left->length);
+  memcpy(ret->data + left->length, right->data, right->length);
+  release(left);
+  release(right);
+  return ret;
+}
+
+static Node *
+inner_new(Node * left,
+          Node * right) {
+  Node * ret = malloc(sizeof(Node));
+  ret->left   = left;
+  ret->right  = right;
+  ret->length = left->length + right->length;
+  ret->refs   = 1;
+  ret->height = (left->height > right->height ? left->height : right->height) + 1;
+  return ret;
+}
+
+// Builds a perfectly balanced tree of full leaves.
+static Node *
+build(const char * str,
+      size_t       length) {
+  if (length == 0) {
+    return NULL;
+  }
+  if (length <= LEAF_CAPACITY) {
+    return leaf_new(str, length);
+  }
+  size_t leaf_count = (length + LEAF_CAPACITY - 1) / LEAF_CAPACITY;
+  size_t left_length = leaf_count / 2 * LEAF_CAPACITY;
+  return inner_new(build(str, left_length), build(str + left_length, length - left_length));
+}
+
+static Node *
+retain(Node * node) {
+  if (node) {
+    node->refs++;
+  }
+  return node;
+}
+
+static void
+release(Node * node) {
+  if (node && --node->refs == 0) {
+    release(node->left);
+    release(node->right);
+    free(node);
+  }
+}
+
+static int
+height(const Node * node) {
+  return node ? node->height : -1;
+}
+
+static size_t
+length_of(const Node * node) {
+  return node ? node->length : 0;
+}
+
+// Takes the children of an inner 'node' out, the node itself is released.
+static void
+unpack(Node  * node,
+       Node ** left,
+       Node ** right) {
+  *left  = retain(node->left);
+  *right = retain(node->right);
+  release(node);
+}
+
+// Joins two balanced trees whose heights differ by at most 2 with one single or double rotation.
+static Node *
+rebalance(Node * left,
+          Node * right) {
+  Node * inner_left, * inner_right, * middle_left, * middle_right;
+  if (height(left) > height(right) + 1) {
+    unpack(left, &inner_left, &inner_right);
+    if (height(inner_left) >= height(inner_right)) {
+      return inner_new(inner_left, inner_new(inner_right, right));
+    }
+    unpack(inner_right, &middle_left, &middle_right);
+    return inner_new(inner_new(inner_left, middle_left), inner_new(middle_right, right));
+  }
+  if (height(right) > height(left) + 1) {
+    unpack(right, &inner_left, &inner_right);
+    if (height(inner_right) >= height(inner_left)) {
+      return inner_new(inner_new(left, inner_left), inner_right);
+    }
+    unpack(inner_left, &middle_left, &middle_right);
+    return inner_new(inner_new(left, middle_left), inner_new(middle_right, inner_right));
+  }
+  return inner_new(left, right);
+}
+
+/* Concatenates two balanced trees by descending the taller one to the height of the other,
+   which takes time proportional to the difference of their heights. */
+static Node *
+join(Node * left,
+     Node * right) {
+  if (left == NULL) {
+    return right;
+  }
+  if (right == NULL) {
+    return left;
+  }
+  Node * inner_left, * inner_right;
+  if (left->left == NULL && right->left == NULL && left->length + right->length <= LEAF_CAPACITY) {
+    // Two small neighbouring leaves are merged, so that small edits do not fragment the chunks.
+    return leaf_merge(left, right);
+  }
+  if (height(left) > height(right) + 1) {
+    unpack(left, &inner_left, &inner_right);
+    return rebalance(inner_left, join(inner_right, right));
+  }
+  if (height(right) > height(left) + 1) {
+    unpack(right, &inner_left, &inner_right);
+    return rebalance(join(left, inner_left), inner_right);
+  }
+  return inner_new(left, right);
+}
+
+// Splits 'node' into the characters before 'position' and the rest.
+static void
+split(Node   * node,
+      size_t   position,
+      Node  ** left,
+      Node  ** right) {
+  if (position == 0) {
+    *left  = NULL;
+    *right = node;
+  } else if (position == length_of(node)) {
+    *left  = node;
+    *right = NULL;
+  } else if (node->left == NULL) {
+    *left  = leaf_new(node->data, position);
+    *right = leaf_new(node->data + position, node->length - position);
+    release(node);
+  } else {
+    Node * inner_left, * inner_right, * middle;
+    unpack(node, &inner_left, &inner_right);
+    if (position <= inner_left->length) {
+      split(inner_left, position, left, &middle);
+      *right = join(middle, inner_right);
+    } else {
+      split(inner_right, position - inner_left->length, &middle, right);
+      *left = join(inner_left, middle);
+    }
+  }
+}
+
+// Replaces [position, position + count) of 'rope' with 'piece'.
+static void
+splice(RoyRope * rope,
+       size_t    position,
+       size_t    count,
+       Node    * piece) {
+  Node * left, * middle, * right;
+  split(rope->root, position, &left, &right);
+  split(right, count, &middle, &right);
+  release(middle);
+  rope->root = join(join(left, piece), right);
+}
+
+/* Edits the leaf holding all of [position, position + count) in place, which takes no allocation at all.
+   Only possible if no node on the way is shared, and the leaf neither overflows nor becomes empty. */
+static bool
+edit_leaf(RoyRope    * rope,
+          const char * substr,
+          size_t       length,
+          size_t       position,
+          size_t       count) {
+  Node ** path[HEIGHT_MAX];
+  size_t depth = 0;
+  Node ** slot = &rope->root;
+  while (*slot && (*slot)->refs == 1 && (*slot)->left) {
+    path[depth++] = slot;
+    Node * node = *slot;
+    if (position + count <= node->left->length) {
+      slot = &node->left;
+    } else if (position >= node->left->length) {
+      position -= node->left->length;
+      slot = &node->right;
+    } else {
+      return false;
+    }
+  }
+  Node * leaf = *slot;
+  if (leaf == NULL || leaf->refs != 1 || leaf->left) {
+    return false;
+  }
+  size_t leaf_length = leaf->length - count + length;
+  if (leaf_length == 0 || leaf_length > LEAF_CAPACITY) {
+    return false;
+  }
+  if (leaf_length > leaf->length) {
+    leaf = *slot = realloc(leaf, sizeof(Node) + leaf_length);
+  }
+  memmove(leaf->data + position + length,
+          leaf->data + position + count,
+          leaf->length - position - count);
+  memcpy(leaf->data + position, substr, length);
+  leaf->length = leaf_length;
+  while (depth != 0) {
+    Node * node = *path[--depth];
+    node->length = node->left->length + node->right->length;
+  }
+  return true;
+}
+
+static void
+extract(const Node * node,
+        char       * dest,
+        size_t       position,
+        size_t       count) {
+  while (count != 0) {
+    if (node->left == NULL) {
+      memcpy(dest, node->data + position, count);
+      return;
+    }
+    if (position < node->left->length) {
+      size_t left_count = node->left->length - position;
+      left_count = left_count < count ? left_count : count;
+      extract(node->left, dest, position, left_count);
+      dest     += left_count;
+      count    -= left_count;
+      position  = 0;
+    } else {
+      position -= node->left->length;
+    }
+    node = node->right;
+  }
+}
+
+static void
+append_leaves(const Node * node,
+              RoyString  * string) {
+  if (node == NULL) {
+    return;
+  }
+  if (node->left == NULL) {
+    roy_string_append_n(string, node->data, node->length);
+  } else {
+    append_leaves(node->left, string);
+    append_leaves(node->right, string);
+  }
+}
+
+static bool
+valid_pos_cnt(const RoyRope * rope,
+              size_t          position,
+              size_t          count) {
+  size_t length = roy_rope_length(rope);
+  return (position <= length) && (count <= length - position);
+}
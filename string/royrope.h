@@ -0,0 +1,117 @@
+#ifndef ROYROPE_H
+#define ROYROPE_H
+
+#include "../util/rpre.h"
+#include "roystring.h"
+
+/**
+ * @brief RoyRope: a string stored as a height-balanced tree of immutable character chunks,
+ *        which edits and indexes large texts in logarithmic time.
+ * @note - Copies and substrings share their chunks with the original RoyRope, editing either never affects the other.
+ * @note - RoyRopes which share chunks must not be used by several threads at the same time.
+ */
+typedef struct RoyRope_ RoyRope;
+
+/* CONSTRUCTION AND DESTRUCTION */
+
+/// @brief Constructs a RoyRope with given 'str'.
+RoyRope * roy_rope_new(const char * str);
+
+/// @brief Constructs a nil RoyRope.
+RoyRope * roy_rope_new_empty(void);
+
+/// @brief Constructs a RoyRope with the content of 'string'.
+RoyRope * roy_rope_new_string(const RoyString * string);
+
+/// @brief Constructs a RoyRope with the content of another RoyRope, in constant time by sharing all chunks.
+RoyRope * roy_rope_copy(const RoyRope * other);
+
+/**
+ * @brief Releases the chunks no longer shared and destroys the RoyRope - 'rope' itself.
+ * @note - Always call this function after the work is done by the given 'rope' to get rid of memory leaking.
+ */
+void roy_rope_delete(RoyRope * rope, void * user_data);
+
+/* CHARACTER ACCESS */
+
+/**
+ * @brief Accesses the specified character in logarithmic time.
+ * @return the character at 'position'.
+ * @return '\0' - if 'position' exceeds.
+ */
+int roy_rope_at(const RoyRope * rope, size_t position);
+
+/* CAPACITY */
+
+/// @brief Returns the number of characters in 'rope'.
+size_t roy_rope_length(const RoyRope * rope);
+
+/// @brief Checks whether 'rope' is empty.
+bool roy_rope_empty(const RoyRope * rope);
+
+/* MODIFIERS */
+
+/**
+ * @brief Inserts characters into 'rope' in logarithmic time, plus the time to chunk 'substr'.
+ * @param substr - additional C char-array to insert.
+ * @param position - position before which the characters will be inserted.
+ * @retval true - the operation is successful.
+ * @retval false - 'position' exceeds.
+ */
+bool roy_rope_insert(RoyRope * restrict rope, const char * restrict substr, size_t position);
+
+/**
+ * @brief Inserts all characters of 'other' into 'rope' in logarithmic time, sharing the chunks of 'other'.
+ * @param position - position before which the characters will be inserted.
+ * @retval true - the operation is successful.
+ * @retval false - 'position' exceeds.
+ * @note 'rope' and 'other' can be identical.
+ */
+bool roy_rope_insert_rope(RoyRope * rope, const RoyRope * other, size_t position);
+
+/// @brief Adds additional characters to the left end of 'rope'.
+void roy_rope_prepend(RoyRope * restrict rope, const char * restrict substr);
+
+/// @brief Adds additional characters to the right end of 'rope'.
+void roy_rope_append(RoyRope * restrict rope, const char * restrict substr);
+
+/**
+ * @brief Removes characters from 'rope' in logarithmic time.
+ * @param position - position of the first character to be removed.
+ * @param count - number of characters to be removed.
+ * @retval true - the operation is successful.
+ * @retval false - 'position' or 'position' + 'count' exceeds.
+ */
+bool roy_rope_erase(RoyRope * rope, size_t position, size_t count);
+
+/**
+ * @brief Replaces [position, position + count) of 'rope' with 'substr'.
+ * @retval true - the operation is successful.
+ * @retval false - 'position' or 'position' + 'count' exceeds.
+ */
+bool roy_rope_replace(RoyRope * restrict rope, const char * restrict substr, size_t position, size_t count);
+
+/// @brief Clears the contents of 'rope'.
+void roy_rope_clear(RoyRope * rope);
+
+/* OPERATIONS */
+
+/**
+ * @brief Makes 'dest' the substring [position, position + count) of 'src' in logarithmic time, sharing the chunks of 'src'.
+ * @retval true - the operation is successful.
+ * @retval false - 'position' or 'position' + 'count' exceeds.
+ * @note 'dest' and 'src' can be identical for self operation.
+ */
+bool roy_rope_substring(RoyRope * dest, const RoyRope * src, size_t position, size_t count);
+
+/**
+ * @brief Copies [position, position + count) of 'rope' into 'dest', no terminating '\0' is added.
+ * @retval true - the operation is successful.
+ * @retval false - 'position' or 'position' + 'count' exceeds.
+ */
+bool roy_rope_extract(char * restrict dest, const RoyRope * restrict rope, size_t position, size_t count);
+
+/// @brief Constructs a RoyString with all characters of 'rope'.
+RoyString * roy_rope_to_string(const RoyRope * rope);
+
+#endif // ROYROPE_H
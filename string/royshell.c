@@ -1,5 +1,7 @@
 #include "royshell.h"
 #include "../util/rpair.h"
+#include "roylinereader.h"
+#include <unistd.h>
 
 struct RoyShell_ {
   RoyMap    * dict;
@@ -9,6 +11,7 @@ struct RoyShell_ {
   RoyDeque  * argv;
   RoyDeque  * ivector;
   RoyDeque  * ovector;
+  RoyLineReader * reader;
 };
 
 static void pair_deleter(RoyPair * pair, void * user_data);
@@ -24,12 +27,14 @@ roy_shell_new(void) {
   ret->argv      = roy_deque_new((RDoer)roy_string_delete);
   ret->ivector   = roy_deque_new((RDoer)roy_string_delete);
   ret->ovector   = roy_deque_new((RDoer)roy_string_delete);
+  ret->reader    = roy_line_reader_new(STDIN_FILENO);
   return ret;
 }
 
 void
 roy_shell_delete(RoyShell * shell,
                  void     * user_data) {
+  roy_line_reader_delete(shell->reader, user_data);
   roy_deque_delete (shell->ovector, user_data);
   roy_deque_delete (shell->ivector, user_data);
   roy_deque_delete (shell->argv,    user_data);
@@ -42,9 +47,17 @@ roy_shell_delete(RoyShell * shell,
 
 void
 roy_shell_start(RoyShell * shell) {
+  RoyStringView line;
   while (true) {
     roy_string_print(shell->prompt);
-    roy_string_scan(shell->ibuffer, R_BUF_SIZE);
+    fflush(stdout);
+    if (!roy_line_reader_next(shell->reader, &line)) {
+      if (roy_line_reader_error(shell->reader)) {
+        perror("roy_shell_start");
+      }
+      break;
+    }
+    roy_string_assign_n(shell->ibuffer, line.str, line.length);
     roy_deque_clear(shell->argv, NULL);
     if (roy_string_split(shell->argv, shell->ibuffer, "\\s+") > 0) {
       // If cmd (aka first token in argv) cannot be found in dict,
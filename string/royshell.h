@@ -20,7 +20,10 @@ RoyShell * roy_shell_new(void);
  */
 void roy_shell_delete(RoyShell * shell, void * user_data);
 
-/// @brief Starts a simulation.
+/**
+ * @brief Starts a simulation, which reads commands line by line from stdin.
+ * @note - Returns when the end of stdin is reached, lines of any length are supported.
+ */
 void roy_shell_start(RoyShell * shell);
 
 /**
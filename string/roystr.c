@@ -1,20 +1,73 @@
 #include "roystr.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// AVX2 kernels are compiled with a target attribute, and chosen at run time if the processor supports them.
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define ROY_STR_AVX2
+#endif
+
+enum {
+  CHARSET_LIST_CAPACITY = 0x10,
+  SAD_ROUNDS            = 0xFF
+};
+
+// A set of characters, as a bitmap for scalar tests, and as a list for vector compares if it is small enough.
+typedef struct Charset_ {
+  uint64_t bits[4];
+  char     list[CHARSET_LIST_CAPACITY];
+  size_t   count;
+} Charset;
+
+// Every kernel works on exactly 'length' characters of 'str', a '\0' among them is an ordinary character.
+typedef struct Kernels_ {
+  size_t (* count_char)  (const char * str, size_t length, char ch);
+  void   (* replace_char)(char * str, size_t length, char old_ch, char new_ch);
+  void   (* flip_case)   (char * str, size_t length, char first, char last);
+  size_t (* span_out)    (const char * str, size_t length, const Charset * charset);
+} Kernels;
+
+static Kernels        kernels;
+static pthread_once_t kernels_once = PTHREAD_ONCE_INIT;
+
+static const Kernels * local_kernels(void);
+static void choose_kernels(void);
+static void charset_make(Charset * charset, const char * set);
+static bool charset_has(const Charset * charset, char ch);
+static int write_file(const char * src, const char * path, int flags);
+static size_t count_char_scalar(const char * str, size_t length, char ch);
+static void replace_char_scalar(char * str, size_t length, char old_ch, char new_ch);
+static void flip_case_scalar(char * str, size_t length, char first, char last);
+static size_t span_out_scalar(const char * str, size_t length, const Charset * charset);
+#ifdef __SSE2__
+static size_t count_char_sse2(const char * str, size_t length, char ch);
+static void replace_char_sse2(char * str, size_t length, char old_ch, char new_ch);
+static void flip_case_sse2(char * str, size_t length, char first, char last);
+static size_t span_out_sse2(const char * str, size_t length, const Charset * charset);
+#endif
+#ifdef ROY_STR_AVX2
+static size_t count_char_avx2(const char * str, size_t length, char ch);
+static void replace_char_avx2(char * str, size_t length, char old_ch, char new_ch);
+static void flip_case_avx2(char * str, size_t length, char first, char last);
+static size_t span_out_avx2(const char * str, size_t length, const Charset * charset);
+#endif
 
 char *
 roy_str_to_lower(char * str) {
-  char * pstr = str;
-  while ((*pstr = tolower(*pstr)) != '\0') {
-    pstr++;
-  }
+  local_kernels()->flip_case(str, strlen(str), 'A', 'Z');
   return str;
 }
 
 char *
 roy_str_to_upper(char * str) {
-  char * pstr = str;
-  while ((*pstr = toupper(*pstr)) != '\0') {
-    pstr++;
-  }
+  local_kernels()->flip_case(str, strlen(str), 'a', 'z');
   return str;
 }
 
@@ -121,13 +174,7 @@ char *
 roy_str_replace_all_char(char * str,
                          int    old_ch,
                          int    new_ch) {
-  char * pstr = str;
-  while (*pstr != '\0') {
-    if (*pstr == old_ch) {
-      *pstr = new_ch;
-    }
-    pstr++;
-  }
+  local_kernels()->replace_char(str, strlen(str), old_ch, new_ch);
   return str;
 }
 
@@ -324,28 +371,31 @@ roy_str_fold(char   * str,
 char *
 roy_str_squeeze(char       * str,
                 const char * set) {
-  int i = 0, j = 0;
-  while (*(str + i) != '\0') {
-    if (strchr(set, *(str + i))) { /* current character belongs to 'set' */
+  const Kernels * kernel = local_kernels();
+  Charset charset;
+  charset_make(&charset, set);
+  size_t length = strlen(str);
+  size_t i = 0, j = 0;
+  while (i != length) {
+    // Moves the run of characters out of 'set' as a whole, then skips the run of characters in 'set'.
+    size_t span = kernel->span_out(str + i, length - i, &charset);
+    if (i != j) {
+      memmove(str + j, str + i, span);
+    }
+    i += span;
+    j += span;
+    while (i != length && charset_has(&charset, str[i])) {
       i++;
-    } else {
-      *(str + j++) = *(str + i++);
     }
   }
-  *(str + j) = '\0';
+  str[j] = '\0';
   return str;
 }
 
 size_t
 roy_str_count_char(const char * str,
                    int          ch) {
-  size_t count = 0;
-  while (*str != '\0') {
-    if (*str++ == ch) {
-      count ++;
-    }
-  }
-  return count;
+  return local_kernels()->count_char(str, strlen(str), ch);
 }
 
 size_t
@@ -461,41 +511,333 @@ roy_str_line_length(const char * str,
 int
 roy_str_break_index(const char * str,
                     const char * set) {
-  int pos = 0;
-  while (*(str + pos) != '\0' && !strchr(set, *(str + pos))) {
-    pos++;
-  }
-  return pos;
+  Charset charset;
+  charset_make(&charset, set);
+  return local_kernels()->span_out(str, strlen(str), &charset);
 }
 
 char *
 roy_str_read_from_file(char       * dest,
+                       size_t       capacity,
                        const char * path) {
-  FILE * fp = fopen(path, "r");
-  ROY_STR(buf, R_BUF_SIZE)
-  fgets(buf, R_BUF_SIZE, fp);
-  strcpy(dest, buf);
-  while (fgets(buf, R_BUF_SIZE, fp)) {
-    strcat(dest, buf);
-  }
-  fclose(fp);
+  if (capacity == 0) {
+    return dest;
+  }
+  FILE * fp = fopen(path, "rb");
+  size_t length = 0;
+  if (fp) {
+    size_t count;
+    while (length != capacity - 1 &&
+           (count = fread(dest + length, sizeof(char), capacity - 1 - length, fp)) != 0) {
+      length += count;
+    }
+    fclose(fp);
+  }
+  dest[length] = '\0';
   return dest;
 }
 
 int
 roy_str_append_to_file(const char * src,
                        const char * path) {
-  FILE * fp = fopen(path, "a+");
-  int ret = fputs(src, fp);
-  fclose(fp);
-  return ret;
+  return write_file(src, path, O_APPEND);
 }
 
 int
 roy_str_write_to_file(const char * src,
                       const char * path) {
-  FILE * fp = fopen(path, "w+");
-  int ret = fputs(src, fp);
-  fclose(fp);
-  return ret;
-}
\ No newline at end of file
+  return write_file(src, path, O_TRUNC);
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+// Writes 'src' by one 'write' in most cases, without the stdio buffer which would only be used once.
+static int
+write_file(const char * src,
+           const char * path,
+           int          flags) {
+  int fd = open(path, O_WRONLY | O_CREAT | flags, 0644);
+  if (fd == -1) {
+    return EOF;
+  }
+  size_t length = strlen(src);
+  while (length != 0) {
+    ssize_t written = write(fd, src, length);
+    if (written == -1 && errno != EINTR) {
+      break;
+    }
+    if (written > 0) {
+      src    += written;
+      length -= written;
+    }
+  }
+  close(fd);
+  return length == 0 ? 0 : EOF;
+}
+
+static const Kernels *
+local_kernels(void) {
+  pthread_once(&kernels_once, choose_kernels);
+  return &kernels;
+}
+
+static void
+choose_kernels(void) {
+  Kernels scalar = { count_char_scalar, replace_char_scalar, flip_case_scalar, span_out_scalar };
+  kernels = scalar;
+#ifdef __SSE2__
+  Kernels sse2 = { count_char_sse2, replace_char_sse2, flip_case_sse2, span_out_sse2 };
+  kernels = sse2;
+#endif
+#ifdef ROY_STR_AVX2
+  if (__builtin_cpu_supports("avx2")) {
+    Kernels avx2 = { count_char_avx2, replace_char_avx2, flip_case_avx2, span_out_avx2 };
+    kernels = avx2;
+  }
+#endif
+}
+
+static void
+charset_make(Charset    * charset,
+             const char * set) {
+  memset(charset, 0, sizeof(Charset));
+  for (; *set != '\0'; set++) {
+    if (!charset_has(charset, *set)) {
+      unsigned char ch = *set;
+      charset->bits[ch >> 6] |= 1ULL << (ch & 0x3F);
+      if (charset->count < CHARSET_LIST_CAPACITY) {
+        charset->list[charset->count] = *set;
+      }
+      charset->count++;
+    }
+  }
+}
+
+static bool
+charset_has(const Charset * charset,
+            char            ch) {
+  unsigned char uch = ch;
+  return (charset->bits[uch >> 6] >> (uch & 0x3F)) & 1;
+}
+
+static size_t
+count_char_scalar(const char * str,
+                  size_t       length,
+                  char         ch) {
+  size_t count = 0;
+  for (size_t i = 0; i != length; i++) {
+    count += str[i] == ch;
+  }
+  return count;
+}
+
+static void
+replace_char_scalar(char   * str,
+                    size_t   length,
+                    char     old_ch,
+                    char     new_ch) {
+  for (size_t i = 0; i != length; i++) {
+    if (str[i] == old_ch) {
+      str[i] = new_ch;
+    }
+  }
+}
+
+// Flips the case of every character in ['first', 'last'], which is a range of ASCII letters.
+static void
+flip_case_scalar(char   * str,
+                 size_t   length,
+                 char     first,
+                 char     last) {
+  for (size_t i = 0; i != length; i++) {
+    if (str[i] >= first && str[i] <= last) {
+      str[i] ^= 0x20;
+    }
+  }
+}
+
+// Returns the length of the leading run of 'str' with no character in 'charset'.
+static size_t
+span_out_scalar(const char    * str,
+                size_t          length,
+                const Charset * charset) {
+  size_t i = 0;
+  while (i != length && !charset_has(charset, str[i])) {
+    i++;
+  }
+  return i;
+}
+
+#ifdef __SSE2__
+
+static size_t
+count_char_sse2(const char * str,
+                size_t       length,
+                char         ch) {
+  const __m128i needle = _mm_set1_epi8(ch);
+  size_t count = 0;
+  size_t i = 0;
+  while (i + sizeof(__m128i) <= length) {
+    // Every byte counter can take SAD_ROUNDS hits before the counters are summed up.
+    __m128i counters = _mm_setzero_si128();
+    for (size_t round = 0; round != SAD_ROUNDS && i + sizeof(__m128i) <= length; round++) {
+      __m128i block = _mm_loadu_si128((const __m128i *)(str + i));
+      counters = _mm_sub_epi8(counters, _mm_cmpeq_epi8(block, needle));
+      i += sizeof(__m128i);
+    }
+    __m128i sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+    count += _mm_extract_epi16(sums, 0) + _mm_extract_epi16(sums, 4);
+  }
+  return count + count_char_scalar(str + i, length - i, ch);
+}
+
+static void
+replace_char_sse2(char   * str,
+                  size_t   length,
+                  char     old_ch,
+                  char     new_ch) {
+  const __m128i old_block = _mm_set1_epi8(old_ch);
+  const __m128i new_block = _mm_set1_epi8(new_ch);
+  size_t i = 0;
+  for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i)) {
+    __m128i block = _mm_loadu_si128((const __m128i *)(str + i));
+    __m128i hit   = _mm_cmpeq_epi8(block, old_block);
+    block = _mm_or_si128(_mm_andnot_si128(hit, block), _mm_and_si128(hit, new_block));
+    _mm_storeu_si128((__m128i *)(str + i), block);
+  }
+  replace_char_scalar(str + i, length - i, old_ch, new_ch);
+}
+
+static void
+flip_case_sse2(char   * str,
+               size_t   length,
+               char     first,
+               char     last) {
+  // The letters are below 0x80, so signed comparisons leave out every non-ASCII byte.
+  const __m128i lower = _mm_set1_epi8(first - 1);
+  const __m128i upper = _mm_set1_epi8(last + 1);
+  const __m128i flip  = _mm_set1_epi8(0x20);
+  size_t i = 0;
+  for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i)) {
+    __m128i block = _mm_loadu_si128((const __m128i *)(str + i));
+    __m128i hit   = _mm_and_si128(_mm_cmpgt_epi8(block, lower), _mm_cmplt_epi8(block, upper));
+    _mm_storeu_si128((__m128i *)(str + i), _mm_xor_si128(block, _mm_and_si128(hit, flip)));
+  }
+  flip_case_scalar(str + i, length - i, first, last);
+}
+
+static size_t
+span_out_sse2(const char    * str,
+              size_t          length,
+              const Charset * charset) {
+  if (charset->count > CHARSET_LIST_CAPACITY) {
+    return span_out_scalar(str, length, charset);
+  }
+  __m128i needles[CHARSET_LIST_CAPACITY];
+  for (size_t k = 0; k != charset->count; k++) {
+    needles[k] = _mm_set1_epi8(charset->list[k]);
+  }
+  size_t i = 0;
+  for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i)) {
+    __m128i block = _mm_loadu_si128((const __m128i *)(str + i));
+    __m128i hit   = _mm_setzero_si128();
+    for (size_t k = 0; k != charset->count; k++) {
+      hit = _mm_or_si128(hit, _mm_cmpeq_epi8(block, needles[k]));
+    }
+    unsigned mask = _mm_movemask_epi8(hit);
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return i + span_out_scalar(str + i, length - i, charset);
+}
+
+#endif // __SSE2__
+
+#ifdef ROY_STR_AVX2
+
+__attribute__((target("avx2")))
+static size_t
+count_char_avx2(const char * str,
+                size_t       length,
+                char         ch) {
+  const __m256i needle = _mm256_set1_epi8(ch);
+  __m256i sums = _mm256_setzero_si256();
+  size_t i = 0;
+  while (i + sizeof(__m256i) <= length) {
+    __m256i counters = _mm256_setzero_si256();
+    for (size_t round = 0; round != SAD_ROUNDS && i + sizeof(__m256i) <= length; round++) {
+      __m256i block = _mm256_loadu_si256((const __m256i *)(str + i));
+      counters = _mm256_sub_epi8(counters, _mm256_cmpeq_epi8(block, needle));
+      i += sizeof(__m256i);
+    }
+    sums = _mm256_add_epi64(sums, _mm256_sad_epu8(counters, _mm256_setzero_si256()));
+  }
+  uint64_t lanes[4];
+  _mm256_storeu_si256((__m256i *)lanes, sums);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3] + count_char_scalar(str + i, length - i, ch);
+}
+
+__attribute__((target("avx2")))
+static void
+replace_char_avx2(char   * str,
+                  size_t   length,
+                  char     old_ch,
+                  char     new_ch) {
+  const __m256i old_block = _mm256_set1_epi8(old_ch);
+  const __m256i new_block = _mm256_set1_epi8(new_ch);
+  size_t i = 0;
+  for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i)) {
+    __m256i block = _mm256_loadu_si256((const __m256i *)(str + i));
+    __m256i hit   = _mm256_cmpeq_epi8(block, old_block);
+    _mm256_storeu_si256((__m256i *)(str + i), _mm256_blendv_epi8(block, new_block, hit));
+  }
+  replace_char_scalar(str + i, length - i, old_ch, new_ch);
+}
+
+__attribute__((target("avx2")))
+static void
+flip_case_avx2(char   * str,
+               size_t   length,
+               char     first,
+               char     last) {
+  const __m256i lower = _mm256_set1_epi8(first - 1);
+  const __m256i upper = _mm256_set1_epi8(last + 1);
+  const __m256i flip  = _mm256_set1_epi8(0x20);
+  size_t i = 0;
+  for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i)) {
+    __m256i block = _mm256_loadu_si256((const __m256i *)(str + i));
+    __m256i hit   = _mm256_and_si256(_mm256_cmpgt_epi8(block, lower), _mm256_cmpgt_epi8(upper, block));
+    _mm256_storeu_si256((__m256i *)(str + i), _mm256_xor_si256(block, _mm256_and_si256(hit, flip)));
+  }
+  flip_case_scalar(str + i, length - i, first, last);
+}
+
+__attribute__((target("avx2")))
+static size_t
+span_out_avx2(const char    * str,
+              size_t          length,
+              const Charset * charset) {
+  if (charset->count > CHARSET_LIST_CAPACITY) {
+    return span_out_scalar(str, length, charset);
+  }
+  __m256i needles[CHARSET_LIST_CAPACITY];
+  for (size_t k = 0; k != charset->count; k++) {
+    needles[k] = _mm256_set1_epi8(charset->list[k]);
+  }
+  size_t i = 0;
+  for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i)) {
+    __m256i block = _mm256_loadu_si256((const __m256i *)(str + i));
+    __m256i hit   = _mm256_setzero_si256();
+    for (size_t k = 0; k != charset->count; k++) {
+      hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(block, needles[k]));
+    }
+    unsigned mask = _mm256_movemask_epi8(hit);
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return i + span_out_scalar(str + i, length - i, charset);
+}
+
+#endif // ROY_STR_AVX2
\ No newline at end of file
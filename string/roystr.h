@@ -7,10 +7,10 @@
 
 #define ROY_STR(str, length) char str[length + 1]; memset(str, '\0', length + 1);
 
-// Converses all characters in 'str' to lowercase.
+// Converses all ASCII letters in 'str' to lowercase.
 char * roy_str_to_lower(char * str);
 
-// Converses all characters in 'str' to uppercase.
+// Converses all ASCII letters in 'str' to uppercase.
 char * roy_str_to_upper(char * str);
 
 // Reverses 'str' in place.
@@ -109,16 +109,16 @@ bool roy_str_match(const char * str, const char * regex);
 
 int roy_str_regex_index(const char * str, const char * regex);
 
-// Reads the content of file at 'path' to 'dest'.
-// (This is a convenient function with performance sacrificed.)
-char * roy_str_read_from_file(char * dest, const char * path);
+// Reads the content of file at 'path' to 'dest' of 'capacity' bytes, 'dest' is left empty if the file can not be opened.
+// (At most 'capacity' - 1 bytes are read, a longer file is truncated. Use 'roy_string_read_file' for files of any size.)
+char * roy_str_read_from_file(char * dest, size_t capacity, const char * path);
 
-// Writes 'src' to the end of file at 'path'.
-// (This is a convenient function with performance sacrificed.)
+// Writes 'src' to the end of file at 'path', returns 0 on success, EOF on failure.
+// (The file is opened and closed on every call, use 'RoyWriter' for repeated writes.)
 int roy_str_append_to_file(const char * src, const char * path);
 
-// Writes 'src' to the beginning of file at 'path'.
-// (This is a convenient function with performance sacrificed.)
+// Writes 'src' to file at 'path' in place of its content, returns 0 on success, EOF on failure.
+// (The file is opened and closed on every call, use 'RoyWriter' for repeated writes.)
 int roy_str_write_to_file(const char * src, const char * path);
 
 #endif // ROYSTR_H
@@ -1,18 +1,25 @@
-#define PCRE2_CODE_UNIT_WIDTH 8
-
-#include "roystr.h"
 #include "roystring.h"
-#include <pcre2.h>
+#include "roystringview.h"
+#include "roytokenizer.h"
+#include "../math/roynumber.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 enum {
-    INT_MAX_LENGTH = 21,
-    DOUBLE_MAX_LENGTH = 44
+    INT_MAX_LENGTH  = 21,
+    READ_CHUNK_SIZE = 0x10000,
+    READ_PROBE_SIZE = 0x100
 };
 
 static RoyString * new_empty(void);
+static bool is_local(const RoyString * string);
+static void expand(RoyString * string, size_t length);
+static void set_length(RoyString * string, size_t length);
 static bool valid_pos(const RoyString * string, size_t position);
 static bool valid_pos_cnt(const RoyString * string, size_t position, size_t count);
-static size_t score_match(const RoyMatch * match, size_t string_length);
+static void push_pieces(RoyDeque * dest, RoyStringView * pieces, size_t count);
 
 RoyString *
 roy_string_new(const char * str) {
@@ -41,26 +48,51 @@ roy_string_copy(const RoyString * other) {
 
 RoyString *
 roy_string_read_file(const char * path) {
-  FILE * fp = fopen(path, "rb");
-  if (!fp) {
+  int fd = open(path, O_RDONLY);
+  if (fd == -1) {
     perror(path);
     return NULL;
   }
-
-  fseek(fp, 0, SEEK_END);
-  size_t size = ftell(fp);
-  fseek(fp, 0, SEEK_SET);
   RoyString * ret = new_empty();
-  ret->str = calloc(size + 1, sizeof(char));
-  fread(ret->str, sizeof(char), size, fp);
-  fclose(fp);
+  struct stat info;
+  if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+    roy_string_reserve(ret, info.st_size);
+  }
+  // Reads till the end instead of trusting the size, which is 0 for pipes and many special files.
+  // Once the storage is full, the end is probed into 'probe', so that a file of the expected size is not grown.
+  char probe[READ_PROBE_SIZE];
+  while (true) {
+    size_t length = roy_string_length(ret);
+    bool   full   = length == roy_string_capacity(ret);
+    ssize_t count = read(fd,
+                         full ? probe : ret->str + length,
+                         full ? sizeof(probe) : roy_string_capacity(ret) - length);
+    if (count > 0) {
+      if (full) {
+        expand(ret, length + READ_CHUNK_SIZE);
+        memcpy(ret->str + length, probe, count);
+      }
+      set_length(ret, length + count);
+    } else if (count == 0) {
+      break;
+    } else if (errno != EINTR) {
+      // A partial content would pass for the whole file.
+      perror(path);
+      roy_string_delete(ret, NULL);
+      ret = NULL;
+      break;
+    }
+  }
+  close(fd);
   return ret;
 }
 
 void
 roy_string_delete(RoyString                    * string,
                   __attribute__((unused)) void * user_data) {
-  free(string->str);
+  if (!is_local(string)) {
+    free(string->str);
+  }
   free(string);
 }
 
@@ -89,52 +121,69 @@ roy_string_empty(const RoyString * string) {
 
 size_t
 roy_string_length(const RoyString * string) {
-  return strlen(string->str);
+  return string->length;
+}
+
+size_t
+roy_string_capacity(const RoyString * string) {
+  return is_local(string) ? ROY_STRING_LOCAL_CAPACITY : string->capacity;
+}
+
+void
+roy_string_reserve(RoyString * string,
+                   size_t      capacity) {
+  if (capacity > roy_string_capacity(string)) {
+    if (is_local(string)) {
+      char * str = malloc(capacity + 1);
+      memcpy(str, string->local, roy_string_length(string) + 1);
+      string->str = str;
+    } else {
+      string->str = realloc(string->str, capacity + 1);
+    }
+    string->capacity = capacity;
+  }
 }
 
 RoyString *
 roy_string_assign(RoyString  * restrict string,
                   const char * restrict str) {
-  string->str = realloc(string->str, (strlen(str) + 1) * sizeof(char));
-  memcpy(string->str, str, strlen(str) + 1);
+  return roy_string_assign_n(string, str, strlen(str));
+}
+
+RoyString *
+roy_string_assign_n(RoyString  * restrict string,
+                    const char * restrict str,
+                    size_t                length) {
+  expand(string, length);
+  memcpy(string->str, str, length);
+  set_length(string, length);
   return string;
 }
 
 RoyString *
 roy_string_assign_int(RoyString * string,
                       int         value) {
-  char buf[INT_MAX_LENGTH] = { '\0' };
-  sprintf(buf, "%d", value);
-  return roy_string_assign(string, buf);
+  char buf[INT_MAX_LENGTH];
+  return roy_string_assign(string, roy_int_to_str(buf, value, 10, 0, false));
 }
 
 RoyString *
 roy_string_assign_double(RoyString * string,
                          double      value) {
-  char buf[DOUBLE_MAX_LENGTH] = { '\0' };
-  sprintf(buf, "%.15g", value);
-  return roy_string_assign(string, buf);
+  char buf[ROY_DOUBLE_STR_CAPACITY];
+  return roy_string_assign(string, roy_double_to_str(buf, value));
 }
 
 void
 roy_string_clear(RoyString * string) {
-  roy_string_assign(string, "");
+  set_length(string, 0);
 }
 
 bool
 roy_string_insert(RoyString  * restrict string,
                   const char * restrict substr,
                   size_t                position) {
-  if (valid_pos(string, position)) {
-    size_t length = roy_string_length(string);
-    ROY_STR(temp, length + strlen(substr) + 1)
-    memcpy (temp, roy_string_cstr(string, 0), position);
-    strcat (temp, substr);
-    strncat(temp, roy_string_cstr(string, position), length - position);
-    roy_string_assign(string, temp);
-    return true;
-  }
-  return false;
+  return roy_string_replace(string, substr, position, 0);
 }
 
 void
@@ -146,24 +195,23 @@ roy_string_prepend(RoyString  * restrict string,
 void
 roy_string_append(RoyString  * restrict string,
                   const char * restrict substr) {
-  roy_string_insert(string, substr, roy_string_length(string));
+  roy_string_append_n(string, substr, strlen(substr));
+}
+
+void
+roy_string_append_n(RoyString  * restrict string,
+                    const char * restrict substr,
+                    size_t                length) {
+  expand(string, roy_string_length(string) + length);
+  memcpy(string->str + roy_string_length(string), substr, length);
+  set_length(string, roy_string_length(string) + length);
 }
 
 bool
 roy_string_erase(RoyString * string,
                  size_t      position,
                  size_t      count) {
-  if (valid_pos_cnt(string, position, count)) {
-    size_t length = roy_string_length(string);
-    ROY_STR(temp, length - count + 1)
-    memcpy (temp, roy_string_cstr(string, 0), position);
-    strncat(temp,
-            roy_string_cstr(string, position + count),
-            length - position - count);
-    roy_string_assign(string, temp);
-    return true;
-  }
-  return false;
+  return roy_string_replace(string, "", position, count);
 }
 
 bool
@@ -184,11 +232,14 @@ roy_string_replace(RoyString  * restrict string,
                    size_t       position,
                    size_t       count) {
   if (valid_pos_cnt(string, position, count)) {
-    ROY_STR(temp, roy_string_length(string) + strlen(substr) + 1)
-    strncpy(temp, roy_string_cstr(string, 0), position);
-    strcat (temp, substr);
-    strcat (temp, roy_string_cstr(string, position + count));
-    roy_string_assign(string, temp);
+    size_t length = strlen(substr);
+    size_t length_new = roy_string_length(string) - count + length;
+    expand(string, length_new);
+    memmove(string->str + position + length,
+            string->str + position + count,
+            roy_string_length(string) - position - count);
+    memcpy(string->str + position, substr, length);
+    set_length(string, length_new);
     return true;
   }
   return false;
@@ -200,9 +251,9 @@ roy_string_substring(      RoyString * dest,
                      size_t            position,
                      size_t            count) {
   if (valid_pos_cnt(src, position, count)) {
-    ROY_STR(temp, count + 1)
-    strncpy(temp, roy_string_cstr(src, position), count);
-    roy_string_assign(dest, temp);
+    expand(dest, count);
+    memmove(dest->str, src->str + position, count);
+    set_length(dest, count);
     return true;
   }
   return false;
@@ -233,7 +284,7 @@ roy_string_sub_match(      RoyString * dest,
 
 void
 roy_string_print(const RoyString * string) {
-  printf("%s", roy_string_cstr(string, 0));
+  fwrite(roy_string_cstr(string, 0), 1, roy_string_length(string), stdout);
 }
 
 void
@@ -253,42 +304,43 @@ roy_string_printw(const RoyString * string,
 void
 roy_string_scan(RoyString * string,
                 size_t      buf_size) {
-  ROY_STR(temp, buf_size)
-  fgets  (temp, buf_size, stdin);
-  roy_string_assign(string, temp);
-  roy_string_erase_right(string, 1);
+  // Reads 'buf_size' characters at a time till the whole line is read.
+  // The length is kept up to date, so that expanding keeps the characters read.
+  set_length(string, 0);
+  expand(string, buf_size);
+  while (fgets(string->str + string->length, roy_string_capacity(string) - string->length + 1, stdin)) {
+    size_t length = string->length + strlen(string->str + string->length);
+    // fgets stops at '\n' only, so a line starting with '\0' reads as no characters and 'length' can be 0.
+    if (length != 0 && string->str[length - 1] == '\n') {
+      set_length(string, length - 1);
+      break;
+    }
+    set_length(string, length);
+    expand(string, length + buf_size + 1);
+  }
 }
 
 RoyMatch
 roy_string_find(const RoyString  * string,
                 const char       * pattern,
                 size_t             position) {
-  RoyMatch ret = roy_match_make_default();
-  const PCRE2_SPTR ptn = (const PCRE2_SPTR)pattern;
-  int err_code;
-  PCRE2_SIZE err_offset;
-  pcre2_code * re =
-    pcre2_compile(ptn, PCRE2_ZERO_TERMINATED, 0U, &err_code, &err_offset, NULL);
-
-  if (re == NULL) {
-    ret.begin = ret.end = PCRE2_ERROR_NULL;
-  }
-
-  const PCRE2_SPTR    sub = (const PCRE2_SPTR)roy_string_cstr(string, position);
-  PCRE2_SIZE       sublen = strlen((const char *)sub);
-  pcre2_match_data * data = pcre2_match_data_create_from_pattern(re, NULL);
+  RoyStringView view = roy_string_view_make_string(string);
+  return roy_string_view_find(&view, pattern, position);
+}
 
-  if (pcre2_match(re, sub, sublen, 0ULL, PCRE2_NOTEMPTY, data, NULL) > 0) {
-    /* Since 'data' is create by 'pcre2_match_data_create_from_pattern',
-       'pcre2_match' would never equal to 0. */
-    PCRE2_SIZE * ovector = pcre2_get_ovector_pointer(data);
-    ret.begin = ovector[0];
-    ret.end   = ovector[1];
-  }
+RoyMatch
+roy_string_find_literal(const RoyString * string,
+                        const char      * literal,
+                        size_t            position) {
+  RoyStringView view = roy_string_view_make_string(string);
+  return roy_string_view_find_literal(&view, literal, position);
+}
 
-  pcre2_match_data_free(data);
-  pcre2_code_free(re);
-  return ret;
+RoyMatch
+roy_string_find_regex(const RoyString * string,
+                      const RoyRegex  * regex,
+                      size_t            position) {
+  return roy_regex_find(regex, string->str, roy_string_length(string), position);
 }
 
 bool
@@ -319,33 +371,24 @@ roy_string_tokenize(RoyDeque        * restrict dest,
                     const RoyString * restrict string,
                     int                        pattern_count,
                     ...) {
-  int pos = 0;
-  int len = roy_string_length(string);
-  RoyMatch max_match;
-  size_t max_score;
-  do {
-    va_list args;
-    va_start(args, pattern_count);
-    roy_match_set_default(&max_match);
-    max_score = 0;
-    RoyMatch cur_match;
-    size_t cur_score;
-    for (int i = 1; i <= pattern_count; i++) {
-      cur_match = roy_string_find(string, va_arg(args, const char*), pos);
-      cur_score = score_match(&cur_match, len);
-      if (max_score < cur_score) {
-        max_score = cur_score;
-        max_match = cur_match;
-        max_match.type = i;
-      }
+  const char ** patterns = malloc(pattern_count * sizeof(const char *));
+  va_list args;
+  va_start(args, pattern_count);
+  for (int i = 0; i != pattern_count; i++) {
+    patterns[i] = va_arg(args, const char *);
+  }
+  va_end(args);
+  RoyTokenizer * tokenizer = roy_tokenizer_new(pattern_count, patterns);
+  free(patterns);
+  if (tokenizer) {
+    size_t count;
+    RoyMatch * tokens = roy_tokenizer_scan(tokenizer, string->str, roy_string_length(string), &count);
+    for (size_t i = 0; i != count; i++) {
+      roy_deque_push_back(dest, roy_match_copy(&tokens[i]));
     }
-    RoyMatch * temp =
-      roy_match_new(max_match.begin + pos, max_match.end + pos, max_match.type);
-    roy_deque_push_back(dest, temp);
-    pos += max_match.end;
-    va_end(args);
-  } while (max_match.begin != PCRE2_ERROR_NOMATCH);
-  roy_deque_pop_back(dest, NULL);
+    free(tokens);
+    roy_tokenizer_delete(tokenizer);
+  }
   return roy_deque_size(dest);
 }
 
@@ -353,18 +396,21 @@ size_t
 roy_string_split(RoyDeque        * restrict dest,
                  const RoyString * restrict string,
                  const char      * restrict separator) {
-  size_t pos = 0;
-  RoyMatch match = roy_string_find(string, separator, pos);
-  while (match.begin != PCRE2_ERROR_NOMATCH) {
-    RoyString * temp = new_empty();
-    roy_string_substring(temp, string, pos, match.begin);
-    roy_deque_push_back(dest, temp);
-    pos += match.end;
-    match = roy_string_find(string, separator, pos);
-  }
-  RoyString * temp = new_empty();
-  roy_string_right(temp, string, roy_string_length(string) - pos);
-  roy_deque_push_back(dest, temp);
+  RoyStringView view = roy_string_view_make_string(string);
+  size_t count;
+  RoyStringView * pieces = roy_string_view_split(&view, separator, &count);
+  push_pieces(dest, pieces, count);
+  return roy_deque_size(dest);
+}
+
+size_t
+roy_string_split_char(RoyDeque        * restrict dest,
+                      const RoyString * restrict string,
+                      int                        separator) {
+  RoyStringView view = roy_string_view_make_string(string);
+  size_t count;
+  RoyStringView * pieces = roy_string_view_split_char(&view, separator, &count);
+  push_pieces(dest, pieces, count);
   return roy_deque_size(dest);
 }
 
@@ -387,10 +433,34 @@ roy_string_join(RoyString      * restrict dest,
 static RoyString *
 new_empty(void) {
   RoyString * ret = malloc(sizeof(RoyString));
-  ret->str = NULL;
+  ret->str      = ret->local;
+  ret->length   = 0;
+  ret->local[0] = '\0';
   return ret;
 }
 
+static bool
+is_local(const RoyString * string) {
+  return string->str == string->local;
+}
+
+// Grows the storage geometrically so that 'string' can hold 'length' characters.
+static void
+expand(RoyString * string,
+       size_t      length) {
+  if (length > roy_string_capacity(string)) {
+    size_t capacity = roy_string_capacity(string) * 2;
+    roy_string_reserve(string, capacity > length ? capacity : length);
+  }
+}
+
+static void
+set_length(RoyString * string,
+           size_t      length) {
+  string->length = length;
+  string->str[length] = '\0';
+}
+
 static bool
 valid_pos(const RoyString * string,
           size_t            position) {
@@ -405,12 +475,13 @@ valid_pos_cnt(const RoyString * string,
   return (position <= size) && (position + count <= size);
 }
 
-/* Evaluate the RoyMatch: the nearer the 'match' to the beginning of the string,
-   and the shorter the 'match' is, the higher score it gets.*/
-static size_t
-score_match(const RoyMatch * match,
-            size_t           string_length) {
-  return
-  roy_match_default(match) ? 0 :
-  (string_length - match->begin) * INT_MAX + (match->end - match->begin);
+// Pushes a copy of every piece into 'dest', and releases 'pieces'.
+static void
+push_pieces(RoyDeque      * dest,
+            RoyStringView * pieces,
+            size_t          count) {
+  for (size_t i = 0; i != count; i++) {
+    roy_deque_push_back(dest, roy_string_view_to_string(&pieces[i]));
+  }
+  free(pieces);
 }
\ No newline at end of file
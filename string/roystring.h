@@ -3,10 +3,21 @@
 
 #include "../util/rpre.h"
 #include "../util/rmatch.h"
+#include "royregex.h"
 #include "../list/roydeque.h"
 
+enum {
+  ROY_STRING_LOCAL_CAPACITY = 23
+};
+
+// Contents no longer than ROY_STRING_LOCAL_CAPACITY are kept in 'local' without a separate allocation.
 struct RoyString_ {
-  char * str;
+  char   * str;      // always terminated by '\0', points to 'local' for short contents
+  size_t   length;
+  union {
+    size_t capacity; // number of characters 'str' can hold on the heap, the terminating '\0' excluded
+    char   local[ROY_STRING_LOCAL_CAPACITY + 1];
+  };
 };
 
 /// @brief RoyString: stores and manipulates sequences of chars, offering common string operations.
@@ -29,7 +40,12 @@ RoyString * roy_string_new_double(double value);
 /// @brief Constructs a RoyString with the content of another RoyString.
 RoyString * roy_string_copy(const RoyString * other);
 
-/// @brief Constructs a RoyString with given double 'value'.
+/**
+ * @brief Constructs a RoyString with the content of the file at 'path'.
+ * @return NULL - the file can not be opened or read.
+ * @note - Regular files are read into storage of their exact size, other files like pipes are read in growing chunks till the end.
+ * @note - See 'roy_string_view_map_file' to refer to a large file without reading it.
+ */
 RoyString * roy_string_read_file(const char * path);
 
 /**
@@ -50,6 +66,7 @@ int roy_string_at(const RoyString * string, size_t position);
 /**
  * @brief Returns a standard C character array version at 'position' of 'string'.
  * @return NULL - if 'position' exceeds or 'string' is empty.
+ * @note - The behavior is undefined if a '\0' is written through the returned pointer.
  */
 char * roy_string_str(RoyString * string, size_t position);
 
@@ -68,9 +85,19 @@ const char * roy_string_cstr(const RoyString * string, size_t position);
  */
 bool roy_string_empty(const RoyString * string);
 
-/// @brief Returns the number of characters in 'string'.
+/// @brief Returns the number of characters in 'string' in constant time.
 size_t roy_string_length(const RoyString * string);
 
+/// @brief Returns the number of characters 'string' can hold without reallocating.
+size_t roy_string_capacity(const RoyString * string);
+
+/**
+ * @brief Expands the storage of 'string' so that it can hold at least 'capacity' characters.
+ * @note - Nothing happens if 'capacity' is not greater than the current capacity.
+ * @note - Operations which need more room grow the storage geometrically, so a series of appends takes amortized linear time.
+ */
+void roy_string_reserve(RoyString * string, size_t capacity);
+
 /* OPERATIONS */
 
 /**
@@ -80,10 +107,16 @@ size_t roy_string_length(const RoyString * string);
  */ 
 RoyString * roy_string_assign(RoyString * restrict dest, const char * restrict src);
 
+/**
+ * @brief Copies the first 'length' characters of 'str' to 'string'.
+ * @note - 'str' needs not be terminated by '\0'.
+ */
+RoyString * roy_string_assign_n(RoyString * restrict string, const char * restrict str, size_t length);
+
 /// @brief Assigns integer 'value' to 'string'.
 RoyString * roy_string_assign_int(RoyString * string, int value);
 
-/// @brief Assigns double number 'value' to 'string'.
+/// @brief Assigns double number 'value' to 'string', with the shortest digits (for almost all doubles) which read back as 'value'.
 RoyString * roy_string_assign_double(RoyString * string, double value);
 
 /// @brief Clears the contents of 'string'.
@@ -110,6 +143,12 @@ void roy_string_prepend(RoyString * restrict string, const char * restrict subst
  */
 void roy_string_append(RoyString * restrict string, const char * restrict substr);
 
+/**
+ * @brief Adds the first 'length' characters of 'substr' to the right end of 'string'.
+ * @note - 'substr' needs not be terminated by '\0'.
+ */
+void roy_string_append_n(RoyString * restrict string, const char * restrict substr, size_t length);
+
 /**
  * @brief Removes characters from 'string'.
  * @param position - first character to remove.
@@ -190,7 +229,10 @@ bool roy_string_right(RoyString * dest, const RoyString * src, size_t count);
  */
 bool roy_string_sub_match(RoyString * dest, const RoyString * src, const RoyMatch * match);
 
-/// @brief Writes 'string' to stdout.
+/**
+ * @brief Writes 'string' to stdout.
+ * @note - See 'RoyWriter' to write many strings with few system calls.
+ */
 void roy_string_print(const RoyString * string);
 
 /// @brief Writes 'string' to stdout, adds a new line to the end of 'string' if there wasn't one.
@@ -203,9 +245,10 @@ void roy_string_println(const RoyString * string);
 void roy_string_printw(const RoyString * string, int width);
 
 /**
- * @brief Writes 'string' according to stdin.
- * @param buffer_size - size of the buffer inside the function.
- */ 
+ * @brief Reads a line from stdin into 'string', the terminating '\n' is dropped.
+ * @param buf_size - number of characters read at a time, a longer line is read by several reads.
+ * @note - See 'RoyLineReader' to read many lines fast.
+ */
 void roy_string_scan(RoyString * string, size_t buf_size);
 
 /* SEARCH */
@@ -215,9 +258,21 @@ void roy_string_scan(RoyString * string, size_t buf_size);
  * @param pattern - substring to be found, char string literals and regexs are allowed.
  * @param position - position at which to start the search from 'string'.
  * @return the first pattern found, can be accessed by '.begin' '.end', -1 if not found, -51 if 'pattern' is a ill-formed regex.
+ * @note - 'pattern' is compiled once and kept in the cache of the calling thread, see 'roy_regex_cached'.
+ * @note - A 'pattern' without metacharacters is searched as a fixed string without pcre2, see 'roy_regex_literal'.
  */
 RoyMatch roy_string_find(const RoyString * string, const char * pattern, size_t position);
 
+/**
+ * @brief Finds the position where the first 'literal' occur, every character of 'literal' stands for itself.
+ * @return the first 'literal' found relative to 'position', can be accessed by '.begin' '.end', -1 if not found.
+ * @note - The search is a vectorized memmem, see 'roy_memmem', an empty 'literal' is never found.
+ */
+RoyMatch roy_string_find_literal(const RoyString * string, const char * literal, size_t position);
+
+/// @brief Finds the position where the first match of a precompiled 'regex' occur, see 'roy_string_find'.
+RoyMatch roy_string_find_regex(const RoyString * string, const RoyRegex * regex, size_t position);
+
 /**
  * @brief Tests whether 'string' exactly matches the given string 'pattern'. 
  * @param pattern - string to be compared, char string literals and regexs are allowed.
@@ -255,6 +310,9 @@ double roy_string_to_double(const RoyString * string);
  * @param dest - where the position info (RMatch) to pushed into.
  * @param pattern - pattern to be parsed.
  * @return the size of the destination deque, aka number of tokenized strings.
+ * @note - Where several patterns match at the same position, the first listed one wins.
+ * @note - The patterns are compiled into one RoyTokenizer which scans 'string' once,
+ *         build a RoyTokenizer directly to reuse it, and to receive the tokens in one contiguous array.
  */
 size_t roy_string_tokenize(RoyDeque * restrict dest, const RoyString * restrict string, int pattern_count, ...);
 
@@ -266,6 +324,9 @@ size_t roy_string_tokenize(RoyDeque * restrict dest, const RoyString * restrict
  */
 size_t roy_string_split(RoyDeque * restrict dest, const RoyString * restrict string, const char * restrict separator);
 
+/// @brief Separates 'string' into substrings at every character 'separator', see 'roy_string_split'.
+size_t roy_string_split_char(RoyDeque * restrict dest, const RoyString * restrict string, int separator);
+
 /**
  * @brief Creates and returns a new string by concatenating all of the substrings in 'deque'.
  * @param separator - the specified separator The dest string will be separated.
@@ -0,0 +1,268 @@
+#define PCRE2_CODE_UNIT_WIDTH 8
+
+#include "roystringview.h"
+#include "../util/rsearch.h"
+#include <pcre2.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum {
+  PIECE_CAPACITY = 0x10
+};
+
+// What a split searches for, either a precompiled 'regex' or a fixed string 'literal'.
+typedef struct Separator_ {
+  const RoyRegex * regex;
+  const char     * literal;
+  size_t           length;
+} Separator;
+
+static bool valid_pos_cnt(const RoyStringView * view, size_t position, size_t count);
+static RoyMatch find_literal(const RoyStringView * view, const char * literal, size_t length, size_t position);
+static RoyMatch find_separator(const RoyStringView * view, const Separator * separator, size_t position);
+static RoyStringView * split(const RoyStringView * view, const Separator * separator, size_t * count);
+
+RoyStringView
+roy_string_view_make(const char * str,
+                     size_t       length) {
+  RoyStringView ret = { str, length };
+  return ret;
+}
+
+RoyStringView
+roy_string_view_make_cstr(const char * str) {
+  return roy_string_view_make(str, strlen(str));
+}
+
+RoyStringView
+roy_string_view_make_string(const RoyString * string) {
+  return roy_string_view_make(roy_string_cstr(string, 0), roy_string_length(string));
+}
+
+RoyString *
+roy_string_view_to_string(const RoyStringView * view) {
+  return roy_string_assign_n(roy_string_new_empty(), view->str, view->length);
+}
+
+bool
+roy_string_view_map_file(RoyStringView * dest,
+                         const char    * path) {
+  int fd = open(path, O_RDONLY);
+  if (fd == -1) {
+    perror(path);
+    return false;
+  }
+  struct stat info;
+  bool ret = fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+  if (ret && info.st_size == 0) {
+    // An empty mapping is not allowed, an empty file is referred to by an empty view instead.
+    *dest = roy_string_view_make("", 0);
+  } else if (ret) {
+    void * str = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ret = str != MAP_FAILED;
+    if (ret) {
+      madvise(str, info.st_size, MADV_SEQUENTIAL);
+      *dest = roy_string_view_make(str, info.st_size);
+    }
+  }
+  close(fd);
+  return ret;
+}
+
+void
+roy_string_view_unmap_file(RoyStringView * view) {
+  if (!roy_string_view_empty(view)) {
+    munmap((void *)view->str, view->length);
+  }
+  *view = roy_string_view_make("", 0);
+}
+
+int
+roy_string_view_at(const RoyStringView * view,
+                   size_t                position) {
+  return position < roy_string_view_length(view) ? (int)view->str[position] : '\0';
+}
+
+size_t
+roy_string_view_length(const RoyStringView * view) {
+  return view->length;
+}
+
+bool
+roy_string_view_empty(const RoyStringView * view) {
+  return roy_string_view_length(view) == 0;
+}
+
+bool
+roy_string_view_substring(RoyStringView       * dest,
+                          const RoyStringView * src,
+                          size_t                position,
+                          size_t                count) {
+  if (valid_pos_cnt(src, position, count)) {
+    *dest = roy_string_view_make(src->str + position, count);
+    return true;
+  }
+  return false;
+}
+
+bool
+roy_string_view_left(RoyStringView       * dest,
+                     const RoyStringView * src,
+                     size_t                count) {
+  return roy_string_view_substring(dest, src, 0, count);
+}
+
+bool
+roy_string_view_right(RoyStringView       * dest,
+                      const RoyStringView * src,
+                      size_t                count) {
+  return roy_string_view_substring(dest,
+                                   src,
+                                   roy_string_view_length(src) - count,
+                                   count);
+}
+
+bool
+roy_string_view_sub_match(RoyStringView       * dest,
+                          const RoyStringView * src,
+                          const RoyMatch      * match) {
+  return roy_string_view_substring(dest,
+                                   src,
+                                   match->begin,
+                                   match->end - match->begin);
+}
+
+RoyMatch
+roy_string_view_find(const RoyStringView * view,
+                     const char          * pattern,
+                     size_t                position) {
+  char literal[ROY_REGEX_LITERAL_CAPACITY];
+  int length = roy_regex_literal(literal, pattern);
+  if (length >= 0) {
+    return find_literal(view, literal, length, position);
+  }
+  const RoyRegex * regex = roy_regex_cached(pattern);
+  if (regex == NULL) {
+    return roy_match_make(PCRE2_ERROR_NULL, PCRE2_ERROR_NULL, 0);
+  }
+  return roy_string_view_find_regex(view, regex, position);
+}
+
+RoyMatch
+roy_string_view_find_regex(const RoyStringView * view,
+                           const RoyRegex      * regex,
+                           size_t                position) {
+  return roy_regex_find(regex, view->str, roy_string_view_length(view), position);
+}
+
+RoyMatch
+roy_string_view_find_literal(const RoyStringView * view,
+                             const char          * literal,
+                             size_t                position) {
+  return find_literal(view, literal, strlen(literal), position);
+}
+
+int
+roy_string_view_compare(const RoyStringView * lhs,
+                        const RoyStringView * rhs) {
+  size_t length = lhs->length < rhs->length ? lhs->length : rhs->length;
+  int ret = memcmp(lhs->str, rhs->str, length);
+  if (ret == 0) {
+    ret = (lhs->length > rhs->length) - (lhs->length < rhs->length);
+  }
+  return ret;
+}
+
+RoyStringView *
+roy_string_view_split(const RoyStringView * view,
+                      const char          * separator,
+                      size_t              * count) {
+  char literal[ROY_REGEX_LITERAL_CAPACITY];
+  int length = roy_regex_literal(literal, separator);
+  Separator sep = { NULL, literal, length };
+  if (length < 0) {
+    sep.regex   = roy_regex_cached(separator);
+    sep.literal = NULL;
+  }
+  return split(view, &sep, count);
+}
+
+RoyStringView *
+roy_string_view_split_char(const RoyStringView * view,
+                           int                   separator,
+                           size_t              * count) {
+  char literal = (char)separator;
+  Separator sep = { NULL, &literal, 1 };
+  return split(view, &sep, count);
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+static bool
+valid_pos_cnt(const RoyStringView * view,
+              size_t                position,
+              size_t                count) {
+  size_t length = roy_string_view_length(view);
+  return (position <= length) && (count <= length - position);
+}
+
+static RoyMatch
+find_literal(const RoyStringView * view,
+             const char          * literal,
+             size_t                length,
+             size_t                position) {
+  RoyMatch ret = roy_match_make_default();
+  // An empty literal is never found, just like an empty match of pcre2.
+  if (length != 0 && position <= roy_string_view_length(view)) {
+    const char * found = roy_memmem(view->str + position,
+                                    roy_string_view_length(view) - position,
+                                    literal,
+                                    length);
+    if (found) {
+      ret.begin = found - (view->str + position);
+      ret.end   = ret.begin + length;
+    }
+  }
+  return ret;
+}
+
+static RoyMatch
+find_separator(const RoyStringView * view,
+               const Separator     * separator,
+               size_t                position) {
+  if (separator->regex) {
+    return roy_string_view_find_regex(view, separator->regex, position);
+  }
+  if (separator->literal) {
+    return find_literal(view, separator->literal, separator->length, position);
+  }
+  // 'separator' is a ill-formed regex, which never matches.
+  return roy_match_make_default();
+}
+
+static RoyStringView *
+split(const RoyStringView * view,
+      const Separator     * separator,
+      size_t              * count) {
+  size_t capacity = PIECE_CAPACITY;
+  RoyStringView * ret = malloc(capacity * sizeof(RoyStringView));
+  size_t pos = 0;
+  *count = 0;
+  while (true) {
+    RoyMatch match = find_separator(view, separator, pos);
+    if (*count == capacity) {
+      capacity *= 2;
+      ret = realloc(ret, capacity * sizeof(RoyStringView));
+    }
+    if (match.begin < 0) {
+      ret[(*count)++] = roy_string_view_make(view->str + pos,
+                                             roy_string_view_length(view) - pos);
+      break;
+    }
+    ret[(*count)++] = roy_string_view_make(view->str + pos, match.begin);
+    pos += match.end;
+  }
+  return ret;
+}
\ No newline at end of file
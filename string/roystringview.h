@@ -0,0 +1,132 @@
+#ifndef ROYSTRINGVIEW_H
+#define ROYSTRINGVIEW_H
+
+#include "../util/rpre.h"
+#include "../util/rmatch.h"
+#include "royregex.h"
+#include "roystring.h"
+
+/**
+ * @brief RoyStringView: a non-owning reference to a sequence of characters, which need not end with '\0'.
+ * @note - A view is only valid as long as the characters it refers to are alive and unmodified.
+ */
+typedef struct RoyStringView_ {
+  const char * str;
+  size_t       length;
+} RoyStringView;
+
+/* CONSTRUCTION */
+
+/// @brief Makes a RoyStringView of the first 'length' characters of 'str'.
+RoyStringView roy_string_view_make(const char * str, size_t length);
+
+/// @brief Makes a RoyStringView of the C string 'str'.
+RoyStringView roy_string_view_make_cstr(const char * str);
+
+/**
+ * @brief Makes a RoyStringView of the whole 'string'.
+ * @note - The view is invalidated by any operation which modifies 'string'.
+ */
+RoyStringView roy_string_view_make_string(const RoyString * string);
+
+/// @brief Constructs a RoyString with a copy of the characters 'view' refers to.
+RoyString * roy_string_view_to_string(const RoyStringView * view);
+
+/**
+ * @brief Maps the file at 'path' into memory read-only, and makes 'dest' refer to all its characters.
+ * @retval true - the operation is successful.
+ * @retval false - the file can not be opened, or it is not a regular file.
+ * @note - Takes constant time whatever the size of the file, its pages are read in when first touched,
+ *         and the kernel is advised to read ahead for a sequential scan.
+ * @note - The characters are not terminated by '\0', and the view must be released by 'roy_string_view_unmap_file'.
+ * @note - Special files which report no size, like those in /proc, are mapped as empty, read them by 'roy_string_read_file'.
+ */
+bool roy_string_view_map_file(RoyStringView * dest, const char * path);
+
+/// @brief Unmaps the file which 'view' refers to, 'view' becomes empty.
+void roy_string_view_unmap_file(RoyStringView * view);
+
+/* CHARACTER ACCESS */
+
+/**
+ * @brief Accesses the specified character.
+ * @return the character at 'position'.
+ * @return '\0' - if 'position' exceeds.
+ */
+int roy_string_view_at(const RoyStringView * view, size_t position);
+
+/* CAPACITY */
+
+/// @brief Returns the number of characters in 'view'.
+size_t roy_string_view_length(const RoyStringView * view);
+
+/// @brief Checks whether 'view' refers to no character.
+bool roy_string_view_empty(const RoyStringView * view);
+
+/* OPERATIONS */
+
+/**
+ * @brief Narrows 'src' to [position, position + count) without copying any character.
+ * @retval true - the operation is successful.
+ * @retval false - 'position' or 'position' + 'count' exceeds.
+ * @note 'dest' and 'src' can be identical for self operation.
+ */
+bool roy_string_view_substring(RoyStringView * dest, const RoyStringView * src, size_t position, size_t count);
+
+/// @brief Narrows 'src' to [0, count), see 'roy_string_view_substring'.
+bool roy_string_view_left(RoyStringView * dest, const RoyStringView * src, size_t count);
+
+/// @brief Narrows 'src' to [length - count, length), see 'roy_string_view_substring'.
+bool roy_string_view_right(RoyStringView * dest, const RoyStringView * src, size_t count);
+
+/// @brief Narrows 'src' to [match.begin, match.end), see 'roy_string_view_substring'.
+bool roy_string_view_sub_match(RoyStringView * dest, const RoyStringView * src, const RoyMatch * match);
+
+/* SEARCH */
+
+/**
+ * @brief Finds the position where the first substr occur (takes advantages of pcre2).
+ * @param pattern - substring to be found, char string literals and regexs are allowed.
+ * @param position - position at which to start the search from 'view'.
+ * @return the first pattern found relative to 'position', can be accessed by '.begin' '.end',
+ *         -1 if not found, -51 if 'pattern' is a ill-formed regex.
+ * @note - Only the characters 'view' refers to are searched, it needs no terminating '\0'.
+ * @note - 'pattern' is compiled once and kept in the cache of the calling thread, see 'roy_regex_cached'.
+ * @note - A 'pattern' without metacharacters is searched as a fixed string without pcre2, see 'roy_regex_literal'.
+ */
+RoyMatch roy_string_view_find(const RoyStringView * view, const char * pattern, size_t position);
+
+/// @brief Finds the position where the first match of a precompiled 'regex' occur, see 'roy_string_view_find'.
+RoyMatch roy_string_view_find_regex(const RoyStringView * view, const RoyRegex * regex, size_t position);
+
+/**
+ * @brief Finds the position where the first 'literal' occur, every character of 'literal' stands for itself.
+ * @return the first 'literal' found relative to 'position', can be accessed by '.begin' '.end', -1 if not found.
+ * @note - The search is a vectorized memmem, see 'roy_memmem', an empty 'literal' is never found.
+ */
+RoyMatch roy_string_view_find_literal(const RoyStringView * view, const char * literal, size_t position);
+
+/* UTILITIES */
+
+/**
+ * @brief Compares two views lexicographically.
+ * @retval Negative value if 'lhs' appears before 'rhs' in lexicographical order.
+ * @retval Zero if 'lhs' and 'rhs' compare equal.
+ * @retval Positive value if 'lhs' appears after 'rhs' in lexicographical order.
+ */
+int roy_string_view_compare(const RoyStringView * lhs, const RoyStringView * rhs);
+
+/**
+ * @brief Separates 'view' into pieces using 'separator' without copying any character.
+ * @param separator - The string where each split should occur. Can be a string or a regular expression.
+ * @param count - receives the number of pieces.
+ * @return a newly allocated array of the pieces, which should be released by 'free'.
+ * @note - The array is the only allocation, every piece refers to the characters of 'view'.
+ * @note - A 'separator' without metacharacters is searched as a fixed string without pcre2, see 'roy_regex_literal'.
+ */
+RoyStringView * roy_string_view_split(const RoyStringView * view, const char * separator, size_t * count);
+
+/// @brief Separates 'view' into pieces at every character 'separator', see 'roy_string_view_split'.
+RoyStringView * roy_string_view_split_char(const RoyStringView * view, int separator, size_t * count);
+
+#endif // ROYSTRINGVIEW_H
@@ -0,0 +1,124 @@
+#define PCRE2_CODE_UNIT_WIDTH 8
+
+#include "roytokenizer.h"
+#include "royregex.h"
+#include "../util/rstats.h"
+#include <pcre2.h>
+
+enum {
+  TOKEN_CAPACITY = 0x10
+};
+
+struct RoyTokenizer_ {
+  pcre2_code * code;
+  size_t       pattern_count;
+  size_t     * groups;       // The number of the group wrapping each pattern.
+};
+
+static int token_type(const RoyTokenizer * tokenizer, const PCRE2_SIZE * ovector);
+
+RoyTokenizer *
+roy_tokenizer_new(size_t               pattern_count,
+                  const char * const * patterns) {
+  size_t * groups = malloc(pattern_count * sizeof(size_t));
+  size_t length = 0;
+  size_t group = 1;
+  for (size_t i = 0; i != pattern_count; i++) {
+    // Compiles every pattern alone first, which rejects the ill-formed ones and counts their groups.
+    RoyRegex * regex = roy_regex_new(patterns[i]);
+    if (regex == NULL) {
+      free(groups);
+      return NULL;
+    }
+    groups[i] = group;
+    group += roy_regex_capture_count(regex) + 1;
+    length += strlen(patterns[i]) + 3;
+    roy_regex_delete(regex);
+  }
+  char * alternation = malloc(length + 1);
+  char * cur = alternation;
+  for (size_t i = 0; i != pattern_count; i++) {
+    cur += sprintf(cur, i == 0 ? "(%s)" : "|(%s)", patterns[i]);
+  }
+  *cur = '\0';
+
+  int err_code;
+  PCRE2_SIZE err_offset;
+  pcre2_code * code = pcre2_compile((PCRE2_SPTR)alternation,
+                                    PCRE2_ZERO_TERMINATED,
+                                    0U,
+                                    &err_code,
+                                    &err_offset,
+                                    NULL);
+  R_STATS_ADD(R_STATS_REGEX_COMPILES, 1);
+  free(alternation);
+  if (code == NULL) {
+    free(groups);
+    return NULL;
+  }
+  pcre2_jit_compile(code, PCRE2_JIT_COMPLETE);
+  RoyTokenizer * ret = malloc(sizeof(RoyTokenizer));
+  ret->code          = code;
+  ret->pattern_count = pattern_count;
+  ret->groups        = groups;
+  return ret;
+}
+
+void
+roy_tokenizer_delete(RoyTokenizer * tokenizer) {
+  if (tokenizer) {
+    pcre2_code_free(tokenizer->code);
+    free(tokenizer->groups);
+    free(tokenizer);
+  }
+}
+
+size_t
+roy_tokenizer_pattern_count(const RoyTokenizer * tokenizer) {
+  return tokenizer->pattern_count;
+}
+
+RoyMatch *
+roy_tokenizer_scan(const RoyTokenizer * tokenizer,
+                   const char         * str,
+                   size_t               length,
+                   size_t             * count) {
+  size_t capacity = TOKEN_CAPACITY;
+  RoyMatch * ret = malloc(capacity * sizeof(RoyMatch));
+  *count = 0;
+  if (tokenizer->pattern_count == 0) {
+    return ret;
+  }
+  pcre2_match_data * data = pcre2_match_data_create_from_pattern(tokenizer->code, NULL);
+  PCRE2_SIZE * ovector = pcre2_get_ovector_pointer(data);
+  size_t pos = 0;
+  while (pcre2_match(tokenizer->code,
+                     (PCRE2_SPTR)str,
+                     length,
+                     pos,
+                     PCRE2_NOTEMPTY,
+                     data,
+                     NULL) > 0) {
+    if (*count == capacity) {
+      capacity *= 2;
+      ret = realloc(ret, capacity * sizeof(RoyMatch));
+    }
+    ret[(*count)++] = roy_match_make(ovector[0], ovector[1], token_type(tokenizer, ovector));
+    pos = ovector[1];
+  }
+  pcre2_match_data_free(data);
+  return ret;
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+// Returns the 1-based index of the pattern whose group takes part in the match.
+static int
+token_type(const RoyTokenizer * tokenizer,
+           const PCRE2_SIZE   * ovector) {
+  size_t i = 0;
+  while (i + 1 != tokenizer->pattern_count && ovector[tokenizer->groups[i] * 2] == PCRE2_UNSET) {
+    i++;
+  }
+  return i + 1;
+}
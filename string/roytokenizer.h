@@ -0,0 +1,46 @@
+#ifndef ROYTOKENIZER_H
+#define ROYTOKENIZER_H
+
+#include "../util/rpre.h"
+#include "../util/rmatch.h"
+
+/**
+ * @brief RoyTokenizer: a set of token patterns compiled into one alternation,
+ *        which splits a text into tokens by a single scan.
+ */
+typedef struct RoyTokenizer_ RoyTokenizer;
+
+/* CONSTRUCTION AND DESTRUCTION */
+
+/**
+ * @brief Compiles 'patterns' into a RoyTokenizer.
+ * @param pattern_count - number of patterns.
+ * @param patterns - the regexs of every kind of token, the kind of a token is the 1-based index of its pattern.
+ * @return The newly build RoyTokenizer.
+ * @return NULL - any of 'patterns' is a ill-formed regex.
+ * @note - The patterns are joined into '(p1)|(p2)|...', so a pattern must not refer to a capturing group by its number or name.
+ */
+RoyTokenizer * roy_tokenizer_new(size_t pattern_count, const char * const * patterns);
+
+/// @brief Releases the compiled code and destroys the RoyTokenizer - 'tokenizer' itself.
+void roy_tokenizer_delete(RoyTokenizer * tokenizer);
+
+/* CAPACITY */
+
+/// @brief Returns the number of patterns in 'tokenizer'.
+size_t roy_tokenizer_pattern_count(const RoyTokenizer * tokenizer);
+
+/* OPERATIONS */
+
+/**
+ * @brief Splits the first 'length' characters of 'str' into tokens by one scan.
+ * @param count - receives the number of tokens.
+ * @return a newly allocated array of the tokens in order, which should be released by 'free'.
+ *         The '.begin' and '.end' of a token are positions in 'str', and '.type' is the 1-based index of its pattern.
+ * @note - The characters between tokens are skipped, and empty matches are never tokens.
+ * @note - Where several patterns match at the same position, the first listed one wins.
+ * @note - 'tokenizer' can be used by several threads at the same time.
+ */
+RoyMatch * roy_tokenizer_scan(const RoyTokenizer * tokenizer, const char * str, size_t length, size_t * count);
+
+#endif // ROYTOKENIZER_H
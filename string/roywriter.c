@@ -0,0 +1,239 @@
+#include "roywriter.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+struct RoyWriter_ {
+  char   * buffer;
+  size_t   size;
+  int      fd;
+  bool     owned;
+  bool     failed;
+};
+
+static bool write_vector(RoyWriter * writer, struct iovec * vector, size_t count);
+static bool fill(RoyWriter * writer, int ch, size_t count);
+
+RoyWriter *
+roy_writer_new(int fd) {
+  RoyWriter * ret = malloc(sizeof(RoyWriter));
+  ret->buffer = malloc(ROY_WRITER_BUFFER_SIZE);
+  ret->size   = 0;
+  ret->fd     = fd;
+  ret->owned  = false;
+  ret->failed = false;
+  return ret;
+}
+
+RoyWriter *
+roy_writer_open(const char * path,
+                bool         append) {
+  int fd = open(path, O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0644);
+  if (fd == -1) {
+    return NULL;
+  }
+  RoyWriter * ret = roy_writer_new(fd);
+  ret->owned = true;
+  return ret;
+}
+
+void
+roy_writer_delete(RoyWriter                    * writer,
+                  __attribute__((unused)) void * user_data) {
+  roy_writer_flush(writer);
+  if (writer->owned) {
+    close(writer->fd);
+  }
+  free(writer->buffer);
+  free(writer);
+}
+
+size_t
+roy_writer_pending(const RoyWriter * writer) {
+  return writer->size;
+}
+
+bool
+roy_writer_write(RoyWriter  * restrict writer,
+                 const char * restrict str,
+                 size_t                length) {
+  if (length <= ROY_WRITER_BUFFER_SIZE - writer->size) {
+    memcpy(writer->buffer + writer->size, str, length);
+    writer->size += length;
+    return !writer->failed;
+  }
+  if (length < ROY_WRITER_BUFFER_SIZE) {
+    roy_writer_flush(writer);
+    memcpy(writer->buffer, str, length);
+    writer->size = length;
+    return !writer->failed;
+  }
+  struct iovec vector[2] = {
+    { writer->buffer, writer->size },
+    { (void *)str,    length       }
+  };
+  return write_vector(writer, vector, 2);
+}
+
+bool
+roy_writer_puts(RoyWriter  * restrict writer,
+                const char * restrict str) {
+  return roy_writer_write(writer, str, strlen(str));
+}
+
+bool
+roy_writer_putchar(RoyWriter * writer,
+                   int         ch) {
+  if (writer->size == ROY_WRITER_BUFFER_SIZE) {
+    roy_writer_flush(writer);
+  }
+  writer->buffer[writer->size++] = (char)ch;
+  return !writer->failed;
+}
+
+bool
+roy_writer_printf(RoyWriter  * restrict writer,
+                  const char * restrict format,
+                  ...) {
+  va_list args, args_copy;
+  va_start(args, format);
+  va_copy(args_copy, args);
+  size_t available = ROY_WRITER_BUFFER_SIZE - writer->size;
+  int length = vsnprintf(writer->buffer + writer->size, available, format, args);
+  bool ret = length >= 0;
+  if (ret && (size_t)length < available) {
+    writer->size += length;
+    ret = !writer->failed;
+  } else if (ret && length < ROY_WRITER_BUFFER_SIZE) {
+    // Leaves room for the terminating '\0' of 'vsnprintf'.
+    roy_writer_flush(writer);
+    writer->size = vsnprintf(writer->buffer, ROY_WRITER_BUFFER_SIZE, format, args_copy);
+    ret = !writer->failed;
+  } else if (ret) {
+    char * str = malloc(length + 1);
+    vsnprintf(str, length + 1, format, args_copy);
+    ret = roy_writer_write(writer, str, length);
+    free(str);
+  }
+  va_end(args_copy);
+  va_end(args);
+  return ret;
+}
+
+bool
+roy_writer_print(RoyWriter       * restrict writer,
+                 const RoyString * restrict string) {
+  return roy_writer_write(writer, roy_string_cstr(string, 0), roy_string_length(string));
+}
+
+bool
+roy_writer_println(RoyWriter       * restrict writer,
+                   const RoyString * restrict string) {
+  roy_writer_print(writer, string);
+  if (roy_string_at(string, roy_string_length(string) - 1) != '\n') {
+    roy_writer_putchar(writer, '\n');
+  }
+  return !writer->failed;
+}
+
+bool
+roy_writer_printw(RoyWriter       * restrict writer,
+                  const RoyString * restrict string,
+                  int                        width) {
+  size_t length = roy_string_length(string);
+  size_t padding = (size_t)abs(width) > length ? (size_t)abs(width) - length : 0;
+  if (width > 0) {
+    fill(writer, ' ', padding);
+  }
+  roy_writer_print(writer, string);
+  if (width < 0) {
+    fill(writer, ' ', padding);
+  }
+  return !writer->failed;
+}
+
+bool
+roy_writer_print_all(RoyWriter       * restrict writer,
+                     const RoyString * const  * strings,
+                     size_t                     count) {
+  size_t total = 0;
+  for (size_t i = 0; i != count; i++) {
+    total += roy_string_length(strings[i]);
+  }
+  if (total <= ROY_WRITER_BUFFER_SIZE - writer->size) {
+    for (size_t i = 0; i != count; i++) {
+      roy_writer_print(writer, strings[i]);
+    }
+    return !writer->failed;
+  }
+  // The first batch carries the buffer in front of the strings.
+  struct iovec vector[ROY_WRITER_GATHER_CAPACITY + 1];
+  vector[0].iov_base = writer->buffer;
+  vector[0].iov_len  = writer->size;
+  size_t size = 1;
+  for (size_t i = 0; i != count; i++) {
+    vector[size].iov_base = (void *)roy_string_cstr(strings[i], 0);
+    vector[size].iov_len  = roy_string_length(strings[i]);
+    if (++size == ROY_WRITER_GATHER_CAPACITY + 1 || i == count - 1) {
+      write_vector(writer, vector, size);
+      size = 0;
+    }
+  }
+  return !writer->failed;
+}
+
+bool
+roy_writer_flush(RoyWriter * writer) {
+  struct iovec vector = { writer->buffer, writer->size };
+  return write_vector(writer, &vector, 1);
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+/* Writes out all of 'vector' by as many 'writev' as needed, then empties the buffer.
+   The buffered characters are dropped on a write error, and 'writer' stays failed. */
+static bool
+write_vector(RoyWriter    * writer,
+             struct iovec * vector,
+             size_t         count) {
+  while (!writer->failed && count != 0) {
+    if (vector->iov_len == 0) {
+      vector++;
+      count--;
+      continue;
+    }
+    ssize_t written = writev(writer->fd, vector, count);
+    if (written == -1) {
+      writer->failed = errno != EINTR;
+      continue;
+    }
+    for (; count != 0 && (size_t)written >= vector->iov_len; vector++, count--) {
+      written -= vector->iov_len;
+    }
+    if (count != 0) {
+      vector->iov_base  = (char *)vector->iov_base + written;
+      vector->iov_len  -= written;
+    }
+  }
+  writer->size = 0;
+  return !writer->failed;
+}
+
+static bool
+fill(RoyWriter * writer,
+     int         ch,
+     size_t      count) {
+  while (count != 0) {
+    if (writer->size == ROY_WRITER_BUFFER_SIZE) {
+      roy_writer_flush(writer);
+    }
+    size_t length = ROY_WRITER_BUFFER_SIZE - writer->size;
+    length = length < count ? length : count;
+    memset(writer->buffer + writer->size, ch, length);
+    writer->size += length;
+    count        -= length;
+  }
+  return !writer->failed;
+}
@@ -0,0 +1,90 @@
+#ifndef ROYWRITER_H
+#define ROYWRITER_H
+
+#include "../util/rpre.h"
+#include "roystring.h"
+
+enum {
+  ROY_WRITER_BUFFER_SIZE     = 0x10000,
+  ROY_WRITER_GATHER_CAPACITY = 0x40
+};
+
+/**
+ * @brief RoyWriter: collects output in a large buffer, and hands it to a file descriptor in as few system calls as possible.
+ * @note - Nothing is guaranteed to reach the file before 'roy_writer_flush' or 'roy_writer_delete'.
+ * @note - Do not mix a RoyWriter on STDOUT_FILENO with stdio output to stdout unless both are flushed in between.
+ */
+typedef struct RoyWriter_ RoyWriter;
+
+/* CONSTRUCTION AND DESTRUCTION */
+
+/**
+ * @brief Creates a RoyWriter on file descriptor 'fd'.
+ * @note - 'fd' is not owned by the writer, close it after the writer is deleted.
+ */
+RoyWriter * roy_writer_new(int fd);
+
+/**
+ * @brief Opens the file at 'path' for writing, and creates a RoyWriter owning it.
+ * @param append - whether to write at the end of the file, or to truncate the file first.
+ * @return The newly build RoyWriter.
+ * @return NULL - the file can not be opened.
+ */
+RoyWriter * roy_writer_open(const char * path, bool append);
+
+/**
+ * @brief Flushes the buffer, closes the file if owned, and destroys the RoyWriter - 'writer' itself.
+ * @note - Call 'roy_writer_flush' beforehand to learn whether all the output is written.
+ */
+void roy_writer_delete(RoyWriter * writer, void * user_data);
+
+/* CAPACITY */
+
+/// @brief Returns the number of characters buffered but not yet written.
+size_t roy_writer_pending(const RoyWriter * writer);
+
+/* OPERATIONS */
+
+/**
+ * @brief Writes the first 'length' characters of 'str'.
+ * @retval true - the operation is successful.
+ * @retval false - a write error occurs, now or at any earlier operation on 'writer'.
+ * @note - Long inputs are written along with the buffer in one system call instead of being copied.
+ */
+bool roy_writer_write(RoyWriter * restrict writer, const char * restrict str, size_t length);
+
+/// @brief Writes the C string 'str'.
+bool roy_writer_puts(RoyWriter * restrict writer, const char * restrict str);
+
+/// @brief Writes a single character 'ch'.
+bool roy_writer_putchar(RoyWriter * writer, int ch);
+
+/// @brief Writes formatted output like 'printf', formatting right into the buffer when it fits.
+bool roy_writer_printf(RoyWriter * restrict writer, const char * restrict format, ...);
+
+/// @brief Writes 'string'.
+bool roy_writer_print(RoyWriter * restrict writer, const RoyString * restrict string);
+
+/// @brief Writes 'string', adds a new line to the end of 'string' if there wasn't one.
+bool roy_writer_println(RoyWriter * restrict writer, const RoyString * restrict string);
+
+/**
+ * @brief Writes 'string' with 'width' specified.
+ * @param width - align right if positive, left if negative.
+ */
+bool roy_writer_printw(RoyWriter * restrict writer, const RoyString * restrict string, int width);
+
+/**
+ * @brief Writes 'count' RoyStrings in order, gathered by 'writev' so that they are not copied into the buffer.
+ * @note - Strings are gathered ROY_WRITER_GATHER_CAPACITY at a time, input that fits in the buffer is just copied.
+ */
+bool roy_writer_print_all(RoyWriter * restrict writer, const RoyString * const * strings, size_t count);
+
+/**
+ * @brief Writes out all the buffered characters.
+ * @retval true - all the output so far has been written.
+ * @retval false - a write error occurs, now or at any earlier operation on 'writer'.
+ */
+bool roy_writer_flush(RoyWriter * writer);
+
+#endif // ROYWRITER_H
@@ -0,0 +1,375 @@
+#include "roythreadpool.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+enum {
+  QUEUE_CAPACITY_BASE = 0x40,
+  CHUNKS_PER_THREAD   = 4
+};
+
+typedef struct {
+  RDoer  doer;
+  void * object;
+  void * user_data;
+} Task;
+
+// A ring buffer of tasks, the owner works on the back and thieves on the front.
+typedef struct {
+  pthread_mutex_t   lock;
+  Task            * tasks;
+  size_t            capacity;
+  size_t            front;
+  size_t            size;
+} WorkQueue;
+
+typedef struct {
+  RoyThreadPool * pool;
+  size_t          index;
+} Worker;
+
+struct RoyThreadPool_ {
+  pthread_t       * threads;
+  Worker          * workers;
+  WorkQueue       * queues;
+  size_t            thread_count;
+  pthread_mutex_t   lock;
+  pthread_cond_t    wake;
+  atomic_size_t     queued;   // tasks waiting in any of the queues
+  atomic_size_t     pending;  // tasks submitted but not finished yet
+  atomic_size_t     sleeping; // workers blocked on 'wake'
+  atomic_size_t     cursor;   // next queue for submissions from outside
+  bool              stop;
+};
+
+// A slice of a 'roy_thread_pool_for_range' job.
+typedef struct {
+  RRangeDoer      doer;
+  void          * user_data;
+  atomic_size_t   remaining;
+} RangeJob;
+
+typedef struct {
+  RangeJob * job;
+  size_t     begin;
+  size_t     end;
+} RangeChunk;
+
+typedef struct {
+  void ** data;
+  RDoer   doer;
+  void  * user_data;
+} ForEachJob;
+
+static _Thread_local Worker * current_worker = NULL;
+static RoyThreadPool * default_pool = NULL;
+static pthread_once_t  default_once = PTHREAD_ONCE_INIT;
+
+static void   queue_init(WorkQueue * queue);
+static void   queue_destroy(WorkQueue * queue);
+static void   queue_push_back(WorkQueue * queue, Task task);
+static bool   queue_pop_back(WorkQueue * queue, Task * task);
+static bool   queue_pop_front(WorkQueue * queue, Task * task);
+static size_t self_index(const RoyThreadPool * pool);
+static bool   run_one(RoyThreadPool * pool, size_t index);
+static void * worker_run(Worker * worker);
+static void   range_run(RangeChunk * chunk, RangeJob * job);
+static void   for_each_range(size_t begin, size_t end, ForEachJob * job);
+static void   default_new(void);
+static void   default_delete(void);
+
+RoyThreadPool *
+roy_thread_pool_new(size_t thread_count) {
+  if (thread_count == 0) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    thread_count = online > 0 ? (size_t)online : 1;
+  }
+  RoyThreadPool * ret = malloc(sizeof(RoyThreadPool));
+  ret->threads        = calloc(thread_count, sizeof(pthread_t));
+  ret->workers        = calloc(thread_count, sizeof(Worker));
+  ret->queues         = calloc(thread_count, sizeof(WorkQueue));
+  ret->thread_count   = thread_count;
+  ret->stop           = false;
+  pthread_mutex_init(&ret->lock, NULL);
+  pthread_cond_init(&ret->wake, NULL);
+  atomic_init(&ret->queued, 0);
+  atomic_init(&ret->pending, 0);
+  atomic_init(&ret->sleeping, 0);
+  atomic_init(&ret->cursor, 0);
+  for (size_t i = 0; i != thread_count; i++) {
+    queue_init(&ret->queues[i]);
+    ret->workers[i].pool  = ret;
+    ret->workers[i].index = i;
+  }
+  for (size_t i = 0; i != thread_count; i++) {
+    pthread_create(&ret->threads[i],
+                   NULL,
+                   (void * (*)(void *))worker_run,
+                   &ret->workers[i]);
+  }
+  return ret;
+}
+
+void
+roy_thread_pool_delete(RoyThreadPool * pool) {
+  pthread_mutex_lock(&pool->lock);
+  pool->stop = true;
+  pthread_cond_broadcast(&pool->wake);
+  pthread_mutex_unlock(&pool->lock);
+  for (size_t i = 0; i != roy_thread_pool_size(pool); i++) {
+    pthread_join(pool->threads[i], NULL);
+    queue_destroy(&pool->queues[i]);
+  }
+  pthread_cond_destroy(&pool->wake);
+  pthread_mutex_destroy(&pool->lock);
+  free(pool->queues);
+  free(pool->workers);
+  free(pool->threads);
+  free(pool);
+}
+
+RoyThreadPool *
+roy_thread_pool_default(void) {
+  pthread_once(&default_once, default_new);
+  return default_pool;
+}
+
+size_t
+roy_thread_pool_size(const RoyThreadPool * pool) {
+  return pool->thread_count;
+}
+
+void
+roy_thread_pool_submit(RoyThreadPool * pool,
+                       RDoer           doer,
+                       void          * object,
+                       void          * user_data) {
+  Task task = { doer, object, user_data };
+  size_t index = self_index(pool);
+  if (index == roy_thread_pool_size(pool)) {
+    index = atomic_fetch_add(&pool->cursor, 1) % roy_thread_pool_size(pool);
+  }
+  atomic_fetch_add(&pool->pending, 1);
+  queue_push_back(&pool->queues[index], task);
+  atomic_fetch_add(&pool->queued, 1);
+  // Pairs with the 'sleeping' increment in 'worker_run': either the worker
+  // sees the new task before blocking, or we see the sleeper and wake it up.
+  if (atomic_load(&pool->sleeping) > 0) {
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_signal(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+  }
+}
+
+void
+roy_thread_pool_wait(RoyThreadPool * pool) {
+  while (atomic_load(&pool->pending) > 0) {
+    if (!run_one(pool, self_index(pool))) {
+      sched_yield();
+    }
+  }
+}
+
+void
+roy_thread_pool_for_range(RoyThreadPool * pool,
+                          size_t          begin,
+                          size_t          end,
+                          size_t          grain,
+                          RRangeDoer      doer,
+                          void          * user_data) {
+  if (begin >= end) {
+    return;
+  }
+  pool = pool ? pool : roy_thread_pool_default();
+  grain = grain ? grain : 1;
+  size_t length = end - begin;
+  size_t chunk_count = (length + grain - 1) / grain;
+  size_t chunk_max = roy_thread_pool_size(pool) * CHUNKS_PER_THREAD;
+  chunk_count = chunk_count < chunk_max ? chunk_count : chunk_max;
+  if (chunk_count <= 1 || roy_thread_pool_size(pool) == 1) {
+    doer(begin, end, user_data);
+    return;
+  }
+
+  RangeJob job = { doer, user_data, 0 };
+  atomic_init(&job.remaining, chunk_count);
+  RangeChunk * chunks = calloc(chunk_count, sizeof(RangeChunk));
+  for (size_t i = 0; i != chunk_count; i++) {
+    chunks[i].job   = &job;
+    chunks[i].begin = begin + length * i / chunk_count;
+    chunks[i].end   = begin + length * (i + 1) / chunk_count;
+  }
+  // The first chunk is kept for the calling thread itself.
+  for (size_t i = chunk_count - 1; i != 0; i--) {
+    roy_thread_pool_submit(pool, (RDoer)range_run, &chunks[i], &job);
+  }
+  range_run(&chunks[0], &job);
+  size_t index = self_index(pool);
+  while (atomic_load(&job.remaining) > 0) {
+    if (!run_one(pool, index)) {
+      sched_yield();
+    }
+  }
+  free(chunks);
+}
+
+void
+roy_thread_pool_for_each(RoyThreadPool * pool,
+                         void         ** data,
+                         size_t          count,
+                         RDoer           doer,
+                         void          * user_data) {
+  ForEachJob job = { data, doer, user_data };
+  roy_thread_pool_for_range(pool,
+                            0,
+                            count,
+                            0,
+                            (RRangeDoer)for_each_range,
+                            &job);
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+static void
+queue_init(WorkQueue * queue) {
+  pthread_mutex_init(&queue->lock, NULL);
+  queue->tasks    = calloc(QUEUE_CAPACITY_BASE, sizeof(Task));
+  queue->capacity = QUEUE_CAPACITY_BASE;
+  queue->front    = 0;
+  queue->size     = 0;
+}
+
+static void
+queue_destroy(WorkQueue * queue) {
+  pthread_mutex_destroy(&queue->lock);
+  free(queue->tasks);
+}
+
+static void
+queue_push_back(WorkQueue * queue,
+                Task        task) {
+  pthread_mutex_lock(&queue->lock);
+  if (queue->size == queue->capacity) {
+    Task * tasks = calloc(queue->capacity * 2, sizeof(Task));
+    for (size_t i = 0; i != queue->size; i++) {
+      tasks[i] = queue->tasks[(queue->front + i) % queue->capacity];
+    }
+    free(queue->tasks);
+    queue->tasks     = tasks;
+    queue->capacity *= 2;
+    queue->front     = 0;
+  }
+  queue->tasks[(queue->front + queue->size) % queue->capacity] = task;
+  queue->size++;
+  pthread_mutex_unlock(&queue->lock);
+}
+
+static bool
+queue_pop_back(WorkQueue * queue,
+               Task      * task) {
+  bool ret = false;
+  pthread_mutex_lock(&queue->lock);
+  if (queue->size > 0) {
+    queue->size--;
+    *task = queue->tasks[(queue->front + queue->size) % queue->capacity];
+    ret = true;
+  }
+  pthread_mutex_unlock(&queue->lock);
+  return ret;
+}
+
+static bool
+queue_pop_front(WorkQueue * queue,
+                Task      * task) {
+  bool ret = false;
+  pthread_mutex_lock(&queue->lock);
+  if (queue->size > 0) {
+    *task = queue->tasks[queue->front];
+    queue->front = (queue->front + 1) % queue->capacity;
+    queue->size--;
+    ret = true;
+  }
+  pthread_mutex_unlock(&queue->lock);
+  return ret;
+}
+
+// Returns the index of the calling worker, or the pool size for outsiders.
+static size_t
+self_index(const RoyThreadPool * pool) {
+  return current_worker && current_worker->pool == pool ?
+         current_worker->index                          :
+         roy_thread_pool_size(pool);
+}
+
+static bool
+run_one(RoyThreadPool * pool,
+        size_t          index) {
+  if (atomic_load(&pool->queued) == 0) {
+    return false;
+  }
+  size_t count = roy_thread_pool_size(pool);
+  Task task;
+  bool found = index < count && queue_pop_back(&pool->queues[index], &task);
+  for (size_t i = 1; !found && i <= count; i++) {
+    found = queue_pop_front(&pool->queues[(index + i) % count], &task);
+  }
+  if (!found) {
+    return false;
+  }
+  atomic_fetch_sub(&pool->queued, 1);
+  task.doer(task.object, task.user_data);
+  atomic_fetch_sub(&pool->pending, 1);
+  return true;
+}
+
+static void *
+worker_run(Worker * worker) {
+  RoyThreadPool * pool = worker->pool;
+  current_worker = worker;
+  while (true) {
+    if (run_one(pool, worker->index)) {
+      continue;
+    }
+    pthread_mutex_lock(&pool->lock);
+    atomic_fetch_add(&pool->sleeping, 1);
+    while (!pool->stop && atomic_load(&pool->queued) == 0) {
+      pthread_cond_wait(&pool->wake, &pool->lock);
+    }
+    atomic_fetch_sub(&pool->sleeping, 1);
+    bool done = pool->stop && atomic_load(&pool->queued) == 0;
+    pthread_mutex_unlock(&pool->lock);
+    if (done) {
+      break;
+    }
+  }
+  current_worker = NULL;
+  return NULL;
+}
+
+static void
+range_run(RangeChunk * chunk,
+          RangeJob   * job) {
+  job->doer(chunk->begin, chunk->end, job->user_data);
+  atomic_fetch_sub(&job->remaining, 1);
+}
+
+static void
+for_each_range(size_t       begin,
+               size_t       end,
+               ForEachJob * job) {
+  for (size_t i = begin; i != end; i++) {
+    job->doer(job->data[i], job->user_data);
+  }
+}
+
+static void
+default_new(void) {
+  default_pool = roy_thread_pool_new(0);
+  atexit(default_delete);
+}
+
+static void
+default_delete(void) {
+  roy_thread_pool_delete(default_pool);
+}
@@ -0,0 +1,75 @@
+#ifndef ROYTHREADPOOL_H
+#define ROYTHREADPOOL_H
+
+#include "../util/rpre.h"
+
+/**
+ * @brief RoyThreadPool: a fixed group of worker threads, each of which owns a work-stealing deque.
+ *        A worker takes tasks from the back of its own deque, and steals from the front of the others' when idle.
+ */
+typedef struct RoyThreadPool_ RoyThreadPool;
+
+/// @brief A function to process the index range [begin, end) of a parallel job.
+typedef void (* RRangeDoer)(size_t begin, size_t end, void * user_data);
+
+/* CONSTRUCTION AND DESTRUCTION */
+
+/**
+ * @brief Creates a RoyThreadPool and starts all its workers.
+ * @param thread_count - number of worker threads, 0 to use the number of online processors.
+ * @return The newly build RoyThreadPool.
+ */
+RoyThreadPool * roy_thread_pool_new(size_t thread_count);
+
+/**
+ * @brief Finishes all pending tasks, stops the workers and destroys the RoyThreadPool - 'pool' itself.
+ * @note - The behavior is undefined if 'pool' is the default pool, or it is deleted by one of its own tasks.
+ */
+void roy_thread_pool_delete(RoyThreadPool * pool);
+
+/**
+ * @brief Accesses the process-wide pool shared by all 'parallel' functions.
+ * @return the default RoyThreadPool, which is created on first use with one worker per online processor.
+ */
+RoyThreadPool * roy_thread_pool_default(void);
+
+/* CAPACITY */
+
+/// @brief Returns the number of worker threads in 'pool'.
+size_t roy_thread_pool_size(const RoyThreadPool * pool);
+
+/* MODIFIERS */
+
+/**
+ * @brief Schedules 'doer'('object', 'user_data') to run on one of the workers of 'pool'.
+ * @note - A task submitted from a worker goes to that worker's own deque, otherwise the deques take turns.
+ */
+void roy_thread_pool_submit(RoyThreadPool * pool, RDoer doer, void * object, void * user_data);
+
+/**
+ * @brief Blocks until every task submitted to 'pool' is done, the calling thread executes tasks while waiting.
+ * @note - The behavior is undefined if this function is called from a task of 'pool'.
+ */
+void roy_thread_pool_wait(RoyThreadPool * pool);
+
+/* TRAVERSE */
+
+/**
+ * @brief Splits [begin, end) into chunks and processes them on 'pool', returns after all chunks are done.
+ * @param pool - the pool to run on, NULL to use the default pool.
+ * @param grain - the minimum number of indices per chunk, 0 to let 'pool' decide.
+ * @param doer - a function to process a chunk, may be called from several threads at the same time.
+ * @param user_data - data to cooperate with 'doer'.
+ * @note - The calling thread works on the chunks too, so it is safe to nest parallel jobs.
+ */
+void roy_thread_pool_for_range(RoyThreadPool * pool, size_t begin, size_t end, size_t grain, RRangeDoer doer, void * user_data);
+
+/**
+ * @brief Traverses 'count' elements of the pointer array 'data' on 'pool', in no particular order.
+ * @param pool - the pool to run on, NULL to use the default pool.
+ * @param doer - a function for element traversing, may be called from several threads at the same time.
+ * @param user_data - data to cooperate with 'doer'.
+ */
+void roy_thread_pool_for_each(RoyThreadPool * pool, void ** data, size_t count, RDoer doer, void * user_data);
+
+#endif // ROYTHREADPOOL_H
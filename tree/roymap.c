@@ -58,7 +58,8 @@ roy_map_insert(RoyMap * restrict map,
 RoyMap *
 roy_map_remove(RoyMap     * map,
                const void * key) {
-  map->root = roy_set_remove(&map->root, key, map->comparer, map->deleter, NULL);
+  RoyCPair pair = { key, NULL };
+  map->root = roy_set_remove(&map->root, &pair, map->comparer, map->deleter, NULL);
   return map;
 }
 
@@ -90,3 +91,11 @@ roy_map_for_which(RoyMap   * map,
                   void     * user_data) {
   roy_set_for_which(map->root, checker, doer, user_data);
 }
+
+void
+roy_map_parallel_for_each(RoyMap        * map,
+                          RoyThreadPool * pool,
+                          RDoer           doer,
+                          void          * user_data) {
+  roy_set_parallel_for_each(map->root, pool, doer, user_data);
+}
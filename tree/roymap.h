@@ -135,4 +135,13 @@ void roy_map_for_each(RoyMap * map, RDoer doer, void * user_data);
  */
 void roy_map_for_which(RoyMap * map, RChecker checker, RDoer doer, void * user_data);
 
+/**
+ * @brief Traverses all elements in 'map' concurrently on 'pool', in no particular order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param doer - a function for element traversing, must be safe to call from several threads at the same time.
+ * @param user_data - data to cooperate with 'doer'.
+ * @note - 'map' is split into subtrees, the split is only as even as the tree is balanced.
+ */
+void roy_map_parallel_for_each(RoyMap * map, RoyThreadPool * pool, RDoer doer, void * user_data);
+
 #endif // ROYMAP_H
\ No newline at end of file
@@ -100,3 +100,11 @@ roy_mmap_for_which(RoyMMap  * mmap,
                    void     * user_data) {
   roy_mset_for_which(mmap->root, checker, doer, user_data);
 }
+
+void
+roy_mmap_parallel_for_each(RoyMMap       * mmap,
+                           RoyThreadPool * pool,
+                           RDoer           doer,
+                           void          * user_data) {
+  roy_mset_parallel_for_each(mmap->root, pool, doer, user_data);
+}
@@ -140,4 +140,13 @@ void roy_mmap_for_each(RoyMMap * mmap, RDoer doer, void * user_data);
  */
 void roy_mmap_for_which(RoyMMap * mmap, RChecker checker, RDoer doer, void * user_data);
 
+/**
+ * @brief Traverses all elements in 'mmap' concurrently on 'pool', in no particular order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param doer - a function for element traversing, must be safe to call from several threads at the same time.
+ * @param user_data - data to cooperate with 'doer'.
+ * @note - 'mmap' is split into subtrees, the split is only as even as the tree is balanced.
+ */
+void roy_mmap_parallel_for_each(RoyMMap * mmap, RoyThreadPool * pool, RDoer doer, void * user_data);
+
 #endif // ROYMMAP_H
\ No newline at end of file
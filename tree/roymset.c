@@ -113,6 +113,14 @@ roy_mset_for_which(RoyMSet  * mset,
   roy_set_for_which((RoySet *)mset, checker, doer, user_data);
 }
 
+void
+roy_mset_parallel_for_each(RoyMSet       * mset,
+                           RoyThreadPool * pool,
+                           RDoer           doer,
+                           void          * user_data) {
+  roy_set_parallel_for_each((RoySet *)mset, pool, doer, user_data);
+}
+
 /* PRIVATE FUNCTIONS BELOW */
 
 static RoyMSet *
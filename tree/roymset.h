@@ -2,6 +2,7 @@
 #define ROYMSET_H
 
 #include "../util/rpre.h"
+#include "../thread/roythreadpool.h"
 
 struct RoyMSet_ {
   struct RoyMSet_ * left;
@@ -137,4 +138,13 @@ void roy_mset_for_each(RoyMSet * mset, RDoer doer, void * user_data);
  */
 void roy_mset_for_which(RoyMSet * mset, RChecker checker, RDoer doer, void * user_data);
 
+/**
+ * @brief Traverses all elements in 'mset' concurrently on 'pool', in no particular order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param doer - a function for element traversing, must be safe to call from several threads at the same time.
+ * @param user_data - data to cooperate with 'doer'.
+ * @note - 'mset' is split into subtrees, the split is only as even as the tree is balanced.
+ */
+void roy_mset_parallel_for_each(RoyMSet * mset, RoyThreadPool * pool, RDoer doer, void * user_data);
+
 #endif // ROYMSET_H
\ No newline at end of file
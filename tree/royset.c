@@ -1,7 +1,27 @@
 #include "royset.h"
+#include "../util/rstats.h"
+
+enum {
+  SPLIT_DEPTH = 8,
+  SPLIT_WIDTH = 1 << SPLIT_DEPTH
+};
+
+// 'set' cut at SPLIT_DEPTH: the nodes above the cut and the subtrees below it.
+typedef struct {
+  RoySet * nodes[SPLIT_WIDTH];
+  RoySet * subtrees[SPLIT_WIDTH];
+  size_t   node_count;
+  size_t   subtree_count;
+  RDoer    doer;
+  void   * user_data;
+} SplitJob;
 
 static RoySet * node_new(void * key);
 static void     node_delete(RoySet * set, RDoer deleter, void * user_data);
+static void     split(RoySet * set, size_t depth, SplitJob * job);
+static void     split_range(size_t begin, size_t end, SplitJob * job);
+static size_t   depth(const RoySet * set);
+static RoySet * detach_min(RoySet ** set);
 
 RoySet *
 roy_set_new(void) {
@@ -78,12 +98,18 @@ roy_set_insert(RoySet    ** restrict set,
                void      *  restrict key,
                RComparer    comparer) {
   if (!*set) {
+    R_STATS_ADD(R_STATS_SET_LOOKUPS, 1);
     *set = node_new(key);
-  } else if (comparer(key, (*set)->key) < 0) {
+    return *set;
+  }
+  R_STATS_ADD(R_STATS_SET_PROBES, 1);
+  if (comparer(key, (*set)->key) < 0) {
     (*set)->left = roy_set_insert(&(*set)->left, key, comparer);
   } else if (comparer(key, (*set)->key) > 0) {
     (*set)->right = roy_set_insert(&(*set)->right, key, comparer);
-  } // if (set->key == key) does nothing
+  } else { // (set->key == key) does nothing
+    R_STATS_ADD(R_STATS_SET_LOOKUPS, 1);
+  }
   return *set;
 }
 
@@ -94,8 +120,10 @@ roy_set_remove(RoySet     ** set,
                RDoer         deleter,
                void       *  user_data) {
   if (!*set) {
+    R_STATS_ADD(R_STATS_SET_LOOKUPS, 1);
     return NULL;
   }
+  R_STATS_ADD(R_STATS_SET_PROBES, 1);
   if (comparer(key, (*set)->key) < 0) {
     (*set)->left =
             roy_set_remove(&(*set)->left, key, comparer, deleter, user_data);
@@ -103,10 +131,18 @@ roy_set_remove(RoySet     ** set,
     (*set)->right =
             roy_set_remove(&(*set)->right, key, comparer, deleter, user_data);
   } else /* ((*set)->key == key), match found */ {
+    R_STATS_ADD(R_STATS_SET_LOOKUPS, 1);
     RoySet * temp = (*set);
     if ((*set)->left && (*set)->right) {
-      (*set)->key = roy_set_cmin((*set)->right)->key;
-      (*set)->right = roy_set_remove(set, key, comparer, deleter, user_data);
+      // Takes over the key of the successor, whose node is unlinked directly, as equal keys of a RoyMSet
+      // could lead a search by key to another node.
+      void * removed = (*set)->key;
+      RoySet * successor = detach_min(&(*set)->right);
+      (*set)->key = successor->key;
+      free(successor);
+      if (deleter) {
+        deleter(removed, user_data);
+      }
     } else
     if ((*set)->left && !(*set)->right) {
       *set = (*set)->left;
@@ -135,16 +171,31 @@ roy_set_find(RoySet     * set,
              const void * key, 
              RComparer    comparer) {
   if (!set) {
+    R_STATS_ADD(R_STATS_SET_LOOKUPS, 1);
     return NULL;
-  } else if (comparer(key, set->key) < 0) {
+  }
+  R_STATS_ADD(R_STATS_SET_PROBES, 1);
+  if (comparer(key, set->key) < 0) {
     return roy_set_find(set->left, key, comparer);
   } else if (comparer(key, set->key) > 0) {
     return roy_set_find(set->right, key, comparer);
   } else {
+    R_STATS_ADD(R_STATS_SET_LOOKUPS, 1);
     return set;
   }
 }
 
+void
+roy_set_stats(const RoySet * set,
+              RoySetStats  * stats) {
+  stats->size      = roy_set_size(set);
+  stats->depth     = depth(set);
+  stats->min_depth = 0;
+  for (size_t size = stats->size; size != 0; size >>= 1) {
+    stats->min_depth++;
+  }
+}
+
 void
 roy_set_for_each(RoySet * set,
                  RDoer    doer,
@@ -170,6 +221,26 @@ roy_set_for_which(RoySet   * set,
   }
 }
 
+void
+roy_set_parallel_for_each(RoySet        * set,
+                          RoyThreadPool * pool,
+                          RDoer           doer,
+                          void          * user_data) {
+  SplitJob * job = malloc(sizeof(SplitJob));
+  job->node_count    = 0;
+  job->subtree_count = 0;
+  job->doer          = doer;
+  job->user_data     = user_data;
+  split(set, SPLIT_DEPTH, job);
+  roy_thread_pool_for_range(pool,
+                            0,
+                            job->subtree_count + job->node_count,
+                            0,
+                            (RRangeDoer)split_range,
+                            job);
+  free(job);
+}
+
 /* PRIVATE FUNCTIONS BELOW */
 
 static RoySet *
@@ -178,6 +249,7 @@ node_new(void * key) {
   ret->left    = NULL;
   ret->right   = NULL;
   ret->key     = key;
+  R_STATS_ADD(R_STATS_SET_ALLOCATIONS, 1);
   return ret;
 }
 
@@ -190,4 +262,54 @@ node_delete(RoySet * set,
   }
   free(set);
   set = NULL;
-}
\ No newline at end of file
+}
+
+static void
+split(RoySet   * set,
+      size_t     depth,
+      SplitJob * job) {
+  if (!set) {
+    return;
+  }
+  if (depth == 0) {
+    job->subtrees[job->subtree_count++] = set;
+  } else {
+    job->nodes[job->node_count++] = set;
+    split(set->left, depth - 1, job);
+    split(set->right, depth - 1, job);
+  }
+}
+
+static void
+split_range(size_t     begin,
+            size_t     end,
+            SplitJob * job) {
+  for (size_t i = begin; i != end; i++) {
+    if (i < job->subtree_count) {
+      roy_set_for_each(job->subtrees[i], job->doer, job->user_data);
+    } else {
+      job->doer(job->nodes[i - job->subtree_count]->key, job->user_data);
+    }
+  }
+}
+
+static size_t
+depth(const RoySet * set) {
+  if (!set) {
+    return 0;
+  }
+  size_t left  = depth(set->left);
+  size_t right = depth(set->right);
+  return 1 + (left > right ? left : right);
+}
+
+// Unlinks the leftmost node of the non-empty 'set', and returns it.
+static RoySet *
+detach_min(RoySet ** set) {
+  while ((*set)->left) {
+    set = &(*set)->left;
+  }
+  RoySet * ret = *set;
+  *set = ret->right;
+  return ret;
+}
@@ -2,6 +2,7 @@
 #define ROYSET_H
 
 #include "../util/rpre.h"
+#include "../thread/roythreadpool.h"
 
 struct RoySet_ {
   struct RoySet_ * left;
@@ -16,6 +17,12 @@ struct RoySet_ {
  */
 typedef struct RoySet_ RoySet;
 
+typedef struct RoySetStats_ {
+  size_t size;
+  size_t depth;     // the number of nodes on the longest path from the root.
+  size_t min_depth; // the depth of a perfectly balanced tree of the same size.
+} RoySetStats;
+
 /* CONSTRUCTION AND DESTRUCTION */
 
 /**
@@ -112,6 +119,13 @@ RoySet * roy_set_remove(RoySet ** set, const void * key, RComparer comparer, RDo
  */
 RoySet * roy_set_find(RoySet * set, const void * key, RComparer comparer);
 
+/**
+ * @brief Reports the size and the depth of 'set' into 'stats', in linear time.
+ * @note - A 'depth' far above 'min_depth' means that 'set' has degenerated, e.g. by keys inserted in order.
+ * @note - Nodes visited per lookup are counted process-wide when roylib is built with ROY_STATS, see "util/rstats.h".
+ */
+void roy_set_stats(const RoySet * set, RoySetStats * stats);
+
 /* TRAVERSE */
 
 /**
@@ -129,4 +143,13 @@ void roy_set_for_each(RoySet * set, RDoer doer, void * user_data);
  */
 void roy_set_for_which(RoySet * set, RChecker checker, RDoer doer, void * user_data);
 
+/**
+ * @brief Traverses all elements in 'set' concurrently on 'pool', in no particular order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param doer - a function for element traversing, must be safe to call from several threads at the same time.
+ * @param user_data - data to cooperate with 'doer'.
+ * @note - 'set' is split into subtrees, the split is only as even as the tree is balanced.
+ */
+void roy_set_parallel_for_each(RoySet * set, RoyThreadPool * pool, RDoer doer, void * user_data);
+
 #endif // ROYSET_H
\ No newline at end of file
@@ -0,0 +1,256 @@
+#include "rparallel.h"
+
+enum {
+  SLICES_PER_THREAD = 4,
+  BUFFER_CAPACITY   = 0x40,
+  CACHE_LINE_SIZE   = 0x40
+};
+
+typedef struct {
+  void   ** data;
+  size_t    size;
+  size_t    capacity;
+} Buffer;
+
+// What a slice of slots is folded into, alone on its cache lines so that workers do not fight over one line.
+typedef struct __attribute__((aligned(CACHE_LINE_SIZE))) {
+  RReducer   reducer;
+  void     * accumulator;
+  RChecker   checker;
+  size_t     count;
+  RMapper    mapper;
+  void     * user_data;
+  Buffer     buffer;
+} Partial;
+
+// Slice i covers the slots [slot_count * i / slice_count, slot_count * (i + 1) / slice_count).
+typedef struct {
+  const void * container;
+  size_t       slot_count;
+  size_t       slice_count;
+  RVisitor     visitor;
+  RDoer        doer;
+  Partial    * partials;
+} SliceJob;
+
+static size_t slice_count(size_t slot_count, RoyThreadPool * pool);
+static void   run_slices(SliceJob * job, RoyThreadPool * pool);
+static Partial * partials_new(size_t count);
+static void   slice_range(size_t begin, size_t end, SliceJob * job);
+static void   reduce_one(const void * object, Partial * partial);
+static void   count_one(const void * object, Partial * partial);
+static void   collect_one(void * object, Partial * partial);
+
+void
+roy_visit_array(const void * container,
+                size_t       begin,
+                size_t       end,
+                RDoer        doer,
+                void       * user_data) {
+  void * const * data = container;
+  for (size_t i = begin; i != end; i++) {
+    doer(data[i], user_data);
+  }
+}
+
+void
+roy_reduce(const void * container,
+           size_t       slot_count,
+           RVisitor     visitor,
+           void       * accumulator,
+           RReducer     reducer) {
+  Partial partial = { .reducer = reducer, .accumulator = accumulator };
+  visitor(container, 0, slot_count, (RDoer)reduce_one, &partial);
+}
+
+void
+roy_parallel_reduce(const void    * container,
+                    size_t          slot_count,
+                    RVisitor        visitor,
+                    RoyThreadPool * pool,
+                    void          * accumulator,
+                    size_t          accumulator_size,
+                    RReducer        reducer,
+                    RMerger         merger) {
+  pool = pool ? pool : roy_thread_pool_default();
+  size_t count = slice_count(slot_count, pool);
+  if (count <= 1) {
+    roy_reduce(container, slot_count, visitor, accumulator, reducer);
+    return;
+  }
+  // Partials are a cache line apart at least, so that workers do not fight over one line.
+  size_t stride = (accumulator_size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+  unsigned char * storage = calloc(count, stride);
+  SliceJob job = { container, slot_count, count, visitor, (RDoer)reduce_one,
+                   partials_new(count) };
+  for (size_t i = 0; i != count; i++) {
+    memcpy(storage + i * stride, accumulator, accumulator_size);
+    job.partials[i].reducer     = reducer;
+    job.partials[i].accumulator = storage + i * stride;
+  }
+  run_slices(&job, pool);
+  for (size_t i = 0; i != count; i++) {
+    merger(accumulator, job.partials[i].accumulator);
+  }
+  free(job.partials);
+  free(storage);
+}
+
+size_t
+roy_count_if(const void * container,
+             size_t       slot_count,
+             RVisitor     visitor,
+             RChecker     checker) {
+  Partial partial = { .checker = checker };
+  visitor(container, 0, slot_count, (RDoer)count_one, &partial);
+  return partial.count;
+}
+
+size_t
+roy_parallel_count_if(const void    * container,
+                      size_t          slot_count,
+                      RVisitor        visitor,
+                      RoyThreadPool * pool,
+                      RChecker        checker) {
+  pool = pool ? pool : roy_thread_pool_default();
+  size_t count = slice_count(slot_count, pool);
+  if (count <= 1) {
+    return roy_count_if(container, slot_count, visitor, checker);
+  }
+  SliceJob job = { container, slot_count, count, visitor, (RDoer)count_one,
+                   partials_new(count) };
+  for (size_t i = 0; i != count; i++) {
+    job.partials[i].checker = checker;
+  }
+  run_slices(&job, pool);
+  size_t ret = 0;
+  for (size_t i = 0; i != count; i++) {
+    ret += job.partials[i].count;
+  }
+  free(job.partials);
+  return ret;
+}
+
+void **
+roy_collect(const void * container,
+            size_t       slot_count,
+            RVisitor     visitor,
+            RChecker     checker,
+            RMapper      mapper,
+            void       * user_data,
+            size_t     * count) {
+  Partial partial = { .checker = checker, .mapper = mapper, .user_data = user_data };
+  visitor(container, 0, slot_count, (RDoer)collect_one, &partial);
+  *count = partial.buffer.size;
+  return partial.buffer.data;
+}
+
+void **
+roy_parallel_collect(const void    * container,
+                     size_t          slot_count,
+                     RVisitor        visitor,
+                     RoyThreadPool * pool,
+                     RChecker        checker,
+                     RMapper         mapper,
+                     void          * user_data,
+                     size_t        * count) {
+  pool = pool ? pool : roy_thread_pool_default();
+  size_t slices = slice_count(slot_count, pool);
+  if (slices <= 1) {
+    return roy_collect(container, slot_count, visitor, checker, mapper, user_data, count);
+  }
+  SliceJob job = { container, slot_count, slices, visitor, (RDoer)collect_one,
+                   partials_new(slices) };
+  for (size_t i = 0; i != slices; i++) {
+    job.partials[i].checker   = checker;
+    job.partials[i].mapper    = mapper;
+    job.partials[i].user_data = user_data;
+  }
+  run_slices(&job, pool);
+  size_t size = 0;
+  for (size_t i = 0; i != slices; i++) {
+    size += job.partials[i].buffer.size;
+  }
+  void ** ret = malloc((size ? size : 1) * R_PTR_SIZE);
+  size = 0;
+  for (size_t i = 0; i != slices; i++) {
+    Buffer * buffer = &job.partials[i].buffer;
+    memcpy(ret + size, buffer->data, buffer->size * R_PTR_SIZE);
+    size += buffer->size;
+    free(buffer->data);
+  }
+  free(job.partials);
+  *count = size;
+  return ret;
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+static size_t
+slice_count(size_t          slot_count,
+            RoyThreadPool * pool) {
+  size_t slice_max = roy_thread_pool_size(pool) == 1 ?
+                     1 : roy_thread_pool_size(pool) * SLICES_PER_THREAD;
+  return slot_count < slice_max ? slot_count : slice_max;
+}
+
+static void
+run_slices(SliceJob      * job,
+           RoyThreadPool * pool) {
+  roy_thread_pool_for_range(pool,
+                            0,
+                            job->slice_count,
+                            1,
+                            (RRangeDoer)slice_range,
+                            job);
+}
+
+// Returns 'count' zeroed partials, starting at a cache line.
+static Partial *
+partials_new(size_t count) {
+  Partial * ret = aligned_alloc(CACHE_LINE_SIZE, count * sizeof(Partial));
+  memset(ret, 0, count * sizeof(Partial));
+  return ret;
+}
+
+static void
+slice_range(size_t     begin,
+            size_t     end,
+            SliceJob * job) {
+  for (size_t i = begin; i != end; i++) {
+    job->visitor(job->container,
+                 job->slot_count * i / job->slice_count,
+                 job->slot_count * (i + 1) / job->slice_count,
+                 job->doer,
+                 &job->partials[i]);
+  }
+}
+
+static void
+reduce_one(const void * object,
+           Partial    * partial) {
+  partial->reducer(partial->accumulator, object);
+}
+
+static void
+count_one(const void * object,
+          Partial    * partial) {
+  if (partial->checker(object)) {
+    partial->count++;
+  }
+}
+
+static void
+collect_one(void    * object,
+            Partial * partial) {
+  if (partial->checker && !partial->checker(object)) {
+    return;
+  }
+  Buffer * buffer = &partial->buffer;
+  if (buffer->size == buffer->capacity) {
+    buffer->capacity = buffer->capacity ? buffer->capacity * 2 : BUFFER_CAPACITY;
+    buffer->data = realloc(buffer->data, buffer->capacity * R_PTR_SIZE);
+  }
+  buffer->data[buffer->size++] =
+    partial->mapper ? partial->mapper(object, partial->user_data) : object;
+}
@@ -0,0 +1,67 @@
+#ifndef RPARALLEL_H
+#define RPARALLEL_H
+
+#include "rpre.h"
+#include "../thread/roythreadpool.h"
+
+/**
+ * @brief A function to traverse the slots [begin, end) of 'container' in order,
+ *        a slot can be an index of an array, a bucket of a hash table and so on.
+ */
+typedef void (* RVisitor)(const void * container, size_t begin, size_t end, RDoer doer, void * user_data);
+
+/// @brief The RVisitor of a pointer array, each slot holds one element.
+void roy_visit_array(const void * container, size_t begin, size_t end, RDoer doer, void * user_data);
+
+/**
+ * @brief Folds every element of 'container' into 'accumulator' sequentially.
+ * @param slot_count - number of slots in 'container'.
+ * @param visitor - a function to traverse a range of slots of 'container'.
+ * @param reducer - a function to fold an element into 'accumulator'.
+ */
+void roy_reduce(const void * container, size_t slot_count, RVisitor visitor, void * accumulator, RReducer reducer);
+
+/**
+ * @brief Folds every element of 'container' into 'accumulator' on 'pool'.
+ * @param slot_count - number of slots in 'container'.
+ * @param visitor - a function to traverse a range of slots of 'container', may be called from several threads at the same time.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param accumulator - holds the identity of 'merger' on entry, and the result on return.
+ * @param accumulator_size - the size of 'accumulator' in bytes.
+ * @param reducer - a function to fold an element into a partial accumulator.
+ * @param merger - a function to fold a partial accumulator into 'accumulator'.
+ * @note - Every slice of slots is folded into its own bytewise copy of 'accumulator',
+ *         the partials are then merged in slot order by the calling thread, so 'merger' needs not be commutative.
+ */
+void roy_parallel_reduce(const void * container, size_t slot_count, RVisitor visitor, RoyThreadPool * pool, void * accumulator, size_t accumulator_size, RReducer reducer, RMerger merger);
+
+/// @brief Returns the number of elements in 'container' which meet 'checker'.
+size_t roy_count_if(const void * container, size_t slot_count, RVisitor visitor, RChecker checker);
+
+/**
+ * @brief Returns the number of elements in 'container' which meet 'checker', counted on 'pool'.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param checker - may be called from several threads at the same time.
+ */
+size_t roy_parallel_count_if(const void * container, size_t slot_count, RVisitor visitor, RoyThreadPool * pool, RChecker checker);
+
+/**
+ * @brief Gathers the elements of 'container' into a newly allocated pointer array, in slot order.
+ * @param checker - a function to check whether an element should be gathered, NULL to gather all.
+ * @param mapper - a function to map a gathered element to what is stored, NULL to store the element itself.
+ * @param user_data - data to cooperate with 'mapper'.
+ * @param count - receives the number of gathered elements.
+ * @return The pointer array, which should be released by 'free'.
+ */
+void ** roy_collect(const void * container, size_t slot_count, RVisitor visitor, RChecker checker, RMapper mapper, void * user_data, size_t * count);
+
+/**
+ * @brief Gathers the elements of 'container' into a newly allocated pointer array on 'pool', in slot order.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @param checker - may be called from several threads at the same time, NULL to gather all.
+ * @param mapper - may be called from several threads at the same time, NULL to store the element itself.
+ * @note - Every slice of slots is gathered into its own buffer, the buffers are concatenated at the end.
+ */
+void ** roy_parallel_collect(const void * container, size_t slot_count, RVisitor visitor, RoyThreadPool * pool, RChecker checker, RMapper mapper, void * user_data, size_t * count);
+
+#endif // RPARALLEL_H
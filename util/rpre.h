@@ -15,6 +15,9 @@ typedef void     (* RDoer)     (void * object, void * user_data);
 typedef bool     (* RChecker)  (const void * object);
 typedef int      (* RComparer) (const void * lhs, const void * rhs);
 typedef uint64_t (* RHash)     (const void * key, size_t key_size, uint64_t seed);
+typedef void *   (* RMapper)   (const void * object, void * user_data);
+typedef void     (* RReducer)  (void * accumulator, const void * object);
+typedef void     (* RMerger)   (void * accumulator, const void * partial);
 
 enum RNumber {
   R_PTR_SIZE = sizeof(void *),
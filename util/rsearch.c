@@ -0,0 +1,56 @@
+#include "rsearch.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+enum {
+  BLOCK_SIZE = 0x10
+};
+
+const char *
+roy_memmem(const char * haystack,
+           size_t       haystack_length,
+           const char * needle,
+           size_t       needle_length) {
+  if (needle_length == 0) {
+    return haystack;
+  }
+  if (needle_length > haystack_length) {
+    return NULL;
+  }
+  if (needle_length == 1) {
+    return memchr(haystack, needle[0], haystack_length);
+  }
+  // Every candidate position in [0, end) leaves room for the whole 'needle'.
+  size_t end = haystack_length - needle_length + 1;
+  size_t i = 0;
+#ifdef __SSE2__
+  const __m128i first = _mm_set1_epi8(needle[0]);
+  const __m128i last  = _mm_set1_epi8(needle[needle_length - 1]);
+  for (; i + BLOCK_SIZE <= end; i += BLOCK_SIZE) {
+    __m128i block_first = _mm_loadu_si128((const __m128i *)(haystack + i));
+    __m128i block_last  = _mm_loadu_si128((const __m128i *)(haystack + i + needle_length - 1));
+    unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, first),
+                                                    _mm_cmpeq_epi8(block_last, last)));
+    while (mask != 0) {
+      size_t candidate = i + __builtin_ctz(mask);
+      if (memcmp(haystack + candidate + 1, needle + 1, needle_length - 2) == 0) {
+        return haystack + candidate;
+      }
+      mask &= mask - 1;
+    }
+  }
+#endif
+  while (i != end) {
+    const char * candidate = memchr(haystack + i, needle[0], end - i);
+    if (candidate == NULL) {
+      return NULL;
+    }
+    if (memcmp(candidate + 1, needle + 1, needle_length - 1) == 0) {
+      return candidate;
+    }
+    i = candidate - haystack + 1;
+  }
+  return NULL;
+}
@@ -0,0 +1,17 @@
+#ifndef RSEARCH_H
+#define RSEARCH_H
+
+#include "rpre.h"
+
+/**
+ * @brief Finds the first occurrence of 'needle' in 'haystack', neither needs a terminating '\0'.
+ * @param haystack_length - number of characters in 'haystack'.
+ * @param needle_length - number of characters in 'needle'.
+ * @return a pointer to the first occurrence in 'haystack'.
+ * @return NULL - 'needle' does not occur.
+ * @note - With SSE2, 16 positions are filtered at a time by comparing the first and the last character of 'needle',
+ *         only the candidates which pass both are compared in full.
+ */
+const char * roy_memmem(const char * haystack, size_t haystack_length, const char * needle, size_t needle_length);
+
+#endif // RSEARCH_H
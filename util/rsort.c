@@ -0,0 +1,235 @@
+#include "rsort.h"
+
+enum {
+  INSERTION_LENGTH = 0x20,
+  PIECE_MIN_LENGTH = 0x1000,
+  RUNS_PER_THREAD  = 4
+};
+
+// The runs of 'data' that one parallel round works on.
+typedef struct {
+  void      ** data;
+  void      ** temp;
+  size_t     * bounds;     // run i is [bounds[i], bounds[i + 1])
+  size_t       run_count;
+  RComparer    comparer;
+} SortJob;
+
+// An output slice [begin, end) of the merge of runs 'pair' * 2 and 'pair' * 2 + 1.
+typedef struct {
+  size_t pair;
+  size_t begin;
+  size_t end;
+} Piece;
+
+typedef struct {
+  SortJob * job;
+  Piece   * pieces;
+} MergeJob;
+
+static void   insertion_sort(void ** data, size_t count, RComparer comparer);
+static void   merge(void ** dest, void ** lhs, size_t lhs_count, void ** rhs, size_t rhs_count, RComparer comparer);
+static size_t co_rank(size_t rank, void ** lhs, size_t lhs_count, void ** rhs, size_t rhs_count, RComparer comparer);
+static void   sort_run(void ** data, void ** temp, size_t count, RComparer comparer);
+static void   sort_runs(size_t begin, size_t end, SortJob * job);
+static void   merge_pieces(size_t begin, size_t end, MergeJob * job);
+
+void
+roy_sort(void      ** data,
+         size_t       count,
+         RComparer    comparer) {
+  void ** temp = calloc(count, R_PTR_SIZE);
+  sort_run(data, temp, count, comparer);
+  free(temp);
+}
+
+void
+roy_parallel_sort(void         ** data,
+                  size_t          count,
+                  RComparer       comparer,
+                  RoyThreadPool * pool) {
+  pool = pool ? pool : roy_thread_pool_default();
+  size_t run_count = roy_thread_pool_size(pool) * RUNS_PER_THREAD;
+  if (count < PIECE_MIN_LENGTH * 2 || roy_thread_pool_size(pool) == 1) {
+    roy_sort(data, count, comparer);
+    return;
+  }
+  if (run_count > count / PIECE_MIN_LENGTH) {
+    run_count = count / PIECE_MIN_LENGTH;
+  }
+  SortJob job;
+  job.data      = data;
+  job.temp      = calloc(count, R_PTR_SIZE);
+  job.bounds    = calloc(run_count + 1, sizeof(size_t));
+  job.run_count = run_count;
+  job.comparer  = comparer;
+  for (size_t i = 0; i <= run_count; i++) {
+    job.bounds[i] = count * i / run_count;
+  }
+  roy_thread_pool_for_range(pool, 0, run_count, 1, (RRangeDoer)sort_runs, &job);
+
+  size_t piece_length = count / (roy_thread_pool_size(pool) * RUNS_PER_THREAD);
+  piece_length = piece_length > PIECE_MIN_LENGTH ? piece_length : PIECE_MIN_LENGTH;
+  Piece * pieces = calloc(count / piece_length + run_count, sizeof(Piece));
+  while (job.run_count > 1) {
+    size_t piece_count = 0;
+    for (size_t pair = 0; pair * 2 < job.run_count; pair++) {
+      size_t begin = job.bounds[pair * 2];
+      size_t end = job.bounds[pair * 2 + 2 <= job.run_count ?
+                              pair * 2 + 2 : job.run_count];
+      for (size_t i = begin; i < end; i += piece_length) {
+        pieces[piece_count].pair  = pair;
+        pieces[piece_count].begin = i;
+        pieces[piece_count].end   = i + piece_length < end ? i + piece_length : end;
+        piece_count++;
+      }
+    }
+    MergeJob merge_job = { &job, pieces };
+    roy_thread_pool_for_range(pool,
+                              0,
+                              piece_count,
+                              1,
+                              (RRangeDoer)merge_pieces,
+                              &merge_job);
+    // Every other bound disappears, and the roles of the buffers swap.
+    size_t run_count_new = (job.run_count + 1) / 2;
+    for (size_t i = 1; i < run_count_new; i++) {
+      job.bounds[i] = job.bounds[i * 2];
+    }
+    job.bounds[run_count_new] = count;
+    job.run_count = run_count_new;
+    void ** temp = job.data;
+    job.data = job.temp;
+    job.temp = temp;
+  }
+  if (job.data != data) {
+    memcpy(data, job.data, count * R_PTR_SIZE);
+    job.temp = job.data;
+  }
+  free(pieces);
+  free(job.bounds);
+  free(job.temp);
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+static void
+insertion_sort(void      ** data,
+               size_t       count,
+               RComparer    comparer) {
+  for (size_t i = 1; i < count; i++) {
+    void * key = data[i];
+    size_t j = i;
+    for (; j > 0 && comparer(data[j - 1], key) > 0; j--) {
+      data[j] = data[j - 1];
+    }
+    data[j] = key;
+  }
+}
+
+// Stable: equivalent elements from 'lhs' come before those from 'rhs'.
+static void
+merge(void      ** dest,
+      void      ** lhs,
+      size_t       lhs_count,
+      void      ** rhs,
+      size_t       rhs_count,
+      RComparer    comparer) {
+  size_t i = 0, j = 0;
+  while (i < lhs_count && j < rhs_count) {
+    *dest++ = comparer(lhs[i], rhs[j]) <= 0 ? lhs[i++] : rhs[j++];
+  }
+  memcpy(dest, lhs + i, (lhs_count - i) * R_PTR_SIZE);
+  memcpy(dest + lhs_count - i, rhs + j, (rhs_count - j) * R_PTR_SIZE);
+}
+
+// Returns how many elements of 'lhs' are among the first 'rank' elements of the merged output.
+static size_t
+co_rank(size_t       rank,
+        void      ** lhs,
+        size_t       lhs_count,
+        void      ** rhs,
+        size_t       rhs_count,
+        RComparer    comparer) {
+  size_t low  = rank > rhs_count ? rank - rhs_count : 0;
+  size_t high = rank < lhs_count ? rank : lhs_count;
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+    if (comparer(rhs[rank - middle - 1], lhs[middle]) >= 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+// Sorts 'data' bottom-up, 'temp' must be able to hold 'count' elements.
+static void
+sort_run(void      ** data,
+         void      ** temp,
+         size_t       count,
+         RComparer    comparer) {
+  for (size_t i = 0; i < count; i += INSERTION_LENGTH) {
+    insertion_sort(data + i,
+                   count - i < INSERTION_LENGTH ? count - i : INSERTION_LENGTH,
+                   comparer);
+  }
+  void ** src = data;
+  void ** dest = temp;
+  for (size_t width = INSERTION_LENGTH; width < count; width *= 2) {
+    for (size_t i = 0; i < count; i += width * 2) {
+      size_t middle = i + width < count ? i + width : count;
+      size_t end = i + width * 2 < count ? i + width * 2 : count;
+      merge(dest + i, src + i, middle - i, src + middle, end - middle, comparer);
+    }
+    void ** swap = src;
+    src = dest;
+    dest = swap;
+  }
+  if (src != data) {
+    memcpy(data, src, count * R_PTR_SIZE);
+  }
+}
+
+static void
+sort_runs(size_t    begin,
+          size_t    end,
+          SortJob * job) {
+  for (size_t i = begin; i != end; i++) {
+    size_t offset = job->bounds[i];
+    sort_run(job->data + offset,
+             job->temp + offset,
+             job->bounds[i + 1] - offset,
+             job->comparer);
+  }
+}
+
+static void
+merge_pieces(size_t     begin,
+             size_t     end,
+             MergeJob * job) {
+  SortJob * sort_job = job->job;
+  for (size_t i = begin; i != end; i++) {
+    const Piece * piece = &job->pieces[i];
+    size_t lhs_begin = sort_job->bounds[piece->pair * 2];
+    size_t rhs_begin = sort_job->bounds[piece->pair * 2 + 1 <= sort_job->run_count ?
+                                        piece->pair * 2 + 1 : sort_job->run_count];
+    size_t rhs_end   = sort_job->bounds[piece->pair * 2 + 2 <= sort_job->run_count ?
+                                        piece->pair * 2 + 2 : sort_job->run_count];
+    void ** lhs = sort_job->data + lhs_begin;
+    void ** rhs = sort_job->data + rhs_begin;
+    size_t lhs_count = rhs_begin - lhs_begin;
+    size_t rhs_count = rhs_end - rhs_begin;
+    size_t rank_begin = piece->begin - lhs_begin;
+    size_t rank_end = piece->end - lhs_begin;
+    size_t i_begin = co_rank(rank_begin, lhs, lhs_count, rhs, rhs_count, sort_job->comparer);
+    size_t i_end = co_rank(rank_end, lhs, lhs_count, rhs, rhs_count, sort_job->comparer);
+    merge(sort_job->temp + piece->begin,
+          lhs + i_begin,
+          i_end - i_begin,
+          rhs + rank_begin - i_begin,
+          (rank_end - i_end) - (rank_begin - i_begin),
+          sort_job->comparer);
+  }
+}
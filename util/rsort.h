@@ -0,0 +1,24 @@
+#ifndef RSORT_H
+#define RSORT_H
+
+#include "rpre.h"
+#include "../thread/roythreadpool.h"
+
+/**
+ * @brief Sorts the pointer array 'data' in ascending order with a stable merge sort.
+ * @param count - number of elements in 'data'.
+ * @param comparer - a function to compare two elements, acting like <=> operator in C++.
+ */
+void roy_sort(void ** data, size_t count, RComparer comparer);
+
+/**
+ * @brief Sorts the pointer array 'data' in ascending order with a stable merge sort on 'pool'.
+ * @param count - number of elements in 'data'.
+ * @param comparer - a function to compare two elements, may be called from several threads at the same time.
+ * @param pool - the RoyThreadPool to run on, NULL to use the default pool.
+ * @note - Every worker sorts its own runs first, then the runs are merged pairwise,
+ *         each merge is cut into pieces of equal output length so that all workers stay busy till the last round.
+ */
+void roy_parallel_sort(void ** data, size_t count, RComparer comparer, RoyThreadPool * pool);
+
+#endif // RSORT_H
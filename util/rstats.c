@@ -0,0 +1,76 @@
+#include "rstats.h"
+#include <inttypes.h>
+#include <stdatomic.h>
+
+static const char * NAMES[R_STATS_COUNTER_COUNT] = {
+  "vector.allocations",
+  "vector.reallocs",
+  "set.allocations",
+  "set.lookups",
+  "set.probes",
+  "uset.allocations",
+  "uset.lookups",
+  "uset.probes",
+  "regex.compiles",
+  "regex.cache_hits"
+};
+
+static atomic_uint_fast64_t counters[R_STATS_COUNTER_COUNT];
+
+static void dump_ratio(FILE * stream, const char * name, RStatsCounter probes, RStatsCounter lookups);
+
+void
+roy_stats_add(RStatsCounter counter,
+              uint64_t      count) {
+  atomic_fetch_add_explicit(&counters[counter], count, memory_order_relaxed);
+}
+
+bool
+roy_stats_enabled(void) {
+#ifdef ROY_STATS
+  return true;
+#else
+  return false;
+#endif
+}
+
+uint64_t
+roy_stats_counter(RStatsCounter counter) {
+  return atomic_load_explicit(&counters[counter], memory_order_relaxed);
+}
+
+const char *
+roy_stats_name(RStatsCounter counter) {
+  return NAMES[counter];
+}
+
+void
+roy_stats_reset(void) {
+  for (size_t i = 0; i != R_STATS_COUNTER_COUNT; i++) {
+    atomic_store_explicit(&counters[i], 0, memory_order_relaxed);
+  }
+}
+
+void
+roy_stats_dump(FILE * stream) {
+  if (!roy_stats_enabled()) {
+    fprintf(stream, "roylib is built without ROY_STATS, no counters are kept\n");
+    return;
+  }
+  for (size_t i = 0; i != R_STATS_COUNTER_COUNT; i++) {
+    fprintf(stream, "%-24s %" PRIu64 "\n", NAMES[i], roy_stats_counter((RStatsCounter)i));
+  }
+  dump_ratio(stream, "set.probes_per_lookup", R_STATS_SET_PROBES, R_STATS_SET_LOOKUPS);
+  dump_ratio(stream, "uset.probes_per_lookup", R_STATS_USET_PROBES, R_STATS_USET_LOOKUPS);
+}
+
+/* PRIVATE FUNCTIONS BELOW */
+
+static void
+dump_ratio(FILE          * stream,
+           const char    * name,
+           RStatsCounter   probes,
+           RStatsCounter   lookups) {
+  uint64_t count = roy_stats_counter(lookups);
+  fprintf(stream, "%-24s %.2f\n", name, count != 0 ? (double)roy_stats_counter(probes) / count : 0.0);
+}
@@ -0,0 +1,54 @@
+#ifndef RSTATS_H
+#define RSTATS_H
+
+#include "rpre.h"
+
+/**
+ * @brief Process-wide counters of what the containers are doing, kept only when roylib is built with ROY_STATS
+ * (cmake -DROY_STATS=ON). Otherwise every counting site compiles to nothing and all counters read 0.
+ * @note - Counters are shared by all threads and updated with relaxed atomics, expect some contention while enabled.
+ * @note - The shape of a container, e.g. the chain lengths of a RoyUSet or the depth of a RoySet,
+ *         is available from 'roy_uset_stats' and 'roy_set_stats' in any build, as it costs nothing until asked for.
+ */
+typedef enum RStatsCounter_ {
+  R_STATS_VECTOR_ALLOCATIONS, // RoyVector buffers allocated by 'roy_vector_new'.
+  R_STATS_VECTOR_REALLOCS,    // RoyVector buffers grown or shrunk.
+  R_STATS_SET_ALLOCATIONS,    // RoySet nodes allocated.
+  R_STATS_SET_LOOKUPS,        // RoySet inserts, removals and finds.
+  R_STATS_SET_PROBES,         // RoySet nodes visited by lookups.
+  R_STATS_USET_ALLOCATIONS,   // RoyUSet buckets and chain nodes allocated.
+  R_STATS_USET_LOOKUPS,       // RoyUSet inserts, removals and finds.
+  R_STATS_USET_PROBES,        // RoyUSet elements compared by lookups.
+  R_STATS_REGEX_COMPILES,     // patterns compiled by pcre2, by 'roy_string_find', RoyRegex or RoyTokenizer.
+  R_STATS_REGEX_CACHE_HITS,   // patterns found compiled in the cache of 'roy_regex_cached'.
+  R_STATS_COUNTER_COUNT
+} RStatsCounter;
+
+#ifdef ROY_STATS
+#define R_STATS_ADD(counter, count) roy_stats_add((counter), (count))
+#else
+#define R_STATS_ADD(counter, count) ((void)0)
+#endif
+
+/// @brief Adds 'count' to 'counter', use R_STATS_ADD instead so that it compiles away without ROY_STATS.
+void roy_stats_add(RStatsCounter counter, uint64_t count);
+
+/// @brief Returns whether roylib is built with ROY_STATS, i.e. whether the counters are kept at all.
+bool roy_stats_enabled(void);
+
+/// @brief Returns the current value of 'counter'.
+uint64_t roy_stats_counter(RStatsCounter counter);
+
+/// @brief Returns the name of 'counter', as printed by 'roy_stats_dump'.
+const char * roy_stats_name(RStatsCounter counter);
+
+/// @brief Sets all counters back to 0.
+void roy_stats_reset(void);
+
+/**
+ * @brief Prints every counter to 'stream', one "name value" per line, with the probes per lookup of each container.
+ * @note - Prints a single note instead when roylib is built without ROY_STATS.
+ */
+void roy_stats_dump(FILE * stream);
+
+#endif // RSTATS_H